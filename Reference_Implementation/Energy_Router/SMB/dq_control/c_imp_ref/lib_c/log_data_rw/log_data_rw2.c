@@ -1,4 +1,8 @@
 #include "log_data_rw2.h"
+#include <stdbool.h>
+
+// init_log_data buffers currently in the log arena
+static int log_data_live = 0;
 
 struct LogData* load_log_data(const char* filename) {
     FILE* file = fopen(filename, "r");
@@ -129,6 +133,14 @@ struct LogData* load_log_data(const char* filename) {
 
 void cleanup_data(struct LogData* data) {
     if (data == NULL) return;
+    // Arena buffers: the arena is emptied once the last of them is cleaned up
+    if (static_arena_owns(log_data_arena(), data)) {
+        if (--log_data_live <= 0) {
+            log_data_live = 0;
+            static_arena_reset(log_data_arena());
+        }
+        return;
+    }
 
     // Free all arrays
     free(data->id);
@@ -169,6 +181,7 @@ void cleanup_data(struct LogData* data) {
     free(data->v_cntl_valid);
     free(data->v_cntl_alpha);
     free(data->v_cntl_beta);
+    free(data->i_ref);
     free(data->i_ref_d);
     free(data->i_ref_q);
     free(data->i_ref_alpha);
@@ -183,76 +196,111 @@ void cleanup_data(struct LogData* data) {
     free(data);
 }
 
-struct LogData* init_log_data(int length) {
-    if (length <= 0) {
-        fprintf(stderr, "Error: Invalid length specified\n");
-        return NULL;
-    }
+// Block from the log arena, or zeroed heap memory when arena is NULL
+static void* log_alloc(StaticArena* arena, size_t bytes) {
+    return arena ? static_arena_alloc(arena, bytes) : calloc(1, bytes);
+}
 
-    struct LogData* data = (struct LogData*)malloc(sizeof(struct LogData));
-    if (!data) {
-        return NULL;
-    }
+// All buffers from one source; NULL (nothing kept on the heap) if any is missing
+static struct LogData* log_data_create(StaticArena* arena, int length) {
+    struct LogData* data = (struct LogData*)log_alloc(arena, sizeof(struct LogData));
+    if (!data) return NULL;
 
     // Initialize length
     data->length = length;
 
     // Allocate memory for all arrays
-    data->id = (uint64_t*)malloc(length * sizeof(uint64_t));
-    data->time_us = (uint64_t*)malloc(length * sizeof(uint64_t));
-    data->i_meas = (float*)malloc(length * sizeof(float));
-    data->i_alpha = (float*)malloc(length * sizeof(float));
-    data->i_beta = (float*)malloc(length * sizeof(float));
-    data->i_raw_d = (float*)malloc(length * sizeof(float));
-    data->i_raw_q = (float*)malloc(length * sizeof(float));
-    data->i_notch_d = (float*)malloc(length * sizeof(float));
-    data->i_notch_q = (float*)malloc(length * sizeof(float));
-    data->i_filtered_d = (float*)malloc(length * sizeof(float));
-    data->i_filtered_q = (float*)malloc(length * sizeof(float));
-    data->i_phase_est = (float*)malloc(length * sizeof(float));
-    data->v_grid_meas = (float*)malloc(length * sizeof(float));
-    data->v_grid_alpha = (float*)malloc(length * sizeof(float));
-    data->v_grid_beta = (float*)malloc(length * sizeof(float));
-    data->v_grid_d = (float*)malloc(length * sizeof(float));
-    data->v_grid_q = (float*)malloc(length * sizeof(float));
-    data->v_grid_phase = (float*)malloc(length * sizeof(float));
-    data->v_smb_meas = (float*)malloc(length * sizeof(float));
-    data->v_smb_alpha = (float*)malloc(length * sizeof(float));
-    data->v_smb_beta = (float*)malloc(length * sizeof(float));
-    data->v_smb_d = (float*)malloc(length * sizeof(float));
-    data->v_smb_q = (float*)malloc(length * sizeof(float));
-    data->v_smb_phase = (float*)malloc(length * sizeof(float));
-    data->v_cntl_d_ff = (float*)malloc(length * sizeof(float));
-    data->v_cntl_d_fd = (float*)malloc(length * sizeof(float));
-    data->v_cntl_q_ff = (float*)malloc(length * sizeof(float));
-    data->v_cntl_q_fd = (float*)malloc(length * sizeof(float));
-    data->v_cntl_d = (float*)malloc(length * sizeof(float));
-    data->v_cntl_q = (float*)malloc(length * sizeof(float));
-    data->v_cntl_peak = (float*)malloc(length * sizeof(float));
-    data->v_dc = (float*)malloc(length * sizeof(float));
-    data->v_cntl_mod_index = (float*)malloc(length * sizeof(float));
-    data->v_cntl_phase_shift = (float*)malloc(length * sizeof(float));
-    data->v_cntl_tgt_phase = (float*)malloc(length * sizeof(float));
-    data->v_cntl_valid = (float*)malloc(length * sizeof(float));
-    data->v_cntl_alpha = (float*)malloc(length * sizeof(float));
-    data->v_cntl_beta = (float*)malloc(length * sizeof(float));
-    data->i_ref_d = (float*)malloc(length * sizeof(float));
-    data->i_ref_q = (float*)malloc(length * sizeof(float));
-    data->i_ref_alpha = (float*)malloc(length * sizeof(float));
-    data->i_ref_beta = (float*)malloc(length * sizeof(float));
-    data->i_ref = (float*)malloc(length * sizeof(float));
-    data->v_ref = (float*)calloc(length, sizeof(float));
-    data->v_ref_d = (float*)calloc(length, sizeof(float));
-    data->v_ref_q = (float*)calloc(length, sizeof(float));
-    data->v_ref_alpha = (float*)calloc(length, sizeof(float));
-    data->v_ref_beta = (float*)calloc(length, sizeof(float));
+    bool ok = true;
+    #define LOG_NEW(field, type) \
+        ok &= (data->field = (type*)log_alloc(arena, (size_t)length * sizeof(type))) != NULL
 
-    // Don't forget to add null checks:
-    if (!data->v_ref || !data->v_ref_d || !data->v_ref_q || 
-        !data->v_ref_alpha || !data->v_ref_beta) {
-        cleanup_data(data);
+    LOG_NEW(id, uint64_t);
+    LOG_NEW(time_us, uint64_t);
+    LOG_NEW(i_meas, float);
+    LOG_NEW(i_alpha, float);
+    LOG_NEW(i_beta, float);
+    LOG_NEW(i_raw_d, float);
+    LOG_NEW(i_raw_q, float);
+    LOG_NEW(i_notch_d, float);
+    LOG_NEW(i_notch_q, float);
+    LOG_NEW(i_filtered_d, float);
+    LOG_NEW(i_filtered_q, float);
+    LOG_NEW(i_phase_est, float);
+    LOG_NEW(v_grid_meas, float);
+    LOG_NEW(v_grid_alpha, float);
+    LOG_NEW(v_grid_beta, float);
+    LOG_NEW(v_grid_d, float);
+    LOG_NEW(v_grid_q, float);
+    LOG_NEW(v_grid_phase, float);
+    LOG_NEW(v_smb_meas, float);
+    LOG_NEW(v_smb_alpha, float);
+    LOG_NEW(v_smb_beta, float);
+    LOG_NEW(v_smb_d, float);
+    LOG_NEW(v_smb_q, float);
+    LOG_NEW(v_smb_phase, float);
+    LOG_NEW(v_cntl_d_ff, float);
+    LOG_NEW(v_cntl_d_fd, float);
+    LOG_NEW(v_cntl_q_ff, float);
+    LOG_NEW(v_cntl_q_fd, float);
+    LOG_NEW(v_cntl_d, float);
+    LOG_NEW(v_cntl_q, float);
+    LOG_NEW(v_cntl_peak, float);
+    LOG_NEW(v_dc, float);
+    LOG_NEW(v_cntl_mod_index, float);
+    LOG_NEW(v_cntl_phase_shift, float);
+    LOG_NEW(v_cntl_tgt_phase, float);
+    LOG_NEW(v_cntl_valid, float);
+    LOG_NEW(v_cntl_alpha, float);
+    LOG_NEW(v_cntl_beta, float);
+    LOG_NEW(i_ref_d, float);
+    LOG_NEW(i_ref_q, float);
+    LOG_NEW(i_ref_alpha, float);
+    LOG_NEW(i_ref_beta, float);
+    LOG_NEW(i_ref, float);
+    LOG_NEW(v_ref, float);
+    LOG_NEW(v_ref_d, float);
+    LOG_NEW(v_ref_q, float);
+    LOG_NEW(v_ref_alpha, float);
+    LOG_NEW(v_ref_beta, float);
+    #undef LOG_NEW
+
+    if (!ok) {
+        if (!arena) cleanup_data(data);
+        return NULL;
+    }
+    return data;
+}
+
+struct LogData* init_log_data(int length) {
+    if (length <= 0) {
+        fprintf(stderr, "Error: Invalid length specified\n");
         return NULL;
     }
 
+    StaticArena* arena = log_data_arena();
+    size_t mark = static_arena_mark(arena);
+    struct LogData* data = log_data_create(arena, length);
+    if (data) {
+        log_data_live++;
+        return data;
+    }
+
+    // Longer than LOG_DATA_ARENA_SIZE allows: give the arena back, use the heap
+    static_arena_rewind(arena, mark);
+    data = log_data_create(NULL, length);
+    if (!data) {
+        fprintf(stderr, "Error: Could not allocate log data for %d samples\n", length);
+    }
     return data;
-}
\ No newline at end of file
+}
+
+StaticArena* log_data_arena(void) {
+    static uint8_t buffer[LOG_DATA_ARENA_SIZE] __attribute__((aligned(STATIC_ARENA_ALIGN)));
+    static StaticArena arena;
+    static int initialized = 0;
+    if (!initialized) {
+        static_arena_init(&arena, buffer, sizeof(buffer));
+        initialized = 1;
+    }
+    return &arena;
+}
@@ -5,6 +5,13 @@
 #include <stdlib.h>
 #include <math.h>
 #include <stdint.h>
+#include "../misc/static_arena/static_arena.h"
+
+// Arena for init_log_data buffers (about 200 bytes per sample), override with -D.
+// Longer logs fall back to the heap.
+#ifndef LOG_DATA_ARENA_SIZE
+#define LOG_DATA_ARENA_SIZE (1024u * 1024u)
+#endif
 
 // Define the structure
 struct LogData {
@@ -71,7 +78,11 @@ struct LogData {
 
 // Function prototypes
 struct LogData* load_log_data(const char* filename);
+// Buffers come from log_data_arena() when they fit, the heap otherwise.
+// cleanup_data releases either kind: the log arena has no other user and is
+// reset once every init_log_data result in it has been cleaned up.
 struct LogData* init_log_data(int length);
+StaticArena* log_data_arena(void);
 void cleanup_data(struct LogData* data);
 
 #endif /* LOG_DATA_RW_H */
@@ -4,14 +4,40 @@
 #include <math.h>
 #include "lowpass_filter_1storder.h"
 
+// The cutoff sweeps from fc_start to fc_end as the step response of a
+// first-order filter at fc_start: fc[n] = fc_end + (fc_start - fc_end) r^(n+1).
+// The prewarped t = tan(pi fc / fs) along that sweep is precomputed at
+// LPF_DYN_CURVE_KNOTS + 1 knots; between knots its distance to the final t
+// decays by a per-interval ratio, so a sample costs one multiply and one
+// divide instead of a tanf (b0 = b1 = t / (1 + t), a1 = 2 b0 - 1).
+// Once fc is within LPF_DYN_CONVERGED_TOL of fc_end the coefficients are
+// frozen at fc_end and processing is a plain lpf_process.
+#define LPF_DYN_CURVE_KNOTS 32
+#define LPF_DYN_CONVERGED_TOL 1e-4f    // relative to fc_end
+
 typedef struct {
     LowPassFilter1st signal_filter;    // Filter for the input signal
-    LowPassFilter1st coeff_filter;     // Filter for the cutoff frequency
     float fs;                          // Sampling freq
     float fc_start;                    // Starting cutoff frequency
     float fc_end;                      // Target cutoff frequency
+
+    // Sweep
+    bool converged;                    // coefficients frozen at fc_end
+    int sweep_index;                   // samples processed in the sweep
+    int sweep_length;                  // samples until converged
+    int knot_stride;                   // samples between curve knots
+    int knot, knot_pos;
+    float t_end;
+    float t_delta;                     // t - t_end
+    float delta_curve[LPF_DYN_CURVE_KNOTS + 1];
+    float ratio_curve[LPF_DYN_CURVE_KNOTS];
 } LowPassFilter1st_dyn_coeff;
 
+static inline void lpf_dyn_coeff_freeze(LowPassFilter1st_dyn_coeff* filter) {
+    lpf_create_coeff(&filter->signal_filter, filter->fc_end, filter->fs);
+    filter->converged = true;
+}
+
 static inline void lpf_dyn_coeff_init(LowPassFilter1st_dyn_coeff* filter,
                                    float fs,
                                    float fc_start,
@@ -20,22 +46,81 @@ static inline void lpf_dyn_coeff_init(LowPassFilter1st_dyn_coeff* filter,
     filter->fs = fs;
     filter->fc_start = fc_start;
     filter->fc_end = fc_end;
-    
+    filter->sweep_index = 0;
+    filter->sweep_length = 0;
+    filter->knot_stride = 1;
+    filter->knot = 0;
+    filter->knot_pos = 0;
+    filter->t_delta = 0.0f;
+    filter->converged = false;
+
     // Initialize the signal filter with starting frequency
     lpf_init(&filter->signal_filter, fs, fc_start);
-    
-    // Initialize the coefficient filter with a slower response
-    // Using a lower frequency for smooth coefficient transition
-    lpf_init(&filter->coeff_filter, fs, fc_start);  // Slower dynamics for coefficient changes
-    lpf_set_value(&filter->coeff_filter, fc_start, fc_start);
+
+    // The sweep length is relative to fc_end: no sweep without a positive one
+    if (!(fs > 0.0f) || !(fc_end > 0.0f)) {
+        printf("LPF Error - Sampling and target cutoff frequency must be positive\n");
+        #ifndef COMPILE_APP_Program
+        exit(1);
+        #endif
+        lpf_dyn_coeff_freeze(filter);
+        return;
+    }
+
+    // Cutoff dynamics: first-order filter at fc_start, ratio r per sample
+    LowPassFilter1st dynamics;
+    lpf_create_coeff(&dynamics, fc_start, fs);
+    const double r = -(double)dynamics.a1;
+    const double d0 = (double)fc_start - (double)fc_end;
+    const double tol = (double)LPF_DYN_CONVERGED_TOL * fabs((double)fc_end);
+    if (fabs(d0) <= tol || r <= 0.0) {
+        lpf_dyn_coeff_freeze(filter);
+        return;
+    }
+    filter->sweep_length = (int)ceil(log(tol / fabs(d0)) / log(r));
+    filter->knot_stride = (filter->sweep_length + LPF_DYN_CURVE_KNOTS - 1) / LPF_DYN_CURVE_KNOTS;
+    const double pi = 3.14159265358979;
+    filter->t_end = (float)tan(pi * fc_end / fs);
+    for (int j = 0; j <= LPF_DYN_CURVE_KNOTS; j++) {
+        int n = j * filter->knot_stride;
+        double fc = (double)fc_end + d0 * pow(r, n + 1);
+        filter->delta_curve[j] = (float)(tan(pi * fc / fs) - (double)filter->t_end);
+    }
+    for (int j = 0; j < LPF_DYN_CURVE_KNOTS; j++) {
+        double q = (double)filter->delta_curve[j + 1] / (double)filter->delta_curve[j];
+        filter->ratio_curve[j] = q > 0.0 ? (float)pow(q, 1.0 / filter->knot_stride) : 0.0f;
+    }
+}
+
+// Coefficients for the next sample: one step along the curve, or the freeze
+static inline void lpf_dyn_coeff_advance(LowPassFilter1st_dyn_coeff* filter) {
+    if (filter->sweep_index >= filter->sweep_length) {
+        lpf_dyn_coeff_freeze(filter);
+        return;
+    }
+    // Exact at each knot, geometric in between
+    if (filter->knot_pos == 0) {
+        filter->t_delta = filter->delta_curve[filter->knot];
+    } else {
+        filter->t_delta *= filter->ratio_curve[filter->knot];
+    }
+    if (++filter->knot_pos == filter->knot_stride) {
+        filter->knot_pos = 0;
+        filter->knot++;
+    }
+    float t = filter->t_end + filter->t_delta;
+    float b0 = t / (1.0f + t);
+    filter->signal_filter.b0 = b0;
+    filter->signal_filter.b1 = b0;
+    filter->signal_filter.a1 = 2.0f * b0 - 1.0f;
+    filter->sweep_index++;
 }
 
 static inline float lpf_dyn_coeff_process(LowPassFilter1st_dyn_coeff* filter, float input) {
-    // Update the cutoff frequency dynamically
-    float current_fc = lpf_process(&filter->coeff_filter, filter->fc_end);
-    lpf_create_coeff(&filter->signal_filter, current_fc, filter->fs);
+    // Update the cutoff frequency dynamically, until it has converged
+    if (!filter->converged) lpf_dyn_coeff_advance(filter);
     // Process the input signal with updated coefficient
     return lpf_process(&filter->signal_filter, input);
 }
 
-#endif // LOWPASS_FILTER_1STORDER_H
\ No newline at end of file
+#endif // LOWPASS_FILTER_1STORDER_DYN_COEFF_H
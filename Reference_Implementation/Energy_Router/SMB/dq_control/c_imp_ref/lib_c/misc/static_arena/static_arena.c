@@ -0,0 +1,72 @@
+#include "static_arena.h"
+#include <string.h>
+
+void static_arena_init(StaticArena* arena, void* buffer, size_t size) {
+    if (!arena) return;
+    // Align the start so every block is STATIC_ARENA_ALIGN aligned
+    uintptr_t start = (uintptr_t)buffer;
+    uintptr_t aligned = (start + STATIC_ARENA_ALIGN - 1) & ~(uintptr_t)(STATIC_ARENA_ALIGN - 1);
+    size_t skip = (size_t)(aligned - start);
+
+    arena->base = (uint8_t*)aligned;
+    arena->size = (buffer && size > skip) ? size - skip : 0;
+    arena->used = 0;
+    arena->high_water = 0;
+    arena->failed = 0;
+    arena->sealed = false;
+}
+
+void* static_arena_alloc(StaticArena* arena, size_t size) {
+    if (!arena) return NULL;
+    size_t rounded = (size + STATIC_ARENA_ALIGN - 1) & ~(size_t)(STATIC_ARENA_ALIGN - 1);
+    if (arena->sealed || rounded < size || rounded > arena->size - arena->used) {
+        arena->failed++;
+        return NULL;
+    }
+
+    void* block = arena->base + arena->used;
+    arena->used += rounded;
+    if (arena->used > arena->high_water) arena->high_water = arena->used;
+    memset(block, 0, rounded);
+    return block;
+}
+
+void static_arena_seal(StaticArena* arena) {
+    if (arena) arena->sealed = true;
+}
+
+void static_arena_reset(StaticArena* arena) {
+    if (!arena) return;
+    arena->used = 0;
+    arena->sealed = false;
+}
+
+size_t static_arena_remaining(const StaticArena* arena) {
+    return arena ? arena->size - arena->used : 0;
+}
+
+size_t static_arena_mark(const StaticArena* arena) {
+    return arena ? arena->used : 0;
+}
+
+void static_arena_rewind(StaticArena* arena, size_t mark) {
+    if (arena && mark <= arena->used) arena->used = mark;
+}
+
+bool static_arena_owns(const StaticArena* arena, const void* ptr) {
+    if (!arena || !ptr) return false;
+    uintptr_t p = (uintptr_t)ptr;
+    uintptr_t base = (uintptr_t)arena->base;
+    return p >= base && p < base + arena->size;
+}
+
+StaticArena* control_arena(void) {
+    static uint8_t buffer[CONTROL_ARENA_SIZE] __attribute__((aligned(STATIC_ARENA_ALIGN)));
+    static StaticArena arena;
+    static bool initialized = false;
+    if (!initialized) {
+        static_arena_init(&arena, buffer, sizeof(buffer));
+        initialized = true;
+    }
+    return &arena;
+}
@@ -0,0 +1,60 @@
+#ifndef STATIC_ARENA_H
+#define STATIC_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Bump allocator over a fixed buffer, for objects created at start-up
+ *
+ * Allocations are never freed one by one: the whole arena is released with
+ * static_arena_reset. After static_arena_seal every allocation fails, so a
+ * malloc-style call sneaking into the control loop shows up as an error
+ * instead of allocator jitter.
+ */
+typedef struct {
+    uint8_t* base;
+    size_t size;
+    size_t used;
+    size_t high_water;      // largest `used` seen, the RAM budget actually needed
+    uint32_t failed;        // allocations refused (full or sealed)
+    bool sealed;
+} StaticArena;
+
+#define STATIC_ARENA_ALIGN 16
+
+// Size of the default control-path arena, override with -DCONTROL_ARENA_SIZE=...
+#ifndef CONTROL_ARENA_SIZE
+#define CONTROL_ARENA_SIZE (128u * 1024u)
+#endif
+
+void static_arena_init(StaticArena* arena, void* buffer, size_t size);
+
+// Zeroed block aligned to STATIC_ARENA_ALIGN, NULL when full or sealed
+void* static_arena_alloc(StaticArena* arena, size_t size);
+
+// Typed helper: STATIC_ARENA_NEW(arena, float, n)
+#define STATIC_ARENA_NEW(arena, type, count) \
+    ((type*)static_arena_alloc((arena), (size_t)(count) * sizeof(type)))
+
+// End of start-up: refuse further allocations
+void static_arena_seal(StaticArena* arena);
+
+// Release everything (and unseal), e.g. before re-initializing the controller
+void static_arena_reset(StaticArena* arena);
+
+size_t static_arena_remaining(const StaticArena* arena);
+
+// Fill level now; static_arena_rewind drops every block allocated after it
+size_t static_arena_mark(const StaticArena* arena);
+void static_arena_rewind(StaticArena* arena, size_t mark);
+
+// ptr points into the arena's buffer (free() must not be called on it)
+bool static_arena_owns(const StaticArena* arena, const void* ptr);
+
+// Process-wide arena of CONTROL_ARENA_SIZE bytes in .bss, used by the
+// stair-wave, phase-shift and table loaders
+StaticArena* control_arena(void);
+
+#endif /* STATIC_ARENA_H */
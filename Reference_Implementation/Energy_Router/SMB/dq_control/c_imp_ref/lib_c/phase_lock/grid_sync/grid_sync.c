@@ -0,0 +1,28 @@
+#include "grid_sync.h"
+
+static int multiplier_init(void* state, const GridSyncConfig* config) {
+    static const MultiplierPllParams defaults = MULTIPLIER_PLL_DEFAULTS;
+    const MultiplierPllParams* p = config->params ? config->params : &defaults;
+    // The loop locks with v ~ A sin(vco phase)
+    return pll_init((PLL*)state, config->sampling_freq, config->nominal_freq, p->notch_ratios,
+                    p->notch_config, p->lpf_cutoff, p->kd, p->kp, p->ki,
+                    config->nominal_freq + p->freq_span, config->nominal_freq - p->freq_span,
+                    p->k0, config->initial_phase + 0.5f * (float)M_PI);
+}
+
+static void multiplier_update(void* state, float v) {
+    pll_update((PLL*)state, v);
+}
+
+static float multiplier_phase(const void* state) {
+    return vco_wrap_phase(((const PLL*)state)->output_vco_phase - 0.5f * (float)M_PI);
+}
+
+static float multiplier_frequency(const void* state) {
+    return ((const PLL*)state)->output_vco_applied_freq;
+}
+
+const GridSyncOps multiplier_pll_ops = {
+    "multiplier", sizeof(PLL),
+    multiplier_init, multiplier_update, multiplier_phase, multiplier_frequency
+};
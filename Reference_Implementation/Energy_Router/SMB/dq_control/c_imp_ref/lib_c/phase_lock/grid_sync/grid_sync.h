@@ -0,0 +1,71 @@
+#ifndef GRID_SYNC_H
+#define GRID_SYNC_H
+
+#include <stddef.h>
+#include "../pll.h"
+
+// Common interface over the grid synchronization loops (multiplier PLL,
+// SOGI-PLL, SRF-PLL, SOGI-FLL). All of them report the phase in the cosine
+// convention, v ~ A cos(phase), in [0, 2 pi), and the frequency in Hz.
+
+typedef struct {
+    float sampling_freq;
+    float nominal_freq;
+    float initial_phase;
+    const void* params;     // the implementation's parameter struct, NULL for its defaults
+} GridSyncConfig;
+
+typedef struct {
+    const char* name;
+    size_t state_size;
+    int (*init)(void* state, const GridSyncConfig* config);
+    void (*update)(void* state, float v);
+    float (*phase)(const void* state);
+    float (*frequency)(const void* state);
+} GridSyncOps;
+
+typedef struct {
+    const GridSyncOps* ops;
+    void* state;            // ops->state_size bytes, owned by the caller
+} GridSync;
+
+static inline int grid_sync_init(GridSync* sync, const GridSyncOps* ops, void* state,
+                                 const GridSyncConfig* config) {
+    if (!sync || !ops || !state || !config) return PLL_ERROR_NULL_POINTER;
+    sync->ops = ops;
+    sync->state = state;
+    return ops->init(state, config);
+}
+
+static inline void grid_sync_update(GridSync* sync, float v) {
+    sync->ops->update(sync->state, v);
+}
+
+static inline float grid_sync_phase(const GridSync* sync) {
+    return sync->ops->phase(sync->state);
+}
+
+static inline float grid_sync_frequency(const GridSync* sync) {
+    return sync->ops->frequency(sync->state);
+}
+
+// Shared by the implementations
+static inline float grid_sync_clamp(float x, float lo, float hi) {
+    return x < lo ? lo : (x > hi ? hi : x);
+}
+
+// The existing multiplier PLL (pll.c) behind the interface
+typedef struct {
+    float kd, kp, ki, k0;
+    float lpf_cutoff;
+    float freq_span;            // VCO range nominal +- freq_span (Hz)
+    int notch_config;
+    float notch_ratios[MAX_NOTCH_FILTERS];
+} MultiplierPllParams;
+
+#define MULTIPLIER_PLL_DEFAULTS { 1.0f / 3.0f, 2.0f, 10.0f, 1.0f, 5.0f, 5.0f, \
+                                  NOTCH_2ND | NOTCH_3RD, {0.9f, 0.9f, 0.9f, 0.9f, 0.9f} }
+
+extern const GridSyncOps multiplier_pll_ops;
+
+#endif // GRID_SYNC_H
@@ -12,6 +12,15 @@ static float calculate_harmonic_freq(float base_freq, int harmonic_order) {
     return base_freq * (float)harmonic_order;
 }
 
+static void pll_copy_lock_outputs(PLL* pll) {
+    const pll_lock_detector_t* ld = &pll->lock_detector;
+    pll->output_locked = ld->locked;
+    pll->output_lock_quality = ld->quality;
+    pll->output_amplitude = ld->amplitude;
+    pll->output_frequency = ld->frequency;
+    pll->output_rocof = ld->rocof;
+}
+
 int pll_init(PLL* pll, 
             float sampling_freq,
             float nominal_freq,
@@ -77,6 +86,9 @@ int pll_init(PLL* pll,
     pll->output_vco_correction_freq = 0.0f;
     pll->output_vco_applied_freq = nominal_freq;
     pll->output_vco_phase = pll->vco.phase;
+
+    lock_detector_init(&pll->lock_detector, sampling_freq, NULL);
+    pll_copy_lock_outputs(pll);
     // printf("VCO phase: %f\n", pll->output_vco_phase);
     // exit(0);
     
@@ -87,6 +99,14 @@ void pll_cleanup(PLL* pll) {
     (void)pll;  // Silence unused parameter warning
 }
 
+int pll_set_lock_detector(PLL* pll, const ld_config_t* config) {
+    if (!pll) return PLL_ERROR_NULL_POINTER;
+    if (lock_detector_init(&pll->lock_detector, pll->sampling_freq, config) != LD_ERROR_NONE)
+        return PLL_ERROR_INVALID_PARAMETER;
+    pll_copy_lock_outputs(pll);
+    return PLL_SUCCESS;
+}
+
 int pll_update(PLL* pll, float grid_voltage) {
     if (pll == NULL) return PLL_ERROR_NULL_POINTER;
 
@@ -105,7 +125,10 @@ int pll_update(PLL* pll, float grid_voltage) {
     pll->output_vco_applied_freq = pll->vco.frequency;
     pll->output_vco_phase = pll->vco.phase;
 
-    float vco_cos = cosf(vco_controller_get_phase(&pll->vco));
+    float vco_sin, vco_cos;
+    vco_controller_get_sincos(&pll->vco, &vco_sin, &vco_cos);
+    lock_detector_update(&pll->lock_detector, grid_voltage, vco_sin, vco_cos, pll->vco.frequency);
+    pll_copy_lock_outputs(pll);
     pd_update(&pll->phase_detector, 
               grid_voltage, 
               vco_cos, 
@@ -135,12 +158,175 @@ int pll_update(PLL* pll, float grid_voltage) {
 
 void pll_apply_notch_filter(PLL* pll, float error_signal) {
     // Input validation
-    if (!pll || pll->num_active_notches == 0) return;
+    if (!pll) return;
 
-      pll->output_notch_filter = error_signal;
+    // Without active notches the error passes through unchanged
+    pll->output_notch_filter = error_signal;
     // Apply each active notch filter in sequence
     for (int i = 0; i < pll->num_active_notches; i++) {
          pll->output_notch_filter = notch_filter_apply(&pll->error_notch[i],  pll->output_notch_filter);
     }
 }
 
+int pll_process_block(PLL* pll, const float* grid_voltage, size_t n, const PLLBlockOutputs* outputs) {
+    if (pll == NULL || (n > 0 && grid_voltage == NULL)) return PLL_ERROR_NULL_POINTER;
+
+    PLLBlockOutputs none = { NULL, NULL, NULL, NULL, false };
+    if (!outputs) outputs = &none;
+
+    size_t i = 0;
+
+    // The first sample after init seeds the filters; take the scalar path
+    bool seeded = pll->error_lpf.signal_filter.flag_init;
+    for (int k = 0; k < pll->num_active_notches; k++) {
+        seeded = seeded && pll->error_notch[k].flag_init;
+    }
+    while (i < n && !seeded) {
+        pll_update(pll, grid_voltage[i]);
+        if (outputs->phase) outputs->phase[i] = pll->output_vco_phase;
+        if (outputs->frequency) outputs->frequency[i] = pll->output_vco_applied_freq;
+        if (outputs->phase_error) outputs->phase_error[i] = pll->output_phase_detector;
+        if (outputs->control) outputs->control[i] = pll->output_pi;
+        i++;
+        seeded = true;
+    }
+    if (i == n) return PLL_SUCCESS;
+
+    // Stage state in locals for the fused loop, written back at the end
+    vco_controller_t* vco = &pll->vco;
+    LowPassFilter1st_dyn_coeff* error_lpf = &pll->error_lpf;
+    LowPassFilter1st* signal_lpf = &pll->error_lpf.signal_filter;
+    pi_controller_t* pi = &pll->pi_controller;
+
+    const int num_notches = pll->num_active_notches;
+    float nb0[MAX_NOTCH_FILTERS], nb1[MAX_NOTCH_FILTERS], nb2[MAX_NOTCH_FILTERS];
+    float na1[MAX_NOTCH_FILTERS], na2[MAX_NOTCH_FILTERS];
+    float nx1[MAX_NOTCH_FILTERS], nx2[MAX_NOTCH_FILTERS], ny1[MAX_NOTCH_FILTERS], ny2[MAX_NOTCH_FILTERS];
+    for (int k = 0; k < num_notches; k++) {
+        const NotchFilter* f = &pll->error_notch[k];
+        nb0[k] = f->b_coeffs[0]; nb1[k] = f->b_coeffs[1]; nb2[k] = f->b_coeffs[2];
+        na1[k] = f->a_coeffs[1]; na2[k] = f->a_coeffs[2];
+        nx1[k] = f->x1; nx2[k] = f->x2; ny1[k] = f->y1; ny2[k] = f->y2;
+    }
+
+    const bool track_lock = outputs->lock_detector;
+    const float kd = pll->phase_detector.kd;
+    const float k0 = vco->k0;
+    const float f0 = vco->nominal_freq;
+    const float ts = vco->ts;
+    const float kp = pi->kp;
+    const float ki = pi->ki;
+
+    uint32_t phase_acc = vco->phase_acc;
+    float phase = vco->phase;
+    float frequency = vco->frequency;
+    float freq_correction = vco->freq_correction;
+    float pd_out = pll->output_phase_detector;
+    float notch_out = pll->output_notch_filter;
+    float lpf_out = pll->output_lpf;
+    float control = pll->output_pi;
+    float integrator = pi->integrator;
+    float proportional = pi->proportional;
+
+    float sb0 = signal_lpf->b0, sb1 = signal_lpf->b1, sa1 = signal_lpf->a1;
+    float s_in = signal_lpf->prev_input, s_out = signal_lpf->prev_output;
+
+    // Rotor at the current VCO phase, advanced by the nominal step and the
+    // PI correction; per-sample rounding is cleared at every resync
+    float rot_c, rot_s;
+    vco_nco_sincos(phase_acc, &rot_s, &rot_c);
+    const float step_c = cosf(2.0f * (float)M_PI * f0 * ts);
+    const float step_s = sinf(2.0f * (float)M_PI * f0 * ts);
+    const float eps_gain = 2.0f * (float)M_PI * k0 * ts;
+    int since_resync = 0;
+
+    for (; i < n; i++) {
+        // VCO, same arithmetic as vco_controller_update
+        freq_correction = k0 * control;
+        frequency = f0 + freq_correction;
+        phase_acc += vco_freq_to_step(frequency, ts);
+        phase = vco_acc_to_phase(phase_acc);
+
+        // Rotor: the nominal step does not depend on the loop, only the
+        // small correction eps (|eps| < 0.05 rad) sits on the feedback path
+        float pre_c = rot_c * step_c - rot_s * step_s;
+        float pre_s = rot_s * step_c + rot_c * step_s;
+        if (++since_resync >= PLL_BLOCK_RESYNC) {
+            vco_nco_sincos(phase_acc, &rot_s, &rot_c);
+            since_resync = 0;
+        } else {
+            float eps = eps_gain * control;
+            float e2 = eps * eps;
+            float ec = 1.0f - 0.5f * e2 * (1.0f - e2 * (1.0f / 12.0f));
+            float es = eps * (1.0f - e2 * (1.0f / 6.0f));
+            rot_c = pre_c * ec - pre_s * es;
+            rot_s = pre_s * ec + pre_c * es;
+        }
+
+        // Phase detector
+        pd_out = kd * grid_voltage[i] * rot_c;
+        if (track_lock) {
+            lock_detector_update(&pll->lock_detector, grid_voltage[i], rot_s, rot_c, frequency);
+        }
+
+        // Notch chain (pass-through when none are active)
+        float x = pd_out;
+        for (int k = 0; k < num_notches; k++) {
+            float y = nb0[k] * x + nb1[k] * nx1[k] + nb2[k] * nx2[k] - na1[k] * ny1[k] - na2[k] * ny2[k];
+            nx2[k] = nx1[k]; nx1[k] = x;
+            ny2[k] = ny1[k]; ny1[k] = y;
+            x = y;
+        }
+        notch_out = x;
+
+        // Cutoff sweep until converged, then fixed coefficients
+        if (!error_lpf->converged) {
+            lpf_dyn_coeff_advance(error_lpf);
+            sb0 = signal_lpf->b0; sb1 = signal_lpf->b1; sa1 = signal_lpf->a1;
+        }
+        lpf_out = sb0 * notch_out + sb1 * s_in - sa1 * s_out;
+        s_in = notch_out;
+        s_out = lpf_out;
+
+        // PI
+        proportional = kp * lpf_out;
+        integrator += ki * lpf_out * ts;
+        control = proportional + integrator;
+
+        if (outputs->phase) outputs->phase[i] = phase;
+        if (outputs->frequency) outputs->frequency[i] = frequency;
+        if (outputs->phase_error) outputs->phase_error[i] = pd_out;
+        if (outputs->control) outputs->control[i] = control;
+    }
+
+    // Write back
+    vco->phase_acc = phase_acc;
+    vco->phase = phase;
+    vco->frequency = frequency;
+    vco->freq_correction = freq_correction;
+    pll->phase_detector.phase_error = pd_out;
+    pll->phase_detector.error_code = PD_ERROR_NONE;
+    for (int k = 0; k < num_notches; k++) {
+        NotchFilter* f = &pll->error_notch[k];
+        f->x1 = nx1[k]; f->x2 = nx2[k]; f->y1 = ny1[k]; f->y2 = ny2[k];
+    }
+    signal_lpf->b0 = sb0; signal_lpf->b1 = sb1; signal_lpf->a1 = sa1;
+    signal_lpf->prev_input = s_in;
+    signal_lpf->prev_output = s_out;
+    pi->proportional = proportional;
+    pi->integrator = integrator;
+    pi->control_signal = control;
+
+    pll->output_phase_detector = pd_out;
+    pll->output_notch_filter = notch_out;
+    pll->output_lpf = lpf_out;
+    pll->output_pi = control;
+    pll->output_vco_correction_freq = freq_correction;
+    pll->output_vco_applied_freq = frequency;
+    pll->output_vco_phase = phase;
+    if (track_lock) {
+        pll_copy_lock_outputs(pll);
+    }
+
+    return PLL_SUCCESS;
+}
@@ -5,9 +5,11 @@
 #include "pll_phase_detector/pll_phase_detector.h"  // Should define phase_detector_t
 #include "pll_controller_pi/pll_controller_pi.h"    // Should define pi_controller_t
 #include "pll_voltage_oscillator/vco_controller.h"  // Should define vco_controller_t
+#include "pll_lock_detector/pll_lock_detector.h"
 #include "../notch_filter/notch_filter.h"          // Should define notch_filter_t
 #include "../lowpass_filter_1storder/lowpass_filter_1storder.h"  // Should define lowpass_filter_1storder_t
 #include "../lowpass_filter_1storder/lowpass_filter_1storder_dyn_coeff.h"
+#include <stddef.h>
 
 // Error codes
 #define PLL_SUCCESS 0
@@ -30,6 +32,23 @@
 #define NOTCH_5TH      (1 << 3)
 #define NOTCH_6TH      (1 << 4)
 
+// Block mode (and pll_bank): the VCO cosine comes from a rotor advanced by the
+// VCO step each sample, re-seeded from the NCO accumulator (vco_nco_sincos)
+// every PLL_BLOCK_RESYNC samples
+#ifndef PLL_BLOCK_RESYNC
+#define PLL_BLOCK_RESYNC 64
+#endif
+
+// Per-sample outputs of pll_process_block, any pointer may be NULL
+typedef struct {
+    float* phase;           // VCO phase (output_vco_phase)
+    float* frequency;       // VCO applied frequency (output_vco_applied_freq)
+    float* phase_error;     // phase detector output (output_phase_detector)
+    float* control;         // PI output (output_pi)
+    bool lock_detector;     // run the lock detector; when false output_locked
+                            // .. output_rocof keep their values from before the block
+} PLLBlockOutputs;
+
 typedef struct {
     float sampling_freq;
     float base_freq;
@@ -42,6 +61,7 @@ typedef struct {
 
     pi_controller_t pi_controller;
     vco_controller_t vco;
+    pll_lock_detector_t lock_detector;
     
     int active_notches;
     int num_active_notches;
@@ -52,6 +72,12 @@ typedef struct {
     float output_vco_correction_freq;
     float output_vco_applied_freq;
     float output_vco_phase;
+    // Lock detector (LD_CONFIG_DEFAULTS unless pll_set_lock_detector is called)
+    bool output_locked;
+    float output_lock_quality;
+    float output_amplitude;
+    float output_frequency;         // smoothed
+    float output_rocof;             // Hz/s
     // float filtered_error;
     // float current_control_signal;
 } PLL;
@@ -72,7 +98,14 @@ int pll_init(PLL* pll,
             float initial_phase);
 
 void pll_cleanup(PLL* pll);         // New cleanup function
+
+// Replace the lock detector thresholds/cutoffs (restarts the detector)
+int pll_set_lock_detector(PLL* pll, const ld_config_t* config);
 int pll_update(PLL* pll, float grid_voltage);
+
+// n samples of pll_update in one call, stages fused in one loop; the
+// output_* fields hold the last sample afterwards
+int pll_process_block(PLL* pll, const float* grid_voltage, size_t n, const PLLBlockOutputs* outputs);
 void pll_apply_notch_filter(PLL* pll, float grid_voltage);
 
 #endif // PLL_H
@@ -0,0 +1,255 @@
+#include "pll_bank.h"
+#include <math.h>
+#include <string.h>
+
+static inline PLLBankGroup* channel_group(PLLBank* bank, int channel, int* lane) {
+    *lane = channel % PLL_BANK_LANES;
+    return &bank->groups[channel / PLL_BANK_LANES];
+}
+
+void pll_bank_init(PLLBank* bank) {
+    if (!bank) return;
+    memset(bank, 0, sizeof(*bank));
+}
+
+int pll_bank_load(PLLBank* bank, int channel, const PLL* pll) {
+    if (!bank || !pll) return PLL_ERROR_NULL_POINTER;
+    if (channel < 0 || channel >= PLL_BANK_MAX_CHANNELS || channel > bank->num_channels ||
+        pll->num_active_notches > MAX_NOTCH_FILTERS) {
+        return PLL_ERROR_INVALID_PARAMETER;
+    }
+
+    int l;
+    PLLBankGroup* g = channel_group(bank, channel, &l);
+
+    g->kd.lane[l] = pll->phase_detector.kd;
+    g->k0.lane[l] = pll->vco.k0;
+    g->f0.lane[l] = pll->vco.nominal_freq;
+    g->ts.lane[l] = pll->vco.ts;
+    g->w.lane[l] = 2.0f * (float)M_PI * pll->vco.ts;
+    g->kp.lane[l] = pll->pi_controller.kp;
+    g->ki.lane[l] = pll->pi_controller.ki;
+    g->step_c.lane[l] = cosf(g->w.lane[l] * pll->vco.nominal_freq);
+    g->step_s.lane[l] = sinf(g->w.lane[l] * pll->vco.nominal_freq);
+    g->eps_gain.lane[l] = g->w.lane[l] * pll->vco.k0;
+
+    // Unused stages of a shorter chain pass the signal through
+    for (int k = 0; k < MAX_NOTCH_FILTERS; k++) {
+        const NotchFilter* f = &pll->error_notch[k];
+        bool active = k < pll->num_active_notches;
+        g->nb0[k].lane[l] = active ? f->b_coeffs[0] : 1.0f;
+        g->nb1[k].lane[l] = active ? f->b_coeffs[1] : 0.0f;
+        g->nb2[k].lane[l] = active ? f->b_coeffs[2] : 0.0f;
+        g->na1[k].lane[l] = active ? f->a_coeffs[1] : 0.0f;
+        g->na2[k].lane[l] = active ? f->a_coeffs[2] : 0.0f;
+        g->nx1[k].lane[l] = active ? f->x1 : 0.0f;
+        g->nx2[k].lane[l] = active ? f->x2 : 0.0f;
+        g->ny1[k].lane[l] = active ? f->y1 : 0.0f;
+        g->ny2[k].lane[l] = active ? f->y2 : 0.0f;
+    }
+
+    const LowPassFilter1st* signal = &pll->error_lpf.signal_filter;
+    bank->channel_lpf[channel] = pll->error_lpf;
+    g->sb0.lane[l] = signal->b0;
+    g->sb1.lane[l] = signal->b1;
+    g->sa1.lane[l] = signal->a1;
+    g->s_in.lane[l] = signal->prev_input;
+    g->s_out.lane[l] = signal->prev_output;
+
+    g->phase_acc[l] = pll->vco.phase_acc;
+    g->phase.lane[l] = vco_acc_to_phase(pll->vco.phase_acc);
+    g->frequency.lane[l] = pll->vco.frequency;
+    g->freq_correction.lane[l] = pll->vco.freq_correction;
+    vco_nco_sincos(pll->vco.phase_acc, &g->rot_s.lane[l], &g->rot_c.lane[l]);
+    g->pd_out.lane[l] = pll->output_phase_detector;
+    g->notch_out.lane[l] = pll->output_notch_filter;
+    g->lpf_out.lane[l] = pll->output_lpf;
+    g->proportional.lane[l] = pll->pi_controller.proportional;
+    g->integrator.lane[l] = pll->pi_controller.integrator;
+    g->control.lane[l] = pll->output_pi;
+
+    bool seeded = signal->flag_init;
+    for (int k = 0; k < pll->num_active_notches; k++) {
+        seeded = seeded && pll->error_notch[k].flag_init;
+    }
+    bank->pending_seed[channel] = !seeded;
+    bank->channel_notches[channel] = pll->num_active_notches;
+
+    if (channel == bank->num_channels) {
+        bank->num_channels++;
+        bank->num_groups = (bank->num_channels + PLL_BANK_LANES - 1) / PLL_BANK_LANES;
+    }
+    bank->num_notches = 0;
+    for (int c = 0; c < bank->num_channels; c++) {
+        if (bank->channel_notches[c] > bank->num_notches) bank->num_notches = bank->channel_notches[c];
+    }
+    return PLL_SUCCESS;
+}
+
+int pll_bank_store(const PLLBank* bank, int channel, PLL* pll) {
+    if (!bank || !pll) return PLL_ERROR_NULL_POINTER;
+    if (channel < 0 || channel >= bank->num_channels) return PLL_ERROR_INVALID_PARAMETER;
+
+    int l = channel % PLL_BANK_LANES;
+    const PLLBankGroup* g = &bank->groups[channel / PLL_BANK_LANES];
+    bool seeded = !bank->pending_seed[channel];
+
+    pll->phase_detector.kd = g->kd.lane[l];
+    pll->phase_detector.phase_error = g->pd_out.lane[l];
+    pll->vco.k0 = g->k0.lane[l];
+    pll->vco.nominal_freq = g->f0.lane[l];
+    pll->vco.ts = g->ts.lane[l];
+    pll->vco.phase_acc = g->phase_acc[l];
+    pll->vco.phase = g->phase.lane[l];
+    pll->vco.frequency = g->frequency.lane[l];
+    pll->vco.freq_correction = g->freq_correction.lane[l];
+    pll->pi_controller.kp = g->kp.lane[l];
+    pll->pi_controller.ki = g->ki.lane[l];
+    pll->pi_controller.ts = g->ts.lane[l];
+    pll->pi_controller.proportional = g->proportional.lane[l];
+    pll->pi_controller.integrator = g->integrator.lane[l];
+    pll->pi_controller.control_signal = g->control.lane[l];
+
+    pll->num_active_notches = bank->channel_notches[channel];
+    for (int k = 0; k < pll->num_active_notches; k++) {
+        NotchFilter* f = &pll->error_notch[k];
+        f->b_coeffs[0] = g->nb0[k].lane[l];
+        f->b_coeffs[1] = g->nb1[k].lane[l];
+        f->b_coeffs[2] = g->nb2[k].lane[l];
+        f->a_coeffs[0] = 1.0f;
+        f->a_coeffs[1] = g->na1[k].lane[l];
+        f->a_coeffs[2] = g->na2[k].lane[l];
+        f->x1 = g->nx1[k].lane[l];
+        f->x2 = g->nx2[k].lane[l];
+        f->y1 = g->ny1[k].lane[l];
+        f->y2 = g->ny2[k].lane[l];
+        f->flag_init = seeded;
+    }
+
+    LowPassFilter1st* signal = &pll->error_lpf.signal_filter;
+    pll->error_lpf = bank->channel_lpf[channel];
+    signal->b0 = g->sb0.lane[l];
+    signal->b1 = g->sb1.lane[l];
+    signal->a1 = g->sa1.lane[l];
+    signal->prev_input = g->s_in.lane[l];
+    signal->prev_output = g->s_out.lane[l];
+    signal->flag_init = seeded;
+
+    pll->output_phase_detector = g->pd_out.lane[l];
+    pll->output_notch_filter = g->notch_out.lane[l];
+    pll->output_lpf = g->lpf_out.lane[l];
+    pll->output_pi = g->control.lane[l];
+    pll->output_vco_correction_freq = g->freq_correction.lane[l];
+    pll->output_vco_applied_freq = g->frequency.lane[l];
+    pll->output_vco_phase = g->phase.lane[l];
+    return PLL_SUCCESS;
+}
+
+// Group with a channel on its first sample or in a cutoff sweep: every
+// channel through pll_update
+static void step_group_scalar(PLLBank* bank, int group, const float* voltage) {
+    PLL pll;
+    memset(&pll, 0, sizeof(pll));
+    for (int l = 0; l < PLL_BANK_LANES; l++) {
+        int channel = group * PLL_BANK_LANES + l;
+        if (channel >= bank->num_channels) break;
+        pll_bank_store(bank, channel, &pll);
+        pll_update(&pll, voltage[channel]);
+        pll_bank_load(bank, channel, &pll);
+    }
+}
+
+static void step_group(PLLBank* bank, PLLBankGroup* g, int group, const float* voltage, bool resync) {
+    const int first = group * PLL_BANK_LANES;
+    const int count = bank->num_channels - first < PLL_BANK_LANES ? bank->num_channels - first : PLL_BANK_LANES;
+
+    PLLBankLanes v = {0};
+    for (int l = 0; l < count; l++) v.lane[l] = voltage[first + l];
+
+    // VCO: one NCO accumulator per lane, same arithmetic as pll_process_block
+    pll_vec_t control = g->control.vec;
+    g->freq_correction.vec = g->k0.vec * control;
+    g->frequency.vec = g->f0.vec + g->freq_correction.vec;
+    for (int l = 0; l < PLL_BANK_LANES; l++) {
+        g->phase_acc[l] += vco_freq_to_step(g->frequency.lane[l], g->ts.lane[l]);
+        g->phase.lane[l] = vco_acc_to_phase(g->phase_acc[l]);
+    }
+
+    // Rotor: nominal step, then the small PI correction
+    if (resync) {
+        for (int l = 0; l < PLL_BANK_LANES; l++) {
+            vco_nco_sincos(g->phase_acc[l], &g->rot_s.lane[l], &g->rot_c.lane[l]);
+        }
+    } else {
+        pll_vec_t pre_c = g->rot_c.vec * g->step_c.vec - g->rot_s.vec * g->step_s.vec;
+        pll_vec_t pre_s = g->rot_s.vec * g->step_c.vec + g->rot_c.vec * g->step_s.vec;
+        pll_vec_t eps = g->eps_gain.vec * control;
+        pll_vec_t e2 = eps * eps;
+        pll_vec_t ec = 1.0f - 0.5f * e2 * (1.0f - e2 * (1.0f / 12.0f));
+        pll_vec_t es = eps * (1.0f - e2 * (1.0f / 6.0f));
+        g->rot_c.vec = pre_c * ec - pre_s * es;
+        g->rot_s.vec = pre_s * ec + pre_c * es;
+    }
+
+    // Phase detector and notch chain
+    pll_vec_t x = g->kd.vec * v.vec * g->rot_c.vec;
+    g->pd_out.vec = x;
+    for (int k = 0; k < bank->num_notches; k++) {
+        pll_vec_t y = g->nb0[k].vec * x + g->nb1[k].vec * g->nx1[k].vec + g->nb2[k].vec * g->nx2[k].vec
+                    - g->na1[k].vec * g->ny1[k].vec - g->na2[k].vec * g->ny2[k].vec;
+        g->nx2[k].vec = g->nx1[k].vec;
+        g->nx1[k].vec = x;
+        g->ny2[k].vec = g->ny1[k].vec;
+        g->ny1[k].vec = y;
+        x = y;
+    }
+    g->notch_out.vec = x;
+
+    // Error LPF, every lane converged (fixed coefficients)
+    pll_vec_t lpf = g->sb0.vec * g->notch_out.vec + g->sb1.vec * g->s_in.vec - g->sa1.vec * g->s_out.vec;
+    g->s_in.vec = g->notch_out.vec;
+    g->s_out.vec = lpf;
+    g->lpf_out.vec = lpf;
+
+    // PI
+    g->proportional.vec = g->kp.vec * lpf;
+    g->integrator.vec += g->ki.vec * lpf * g->ts.vec;
+    g->control.vec = g->proportional.vec + g->integrator.vec;
+}
+
+int pll_bank_step(PLLBank* bank, const float* voltage) {
+    if (!bank || !voltage) return PLL_ERROR_NULL_POINTER;
+
+    bool resync = ++bank->since_resync >= PLL_BLOCK_RESYNC;
+    if (resync) bank->since_resync = 0;
+
+    for (int group = 0; group < bank->num_groups; group++) {
+        bool pending = false;
+        for (int l = 0; l < PLL_BANK_LANES; l++) {
+            int channel = group * PLL_BANK_LANES + l;
+            if (channel < bank->num_channels &&
+                (bank->pending_seed[channel] || !bank->channel_lpf[channel].converged)) pending = true;
+        }
+        if (pending) {
+            step_group_scalar(bank, group, voltage);
+        } else {
+            step_group(bank, &bank->groups[group], group, voltage, resync);
+        }
+    }
+    return PLL_SUCCESS;
+}
+
+int pll_bank_process_block(PLLBank* bank, const float* voltage, size_t n, float* phase) {
+    if (!bank || (n > 0 && !voltage)) return PLL_ERROR_NULL_POINTER;
+
+    const size_t stride = (size_t)bank->num_channels;
+    for (size_t i = 0; i < n; i++) {
+        pll_bank_step(bank, voltage + i * stride);
+        if (phase) {
+            for (int c = 0; c < bank->num_channels; c++) {
+                phase[i * stride + (size_t)c] = pll_bank_phase(bank, c);
+            }
+        }
+    }
+    return PLL_SUCCESS;
+}
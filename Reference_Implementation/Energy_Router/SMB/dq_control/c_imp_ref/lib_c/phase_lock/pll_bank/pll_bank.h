@@ -0,0 +1,101 @@
+#ifndef PLL_BANK_H
+#define PLL_BANK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../pll.h"
+
+// Many PLL channels advanced together. Every state and parameter is stored
+// per lane (structure of arrays, in groups of PLL_BANK_LANES channels) so
+// one vector instruction advances a whole group. The per-sample pipeline
+// is the one of pll_process_block.
+
+// Channels per lane group. Like PLL_BANK_MAX_CHANNELS this is a build
+// configuration that fixes the PLLBank layout, so it does not follow
+// per-file flags such as -mavx: 8 lanes are one AVX register, or two SSE
+// registers without AVX.
+#ifndef PLL_BANK_LANES
+#define PLL_BANK_LANES 8
+#endif
+
+// Vector type for one lane group; falls back to one channel per group with
+// PLL_BANK_SCALAR or without GCC/Clang
+#if defined(__GNUC__) && !defined(PLL_BANK_SCALAR)
+#define PLL_BANK_VECTOR 1
+// Aligned to the full group: the default vector alignment also follows -mavx
+typedef float pll_vec_t __attribute__((vector_size(PLL_BANK_LANES * sizeof(float)),
+                                       aligned(PLL_BANK_LANES * sizeof(float))));
+#else
+#undef PLL_BANK_LANES
+#define PLL_BANK_LANES 1
+typedef float pll_vec_t;
+#endif
+
+#ifndef PLL_BANK_MAX_CHANNELS
+#define PLL_BANK_MAX_CHANNELS 64
+#endif
+#define PLL_BANK_MAX_GROUPS ((PLL_BANK_MAX_CHANNELS + PLL_BANK_LANES - 1) / PLL_BANK_LANES)
+
+typedef union {
+    pll_vec_t vec;
+    float lane[PLL_BANK_LANES];
+} PLLBankLanes;
+
+typedef struct {
+    // Parameters
+    PLLBankLanes kd, k0, f0, ts, w;             // w = 2 pi ts
+    PLLBankLanes kp, ki;
+    PLLBankLanes step_c, step_s, eps_gain;      // nominal VCO step, rad per unit PI output
+    PLLBankLanes nb0[MAX_NOTCH_FILTERS], nb1[MAX_NOTCH_FILTERS], nb2[MAX_NOTCH_FILTERS];
+    PLLBankLanes na1[MAX_NOTCH_FILTERS], na2[MAX_NOTCH_FILTERS];
+    PLLBankLanes sb0, sb1, sa1;                 // error LPF at its converged cutoff
+
+    // States
+    PLLBankLanes phase, frequency, freq_correction, rot_c, rot_s;
+    PLLBankLanes nx1[MAX_NOTCH_FILTERS], nx2[MAX_NOTCH_FILTERS];
+    PLLBankLanes ny1[MAX_NOTCH_FILTERS], ny2[MAX_NOTCH_FILTERS];
+    PLLBankLanes s_in, s_out;
+    PLLBankLanes pd_out, notch_out, lpf_out, proportional, integrator, control;
+    uint32_t phase_acc[PLL_BANK_LANES];         // VCO NCO accumulator; phase is read from it
+} PLLBankGroup;
+
+// Holds vector members: declare statically or allocate with vector alignment
+typedef struct {
+    int num_channels;
+    int num_groups;
+    int num_notches;                            // longest chain; shorter ones pass through
+    int since_resync;
+    int channel_notches[PLL_BANK_MAX_CHANNELS]; // num_active_notches of each channel
+    uint8_t pending_seed[PLL_BANK_MAX_CHANNELS];// first sample still to go through pll_update
+    LowPassFilter1st_dyn_coeff channel_lpf[PLL_BANK_MAX_CHANNELS]; // sweep state; a sweeping channel takes pll_update
+    PLLBankGroup groups[PLL_BANK_MAX_GROUPS];
+} PLLBank;
+
+void pll_bank_init(PLLBank* bank);
+
+// Copy a pll_init'ed (or running) PLL into a channel; channels are numbered
+// from 0 without gaps. A channel that has not seen a sample yet takes its
+// first one through pll_update.
+int pll_bank_load(PLLBank* bank, int channel, const PLL* pll);
+
+// Copy a channel back into a PLL that was loaded into it (the notch design
+// parameters are left as they are). The bank does not run the lock
+// detector; the PLL's lock outputs keep their values from before the load.
+int pll_bank_store(const PLLBank* bank, int channel, PLL* pll);
+
+// One sample per channel: voltage[num_channels]
+int pll_bank_step(PLLBank* bank, const float* voltage);
+
+// n samples, channel-interleaved: voltage[n][num_channels]; phase (optional)
+// receives the VCO phase in the same layout
+int pll_bank_process_block(PLLBank* bank, const float* voltage, size_t n, float* phase);
+
+static inline float pll_bank_phase(const PLLBank* bank, int channel) {
+    return bank->groups[channel / PLL_BANK_LANES].phase.lane[channel % PLL_BANK_LANES];
+}
+
+static inline float pll_bank_frequency(const PLLBank* bank, int channel) {
+    return bank->groups[channel / PLL_BANK_LANES].frequency.lane[channel % PLL_BANK_LANES];
+}
+
+#endif // PLL_BANK_H
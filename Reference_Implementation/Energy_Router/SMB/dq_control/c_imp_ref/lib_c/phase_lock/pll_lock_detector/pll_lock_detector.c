@@ -0,0 +1,46 @@
+#include "pll_lock_detector.h"
+
+ld_error_t lock_detector_init(pll_lock_detector_t* ld, float fs, const ld_config_t* config) {
+    static const ld_config_t defaults = LD_CONFIG_DEFAULTS;
+    if (!ld) return LD_ERROR_NULL_POINTER;
+    if (!config) config = &defaults;
+    if (fs <= 0.0f || config->lock_off > config->lock_on || config->hold_time < 0.0f)
+        return LD_ERROR_INVALID_PARAMETER;
+
+    ld->config = *config;
+    ld->fs = fs;
+    ld->hold_samples = (int)(config->hold_time * fs + 0.5f);
+
+    for (int k = 0; k < 2; k++) {
+        lpf_init(&ld->i_lpf[k], fs, config->iq_cutoff);
+        lpf_init(&ld->q_lpf[k], fs, config->iq_cutoff);
+    }
+    lpf_init(&ld->freq_lpf, fs, config->freq_cutoff);
+    lpf_init(&ld->rocof_lpf, fs, config->rocof_cutoff);
+
+    return lock_detector_reset(ld);
+}
+
+ld_error_t lock_detector_reset(pll_lock_detector_t* ld) {
+    if (!ld) return LD_ERROR_NULL_POINTER;
+
+    for (int k = 0; k < 2; k++) {
+        lpf_set_value(&ld->i_lpf[k], 0.0f, 0.0f);
+        lpf_set_value(&ld->q_lpf[k], 0.0f, 0.0f);
+        lpf_reset_init_flag(&ld->i_lpf[k]);
+        lpf_reset_init_flag(&ld->q_lpf[k]);
+    }
+    lpf_set_value(&ld->freq_lpf, 0.0f, 0.0f);
+    lpf_set_value(&ld->rocof_lpf, 0.0f, 0.0f);
+    lpf_reset_init_flag(&ld->freq_lpf);
+    lpf_reset_init_flag(&ld->rocof_lpf);
+    ld->prev_frequency = 0.0f;
+    ld->hold = 0;
+
+    ld->locked = false;
+    ld->quality = 0.0f;
+    ld->amplitude = 0.0f;
+    ld->frequency = 0.0f;
+    ld->rocof = 0.0f;
+    return LD_ERROR_NONE;
+}
@@ -0,0 +1,205 @@
+#include "pll_tuner.h"
+#include <math.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define TUNE_CHUNK 16
+
+typedef struct {
+    float phase[PLL_TUNE_MAX_RECORD];
+    float frequency[PLL_TUNE_MAX_RECORD];
+    float error[PLL_TUNE_MAX_RECORD];
+    float step[PLL_TUNE_MAX_RECORD];
+} TuneScratch;
+
+static int init_pll(PLL* pll, const PllTuneSetup* setup, const PllTuneParams* p) {
+    float ratios[MAX_NOTCH_FILTERS];
+    for (int k = 0; k < MAX_NOTCH_FILTERS; k++) ratios[k] = p->notch_ratio;
+    return pll_init(pll, setup->sampling_freq, setup->nominal_freq, ratios, p->notch_config,
+                    p->lpf_cutoff, p->kd, p->kp, p->ki,
+                    setup->nominal_freq + setup->freq_span, setup->nominal_freq - setup->freq_span,
+                    setup->k0, 0.0f);
+}
+
+// Lock time and jitter of one log
+static void score_record(const PllTuneSetup* setup, const PllTuneRecord* rec, TuneScratch* s,
+                         float* lock_s, float* jitter) {
+    const int n = rec->length;
+    const int half = n / 2;
+    const int cycle = (int)(setup->sampling_freq / setup->nominal_freq + 0.5f);
+    const int hold = (int)(setup->lock_hold * setup->sampling_freq);
+
+    float sc = 0.0f, ss = 0.0f;
+    for (int i = half; i < n; i++) {
+        float e = s->phase[i] - rec->angle[i];
+        sc += cosf(e);
+        ss += sinf(e);
+    }
+    float offset = atan2f(ss, sc);
+
+    double sq = 0.0, e_sum = 0.0;
+    int last_bad = -1, lock = -1;
+    for (int i = 0; i < n; i++) {
+        float e = remainderf(s->phase[i] - rec->angle[i] - offset, 2.0f * (float)M_PI);
+        s->error[i] = e;
+        e_sum += e;
+        if (i >= cycle) e_sum -= s->error[i - cycle];
+        int m = i < cycle ? i + 1 : cycle;
+        if (fabs(e_sum / m) > setup->lock_tol) last_bad = i;
+        if (lock < 0 && i - last_bad >= hold) lock = last_bad + 1;
+        if (i >= half) sq += (double)e * e;
+    }
+    *lock_s = (float)(lock < 0 ? n : lock) / setup->sampling_freq;
+    *jitter = (float)sqrt(sq / (n - half));
+}
+
+// Settle time of the frequency step
+static float score_step(const PllTuneSetup* setup, PLL* pll, TuneScratch* s) {
+    const int before = (int)(setup->step_time * setup->sampling_freq);
+    int n = 2 * before;
+    if (n > PLL_TUNE_MAX_RECORD) n = PLL_TUNE_MAX_RECORD;
+    const int cycle = (int)(setup->sampling_freq / setup->nominal_freq + 0.5f);
+
+    // Fixed LCG for the noise so every set sees the same signal
+    uint32_t seed = 12345u;
+    float theta = 0.0f;
+    for (int i = 0; i < n; i++) {
+        float f = i < before ? setup->step_from : setup->step_to;
+        theta = fmodf(theta + 2.0f * (float)M_PI * f / setup->sampling_freq, 2.0f * (float)M_PI);
+        seed = seed * 1664525u + 1013904223u;
+        float noise = 0.01f * ((float)(seed >> 8) / 16777216.0f - 0.5f);
+        s->step[i] = setup->step_amplitude * (sinf(theta) + 0.05f * sinf(3.0f * theta) + noise);
+    }
+    PLLBlockOutputs out = { NULL, s->frequency, NULL, NULL, false };
+    pll_process_block(pll, s->step, (size_t)n, &out);
+
+    double f_sum = 0.0;
+    int last_bad = before;
+    for (int i = 0; i < n; i++) {
+        f_sum += s->frequency[i];
+        if (i >= cycle) f_sum -= s->frequency[i - cycle];
+        if (i >= before && fabs(f_sum / cycle - setup->step_to) > setup->settle_tol) last_bad = i;
+    }
+    return (float)(last_bad + 1 - before) / setup->sampling_freq;
+}
+
+static int evaluate(const PllTuneSetup* setup, const PllTuneRecord* records, int num_records,
+                    const PllTuneParams* params, PllTuneScore* score, TuneScratch* s) {
+    PLL pll;
+    score->lock_s = 0.0f;
+    score->jitter_rad = 0.0f;
+    for (int r = 0; r < num_records; r++) {
+        const PllTuneRecord* rec = &records[r];
+        if (rec->length <= 0 || rec->length > PLL_TUNE_MAX_RECORD) return PLL_ERROR_INVALID_PARAMETER;
+        if (init_pll(&pll, setup, params) != PLL_SUCCESS) return PLL_ERROR_INVALID_PARAMETER;
+        PLLBlockOutputs out = { s->phase, NULL, NULL, NULL, false };
+        pll_process_block(&pll, rec->v, (size_t)rec->length, &out);
+
+        float lock_s, jitter;
+        score_record(setup, rec, s, &lock_s, &jitter);
+        if (lock_s > score->lock_s) score->lock_s = lock_s;
+        score->jitter_rad += jitter / (float)num_records;
+    }
+    if (init_pll(&pll, setup, params) != PLL_SUCCESS) return PLL_ERROR_INVALID_PARAMETER;
+    score->settle_s = score_step(setup, &pll, s);
+    return PLL_SUCCESS;
+}
+
+int pll_tune_evaluate(const PllTuneSetup* setup, const PllTuneRecord* records, int num_records,
+                      const PllTuneParams* params, PllTuneScore* score) {
+    if (!setup || (num_records > 0 && !records) || !params || !score) return PLL_ERROR_NULL_POINTER;
+    TuneScratch* s = malloc(sizeof(TuneScratch));
+    if (!s) return PLL_ERROR_NULL_POINTER;
+    vco_nco_lut_init();
+    int result = evaluate(setup, records, num_records, params, score, s);
+    free(s);
+    return result;
+}
+
+typedef struct {
+    const PllTuneSetup* setup;
+    const PllTuneRecord* records;
+    int num_records;
+    const PllTuneParams* params;
+    PllTuneScore* scores;
+    int count;
+    atomic_int next;
+    atomic_int failed;
+} TuneJob;
+
+// Sets are independent and write disjoint scores; chunks keep the counter cold
+static void* tune_worker(void* arg) {
+    TuneJob* job = arg;
+    TuneScratch* s = malloc(sizeof(TuneScratch));
+    if (!s) {
+        atomic_store(&job->failed, 1);
+        return NULL;
+    }
+    for (int begin = atomic_fetch_add(&job->next, TUNE_CHUNK); begin < job->count;
+         begin = atomic_fetch_add(&job->next, TUNE_CHUNK)) {
+        int end = begin + TUNE_CHUNK < job->count ? begin + TUNE_CHUNK : job->count;
+        for (int i = begin; i < end; i++) {
+            if (evaluate(job->setup, job->records, job->num_records, &job->params[i], &job->scores[i], s) != PLL_SUCCESS) {
+                atomic_store(&job->failed, 1);
+            }
+        }
+    }
+    free(s);
+    return NULL;
+}
+
+int pll_tune_run(const PllTuneSetup* setup, const PllTuneRecord* records, int num_records,
+                 const PllTuneParams* params, PllTuneScore* scores, int count, int num_threads) {
+    if (!setup || (num_records > 0 && !records) || (count > 0 && (!params || !scores))) return PLL_ERROR_NULL_POINTER;
+    if (count <= 0) return PLL_SUCCESS;
+    if (num_threads <= 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = cores > 0 ? (int)cores : 1;
+    }
+    if (num_threads > (count + TUNE_CHUNK - 1) / TUNE_CHUNK) num_threads = (count + TUNE_CHUNK - 1) / TUNE_CHUNK;
+
+    // Build the shared sin table before any worker can race on it
+    vco_nco_lut_init();
+
+    TuneJob job = { setup, records, num_records, params, scores, count, 0, 0 };
+    pthread_t* threads = malloc(sizeof(pthread_t) * (size_t)num_threads);
+    if (!threads) return PLL_ERROR_NULL_POINTER;
+    int started = 0;
+    for (int t = 1; t < num_threads; t++) {
+        if (pthread_create(&threads[started], NULL, tune_worker, &job) == 0) started++;
+    }
+    tune_worker(&job);
+    for (int t = 0; t < started; t++) pthread_join(threads[t], NULL);
+    free(threads);
+    return atomic_load(&job.failed) ? PLL_ERROR_INVALID_PARAMETER : PLL_SUCCESS;
+}
+
+static int dominates(const PllTuneScore* a, const PllTuneScore* b) {
+    return a->lock_s <= b->lock_s && a->jitter_rad <= b->jitter_rad && a->settle_s <= b->settle_s &&
+           (a->lock_s < b->lock_s || a->jitter_rad < b->jitter_rad || a->settle_s < b->settle_s);
+}
+
+int pll_tune_pareto(const PllTuneScore* scores, int count, int* front) {
+    if (!scores || !front) return 0;
+    int size = 0;
+    for (int i = 0; i < count; i++) {
+        int dominated = 0;
+        for (int j = 0; j < count && !dominated; j++) {
+            dominated = j != i && dominates(&scores[j], &scores[i]);
+        }
+        if (!dominated) {
+            // Insertion by lock time, then jitter
+            int k = size++;
+            while (k > 0 && (scores[front[k - 1]].lock_s > scores[i].lock_s ||
+                             (scores[front[k - 1]].lock_s == scores[i].lock_s &&
+                              scores[front[k - 1]].jitter_rad > scores[i].jitter_rad))) {
+                front[k] = front[k - 1];
+                k--;
+            }
+            front[k] = i;
+        }
+    }
+    return size;
+}
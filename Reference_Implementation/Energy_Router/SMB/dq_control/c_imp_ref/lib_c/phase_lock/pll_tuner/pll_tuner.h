@@ -0,0 +1,67 @@
+#ifndef PLL_TUNER_H
+#define PLL_TUNER_H
+
+#include <stddef.h>
+#include "../pll.h"
+
+// Scores many PLL parameter sets on recorded logs plus a synthetic
+// frequency step, spread over threads, and keeps the Pareto front.
+//
+// Per set and log: lock time (first time the one-cycle average of the
+// phase error against the logged angle, steady offset removed, stays within
+// lock_tol for lock_hold) and jitter (RMS of that error over the second
+// half). The step goes step_from -> step_to Hz with a 5 % third harmonic;
+// settle is when the one-cycle average frequency stays within settle_tol.
+// A set is scored by its worst lock time, mean jitter and settle time.
+
+typedef struct {
+    float kd, kp, ki;
+    float lpf_cutoff;
+    int notch_config;
+    float notch_ratio;          // same ratio for every active notch
+} PllTuneParams;
+
+typedef struct {
+    float lock_s;               // worst over the logs (record length if never)
+    float jitter_rad;           // mean over the logs
+    float settle_s;             // step (remaining step time if never)
+} PllTuneScore;
+
+typedef struct {
+    const char* name;
+    const float* v;
+    const float* angle;         // logged PLL angle, any fixed offset
+    int length;
+} PllTuneRecord;
+
+typedef struct {
+    float sampling_freq;
+    float nominal_freq;
+    float freq_span;            // VCO range nominal +- freq_span
+    float k0;
+    float lock_tol;             // rad
+    float lock_hold;            // s
+    float step_from, step_to;   // Hz
+    float step_amplitude;       // same scale as the logs
+    float step_time;            // s, before and after the step
+    float settle_tol;           // Hz
+} PllTuneSetup;
+
+#define PLL_TUNE_SETUP_DEFAULTS { 1000.0f, 50.0f, 5.0f, 1.0f, 0.2f, 0.1f, \
+                                  50.0f, 51.0f, 3.5f, 1.0f, 0.1f }
+
+#define PLL_TUNE_MAX_RECORD 8192
+
+// One parameter set, single thread
+int pll_tune_evaluate(const PllTuneSetup* setup, const PllTuneRecord* records, int num_records,
+                      const PllTuneParams* params, PllTuneScore* score);
+
+// Every set, num_threads workers (0: one per online core) claiming chunks
+// of sets; scores[i] belongs to params[i]
+int pll_tune_run(const PllTuneSetup* setup, const PllTuneRecord* records, int num_records,
+                 const PllTuneParams* params, PllTuneScore* scores, int count, int num_threads);
+
+// Indices of the non-dominated scores, sorted by lock time; returns the count
+int pll_tune_pareto(const PllTuneScore* scores, int count, int* front);
+
+#endif // PLL_TUNER_H
@@ -5,6 +5,37 @@
 extern volatile float g_control_signal;
 extern volatile int g_signal_valid;
 
+// sin over one turn plus a guard entry for the interpolation
+static float sin_lut[VCO_LUT_SIZE + 1];
+static bool sin_lut_ready = false;
+
+void vco_nco_lut_init(void) {
+    if (sin_lut_ready) return;
+    for (int i = 0; i <= VCO_LUT_SIZE; i++) {
+        sin_lut[i] = (float)sin(2.0 * M_PI * (double)i / VCO_LUT_SIZE);
+    }
+    sin_lut_ready = true;
+}
+
+static inline float lut_sin(uint32_t acc) {
+    const uint32_t frac_bits = 32 - VCO_LUT_BITS;
+    uint32_t idx = acc >> frac_bits;
+    float frac = (float)(acc & ((1u << frac_bits) - 1u)) * (1.0f / (float)(1u << frac_bits));
+    float a = sin_lut[idx];
+    return a + (sin_lut[idx + 1] - a) * frac;
+}
+
+void vco_nco_sincos(uint32_t acc, float* s, float* c) {
+    if (s) *s = lut_sin(acc);
+    if (c) *c = lut_sin(acc + 0x40000000u);    // cos x = sin(x + pi/2)
+}
+
+uint32_t vco_phase_to_acc(float phase) {
+    double turns = (double)phase / (2.0 * M_PI);
+    turns -= floor(turns);
+    return (uint32_t)(uint64_t)(turns * 4294967296.0);
+}
+
 vco_error_t vco_controller_init(vco_controller_t* vco, 
                                float ts, 
                                float nominal_freq,
@@ -17,9 +48,11 @@ vco_error_t vco_controller_init(vco_controller_t* vco,
     vco->ts = ts;
     vco->nominal_freq = nominal_freq;
     vco->k0 = k0;
+    vco_nco_lut_init();
     
     // Initialize states
-    vco->phase = initial_phase - 2.0f * M_PI * nominal_freq * ts;
+    vco->phase_acc = vco_phase_to_acc(initial_phase) - vco_freq_to_step(nominal_freq, ts);
+    vco->phase = vco_acc_to_phase(vco->phase_acc);
     // vco->phase_nominal = 0.0f;
     vco->phase_correction = 0.0f;
     vco->frequency = nominal_freq;
@@ -35,8 +68,9 @@ vco_error_t vco_controller_update(vco_controller_t* vco, float control_signal) {
     vco->freq_correction = vco->k0 * control_signal;
     vco->frequency = vco->nominal_freq + vco->freq_correction;
     
-    // Integrate frequency to get phase
-    vco->phase += 2.0f * M_PI * vco->frequency * vco->ts;
+    // Integrate frequency to get phase; the accumulator wraps by itself
+    vco->phase_acc += vco_freq_to_step(vco->frequency, vco->ts);
+    vco->phase = vco_acc_to_phase(vco->phase_acc);
     
     return VCO_ERROR_NONE;
 }
@@ -44,6 +78,7 @@ vco_error_t vco_controller_update(vco_controller_t* vco, float control_signal) {
 vco_error_t vco_controller_reset(vco_controller_t* vco) {
     if (!vco) return VCO_ERROR_NULL_POINTER;
     
+    vco->phase_acc = 0;
     vco->phase = 0.0f;
     // vco->phase_nominal = 0.0f;
     vco->phase_correction = 0.0f;
@@ -71,5 +106,14 @@ float vco_controller_get_frequency(const vco_controller_t* vco) {
 }
 
 void vco_controller_reset_init_phase(vco_controller_t* vco, float initial_phase) {
-    vco->phase = initial_phase;
-}
\ No newline at end of file
+    vco_controller_set_phase(vco, initial_phase);
+}
+
+void vco_controller_set_phase(vco_controller_t* vco, float phase) {
+    vco->phase_acc = vco_phase_to_acc(phase);
+    vco->phase = vco_acc_to_phase(vco->phase_acc);
+}
+
+void vco_controller_get_sincos(const vco_controller_t* vco, float* s, float* c) {
+    vco_nco_sincos(vco->phase_acc, s, c);
+}
@@ -2,9 +2,20 @@
 #define VCO_CONTROLLER_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <math.h>
 #include <stdlib.h>
 
+#define VCO_TWO_PI 6.28318530718f
+
+// Numerically controlled oscillator: the phase is a 32-bit accumulator,
+// 2^32 counts per turn, that wraps by itself. Resolution is 1.5e-9 rad at
+// any uptime. sin/cos come from a VCO_LUT_BITS table indexed by the top
+// bits, linearly interpolated on the rest (error < 5e-6 for 10 bits).
+#define VCO_ACC_PER_TURN 4294967296.0f
+#define VCO_LUT_BITS 10
+#define VCO_LUT_SIZE (1 << VCO_LUT_BITS)
+
 // Error codes for VCO controller operations
 typedef enum {
     VCO_ERROR_NONE = 0,
@@ -20,7 +31,8 @@ typedef struct {
     float k0;             // VCO gain factor (Hz/V)
     
     // States
-    float phase;           // Total phase (nominal + correction) (radians)
+    uint32_t phase_acc;    // NCO accumulator, the phase itself
+    float phase;           // phase_acc in radians, [0, 2 pi)
     // float phase_nominal;   // Phase from nominal frequency (radians)
     float phase_correction;// Phase from frequency correction (radians)
     float frequency;       // Total frequency (nominal + correction) (Hz)
@@ -80,4 +92,49 @@ float vco_controller_get_frequency(const vco_controller_t* vco);
 
 void vco_controller_reset_init_phase(vco_controller_t* vco, float initial_phase);
 
+/**
+ * @brief Overwrite the phase (radians, any range), e.g. after an external integration
+ * @param vco Pointer to VCO controller structure
+ * @param phase New phase in radians
+ */
+void vco_controller_set_phase(vco_controller_t* vco, float phase);
+
+/**
+ * @brief sin and cos of the current phase from the NCO table
+ * @param vco Pointer to VCO controller structure
+ * @param s Output sine (may be NULL)
+ * @param c Output cosine (may be NULL)
+ */
+void vco_controller_get_sincos(const vco_controller_t* vco, float* s, float* c);
+
+// Table lookup on a raw accumulator value; the table is built by the first
+// vco_controller_init (or vco_nco_lut_init)
+void vco_nco_lut_init(void);
+void vco_nco_sincos(uint32_t acc, float* s, float* c);
+
+// Radians <-> accumulator counts
+uint32_t vco_phase_to_acc(float phase);
+
+// Top 24 bits only, so the float stays below 2 pi after rounding
+static inline float vco_acc_to_phase(uint32_t acc) {
+    return (float)(acc >> 8) * (VCO_TWO_PI / 16777216.0f);
+}
+
+// Accumulator increment for one sample at frequency (Hz); negative
+// frequencies wrap to the matching backwards step
+static inline uint32_t vco_freq_to_step(float frequency, float ts) {
+    return (uint32_t)llrintf(frequency * ts * VCO_ACC_PER_TURN);
+}
+
+// One turn off when the phase leaves [0, 2 pi); an unbounded float phase
+// loses a bit of resolution every time it doubles (0.016 rad after 10 min)
+static inline float vco_wrap_phase(float phase) {
+    if (phase >= VCO_TWO_PI) {
+        phase -= VCO_TWO_PI;
+    } else if (phase < 0.0f) {
+        phase += VCO_TWO_PI;
+    }
+    return phase;
+}
+
 #endif /* VCO_CONTROLLER_H */
\ No newline at end of file
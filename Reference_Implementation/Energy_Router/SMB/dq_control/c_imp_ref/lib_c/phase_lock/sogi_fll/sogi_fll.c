@@ -0,0 +1,48 @@
+#include "sogi_fll.h"
+#include <math.h>
+
+static int sogi_fll_init(void* state, const GridSyncConfig* config) {
+    static const SogiFllParams defaults = SOGI_FLL_DEFAULTS;
+    SogiFll* fll = state;
+    if (config->sampling_freq <= 0.0f || config->nominal_freq <= 0.0f) return PLL_ERROR_INVALID_PARAMETER;
+
+    fll->params = config->params ? *(const SogiFllParams*)config->params : defaults;
+    fll->ts = 1.0f / config->sampling_freq;
+    fll->omega_min = 2.0f * (float)M_PI * (config->nominal_freq - fll->params.freq_span);
+    fll->omega_max = 2.0f * (float)M_PI * (config->nominal_freq + fll->params.freq_span);
+    fll->omega = 2.0f * (float)M_PI * config->nominal_freq;
+    fll->theta = vco_wrap_phase(config->initial_phase);
+    sogi_qsg_init(&fll->qsg, fll->params.k, fll->ts);
+    return PLL_SUCCESS;
+}
+
+static void sogi_fll_update(void* state, float v) {
+    SogiFll* fll = state;
+    sogi_qsg_update(&fll->qsg, v, fll->omega);
+
+    float alpha = fll->qsg.alpha;
+    float beta = fll->qsg.beta;
+    float power = alpha * alpha + beta * beta;
+    if (power > 1e-12f) {
+        // d omega / dt = -gamma k omega (v - alpha) beta / |v|^2
+        float error = v - alpha;
+        float domega = -fll->params.gamma * fll->params.k * fll->omega * error * beta / power;
+        fll->omega = grid_sync_clamp(fll->omega + domega * fll->ts, fll->omega_min, fll->omega_max);
+        fll->theta = vco_wrap_phase(atan2f(beta, alpha));
+    } else {
+        fll->theta = vco_wrap_phase(fll->theta + fll->omega * fll->ts);
+    }
+}
+
+static float sogi_fll_phase(const void* state) {
+    return ((const SogiFll*)state)->theta;
+}
+
+static float sogi_fll_frequency(const void* state) {
+    return ((const SogiFll*)state)->omega * (float)(0.5 / M_PI);
+}
+
+const GridSyncOps sogi_fll_ops = {
+    "sogi-fll", sizeof(SogiFll),
+    sogi_fll_init, sogi_fll_update, sogi_fll_phase, sogi_fll_frequency
+};
@@ -0,0 +1,28 @@
+#ifndef SOGI_FLL_H
+#define SOGI_FLL_H
+
+#include "../sogi_pll/sogi_pll.h"
+
+// SOGI-FLL: the SOGI error (v - alpha) times beta drives the SOGI centre
+// frequency directly, normalized by the amplitude^2 so the dynamics do not
+// depend on the signal level; the phase is atan2(beta, alpha), no PI loop
+typedef struct {
+    float k;                // SOGI damping
+    float gamma;            // normalized FLL gain, settling ~ 5 / gamma s
+    float freq_span;        // frequency limited to nominal +- freq_span (Hz)
+} SogiFllParams;
+
+#define SOGI_FLL_DEFAULTS { 1.41421356f, 60.0f, 10.0f }
+
+typedef struct {
+    SogiFllParams params;
+    SogiQsg qsg;
+    float ts;
+    float omega_min, omega_max;
+    float omega;
+    float theta;
+} SogiFll;
+
+extern const GridSyncOps sogi_fll_ops;
+
+#endif // SOGI_FLL_H
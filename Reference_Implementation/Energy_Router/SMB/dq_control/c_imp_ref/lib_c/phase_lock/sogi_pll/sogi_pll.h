@@ -0,0 +1,46 @@
+#ifndef SOGI_PLL_H
+#define SOGI_PLL_H
+
+#include "../grid_sync/grid_sync.h"
+
+// Second-order generalized integrator quadrature signal generator,
+// bilinear discretization, retuned to the tracked frequency every sample:
+//   alpha = k w s / (s^2 + k w s + w^2) v     (in phase with v)
+//   beta  = k w^2 / (s^2 + k w s + w^2) v     (90 deg behind)
+typedef struct {
+    float k;
+    float ts;
+    float v1, v2;           // input history
+    float a1, a2;           // alpha output history
+    float b1, b2;           // beta output history
+    float alpha, beta;
+} SogiQsg;
+
+void sogi_qsg_init(SogiQsg* qsg, float k, float ts);
+void sogi_qsg_update(SogiQsg* qsg, float v, float omega);
+
+// SOGI-PLL: Park transform of (alpha, beta), PI on the normalized q axis
+typedef struct {
+    float k;                // SOGI damping, sqrt(2) for the usual 0.707
+    float kp;               // rad/s per rad of phase error
+    float ki;               // rad/s^2 per rad
+    float freq_span;        // frequency limited to nominal +- freq_span (Hz)
+} SogiPllParams;
+
+// Loop natural frequency ~15 Hz, damping 0.707
+#define SOGI_PLL_DEFAULTS { 1.41421356f, 133.0f, 8883.0f, 10.0f }
+
+typedef struct {
+    SogiPllParams params;
+    SogiQsg qsg;
+    float ts;
+    float omega_nominal;
+    float omega_min, omega_max;
+    float integrator;
+    float omega;
+    float theta;
+} SogiPll;
+
+extern const GridSyncOps sogi_pll_ops;
+
+#endif // SOGI_PLL_H
@@ -0,0 +1,73 @@
+#include "srf_pll.h"
+#include <math.h>
+#include <string.h>
+
+#define SRF_PLL_HISTORY (SRF_PLL_MAX_DELAY + 2)
+
+static int srf_pll_init(void* state, const GridSyncConfig* config) {
+    static const SrfPllParams defaults = SRF_PLL_DEFAULTS;
+    SrfPll* pll = state;
+    if (config->sampling_freq <= 0.0f || config->nominal_freq <= 0.0f) return PLL_ERROR_INVALID_PARAMETER;
+
+    float delay = config->sampling_freq / (4.0f * config->nominal_freq);
+    if (delay > (float)SRF_PLL_MAX_DELAY) return PLL_ERROR_INVALID_PARAMETER;
+
+    pll->params = config->params ? *(const SrfPllParams*)config->params : defaults;
+    memset(pll->history, 0, sizeof(pll->history));
+    pll->head = 0;
+    pll->delay_int = (int)delay;
+    pll->delay_frac = delay - (float)pll->delay_int;
+    pll->ts = 1.0f / config->sampling_freq;
+    pll->omega_nominal = 2.0f * (float)M_PI * config->nominal_freq;
+    pll->omega_min = 2.0f * (float)M_PI * (config->nominal_freq - pll->params.freq_span);
+    pll->omega_max = 2.0f * (float)M_PI * (config->nominal_freq + pll->params.freq_span);
+    pll->integrator = 0.0f;
+    pll->omega = pll->omega_nominal;
+    pll->theta = vco_wrap_phase(config->initial_phase - pll->omega * pll->ts);
+    return PLL_SUCCESS;
+}
+
+static void srf_pll_update(void* state, float v) {
+    SrfPll* pll = state;
+
+    pll->history[pll->head] = v;
+    int i0 = pll->head - pll->delay_int;
+    if (i0 < 0) i0 += SRF_PLL_HISTORY;
+    int i1 = i0 - 1;
+    if (i1 < 0) i1 += SRF_PLL_HISTORY;
+    pll->head = (pll->head + 1) % SRF_PLL_HISTORY;
+
+    pll->theta = vco_wrap_phase(pll->theta + pll->omega * pll->ts);
+    float alpha = v;
+    float beta = pll->history[i0] + pll->delay_frac * (pll->history[i1] - pll->history[i0]);
+
+    float c = cosf(pll->theta);
+    float s = sinf(pll->theta);
+    float vd = alpha * c + beta * s;
+    float vq = beta * c - alpha * s;
+
+    float amplitude = sqrtf(vd * vd + vq * vq);
+    float error = amplitude > 1e-6f ? vq / amplitude : 0.0f;
+
+    float delta = pll->params.kp * error;
+    pll->integrator = grid_sync_clamp(pll->integrator + pll->params.ki * error * pll->ts,
+                                      pll->omega_min - pll->omega_nominal,
+                                      pll->omega_max - pll->omega_nominal);
+    pll->omega = grid_sync_clamp(pll->omega_nominal + delta + pll->integrator, pll->omega_min, pll->omega_max);
+}
+
+static float srf_pll_phase(const void* state) {
+    return ((const SrfPll*)state)->theta;
+}
+
+static float srf_pll_frequency(const void* state) {
+    // Integral path only: the proportional kick is what moves the phase,
+    // the integrator holds the frequency
+    const SrfPll* pll = state;
+    return (pll->omega_nominal + pll->integrator) * (float)(0.5 / M_PI);
+}
+
+const GridSyncOps srf_pll_ops = {
+    "srf-pll", sizeof(SrfPll),
+    srf_pll_init, srf_pll_update, srf_pll_phase, srf_pll_frequency
+};
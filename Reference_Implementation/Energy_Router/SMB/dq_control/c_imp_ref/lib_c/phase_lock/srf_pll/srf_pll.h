@@ -0,0 +1,37 @@
+#ifndef SRF_PLL_H
+#define SRF_PLL_H
+
+#include "../grid_sync/grid_sync.h"
+
+// Single-phase SRF-PLL: beta is the input delayed by a quarter of the
+// nominal period (no filtering, so off-nominal frequency and harmonics show
+// up as ripple on the q axis), then Park transform and PI as in the SOGI-PLL
+#define SRF_PLL_MAX_DELAY 64    // samples, a quarter period up to 12.8 kHz at 50 Hz
+
+typedef struct {
+    float kp;               // rad/s per rad of phase error
+    float ki;               // rad/s^2 per rad
+    float freq_span;        // frequency limited to nominal +- freq_span (Hz)
+} SrfPllParams;
+
+// Loop natural frequency ~10 Hz, damping 0.707: lower than the SOGI-PLL
+// to keep the unfiltered 2f ripple out of the frequency
+#define SRF_PLL_DEFAULTS { 89.0f, 3948.0f, 10.0f }
+
+typedef struct {
+    SrfPllParams params;
+    float history[SRF_PLL_MAX_DELAY + 2];
+    int head;
+    int delay_int;          // quarter period in samples, integer part
+    float delay_frac;       // and fraction, linear interpolation
+    float ts;
+    float omega_nominal;
+    float omega_min, omega_max;
+    float integrator;
+    float omega;
+    float theta;
+} SrfPll;
+
+extern const GridSyncOps srf_pll_ops;
+
+#endif // SRF_PLL_H
@@ -0,0 +1,72 @@
+#include "gpio_pattern.h"
+#include <stddef.h>
+
+void gpio_pattern_begin(GpioPatternBuffer* buffer, uint32_t cycle_ticks) {
+    if (!buffer) return;
+    buffer->cycle_ticks = cycle_ticks;
+    buffer->num_entries = 0;
+}
+
+bool gpio_pattern_append(GpioPatternBuffer* buffer, uint32_t tick, pwm_word_t word) {
+    if (!buffer || tick >= buffer->cycle_ticks) return false;
+
+    if (buffer->num_entries > 0) {
+        GpioPatternEntry* last = &buffer->entries[buffer->num_entries - 1];
+        if (tick < last->tick) return false;
+        if (tick == last->tick) {
+            // Edges closer than one tick: the later state wins
+            last->word = word;
+            if (buffer->num_entries > 1 && buffer->entries[buffer->num_entries - 2].word == word) {
+                buffer->num_entries--;
+            }
+            return true;
+        }
+        if (last->word == word) return true;
+    } else if (tick != 0) {
+        return false;   // a cycle starts with its state at tick 0
+    }
+
+    if (buffer->num_entries == GPIO_PATTERN_MAX_ENTRIES) return false;
+    buffer->entries[buffer->num_entries].tick = tick;
+    buffer->entries[buffer->num_entries].word = word;
+    buffer->num_entries++;
+    return true;
+}
+
+pwm_word_t gpio_pattern_word_at(const GpioPatternBuffer* buffer, uint32_t tick) {
+    if (!buffer || buffer->num_entries == 0) return 0;
+    // Last entry with entries[i].tick <= tick
+    uint32_t left = 0;
+    uint32_t right = buffer->num_entries - 1;
+    while (left < right) {
+        uint32_t mid = (left + right + 1) / 2;
+        if (buffer->entries[mid].tick <= tick) {
+            left = mid;
+        } else {
+            right = mid - 1;
+        }
+    }
+    return buffer->entries[left].word;
+}
+
+void gpio_pattern_player_init(GpioPatternPlayer* player) {
+    if (!player) return;
+    gpio_pattern_begin(&player->buffers[0], 1);
+    gpio_pattern_begin(&player->buffers[1], 1);
+    gpio_pattern_append(&player->buffers[0], 0, 0);     // all switches off until the first swap
+    player->front = 0;
+    player->swaps = 0;
+}
+
+GpioPatternBuffer* gpio_pattern_back(GpioPatternPlayer* player) {
+    return &player->buffers[player->front ^ 1u];
+}
+
+const GpioPatternBuffer* gpio_pattern_front(const GpioPatternPlayer* player) {
+    return &player->buffers[player->front];
+}
+
+void gpio_pattern_swap(GpioPatternPlayer* player) {
+    player->front ^= 1u;
+    player->swaps++;
+}
@@ -0,0 +1,72 @@
+#ifndef GPIO_PATTERN_H
+#define GPIO_PATTERN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// One grid cycle of output as (timer tick, packed GPIO word) pairs, the
+// layout a timer-triggered DMA copies to the output port: the CPU renders a
+// cycle ahead into the back buffer and swaps once per cycle.
+//
+// Word layout: one byte lane per H-bridge (io_index) holding the
+// convert_HBridgeState_to_binary value of that bridge.
+
+#ifndef GPIO_PATTERN_MAX_ENTRIES
+#define GPIO_PATTERN_MAX_ENTRIES 64     // stair wave: 4 * modules + 1 per cycle
+#endif
+
+#define GPIO_PATTERN_LANE_BITS 8
+
+// The one definition of MAX_NUM_MODULES: override it with -D for the whole
+// build, every module header gets it from here
+#ifndef MAX_NUM_MODULES
+    #define MAX_NUM_MODULES 4
+#endif
+
+// Port word: 4 lanes fit 32 bits, up to 8 need 64
+#if MAX_NUM_MODULES > 8
+    #error "gpio_pattern: a port word holds at most 8 modules"
+#elif MAX_NUM_MODULES > 4
+    typedef uint64_t pwm_word_t;
+#else
+    typedef uint32_t pwm_word_t;
+#endif
+
+typedef struct {
+    uint32_t tick;      // timer ticks from the start of the cycle
+    pwm_word_t word;    // port value from this tick on
+} GpioPatternEntry;
+
+typedef struct {
+    uint32_t cycle_ticks;       // timer ticks per grid cycle
+    uint32_t num_entries;
+    GpioPatternEntry entries[GPIO_PATTERN_MAX_ENTRIES];    // tick ascending, entries[0].tick == 0
+} GpioPatternBuffer;
+
+typedef struct {
+    GpioPatternBuffer buffers[2];
+    volatile uint32_t front;    // index of the buffer being played
+    uint32_t swaps;
+} GpioPatternPlayer;
+
+void gpio_pattern_begin(GpioPatternBuffer* buffer, uint32_t cycle_ticks);
+
+// Append a change; repeated words are dropped and a second entry on the same
+// tick replaces the first. false when the buffer is full or tick goes back.
+bool gpio_pattern_append(GpioPatternBuffer* buffer, uint32_t tick, pwm_word_t word);
+
+// Word in effect at tick (binary search)
+pwm_word_t gpio_pattern_word_at(const GpioPatternBuffer* buffer, uint32_t tick);
+
+void gpio_pattern_player_init(GpioPatternPlayer* player);
+
+// Buffer to render the next cycle into
+GpioPatternBuffer* gpio_pattern_back(GpioPatternPlayer* player);
+
+// Buffer the DMA plays this cycle
+const GpioPatternBuffer* gpio_pattern_front(const GpioPatternPlayer* player);
+
+// Publish the back buffer; call from the cycle-end interrupt
+void gpio_pattern_swap(GpioPatternPlayer* player);
+
+#endif // GPIO_PATTERN_H
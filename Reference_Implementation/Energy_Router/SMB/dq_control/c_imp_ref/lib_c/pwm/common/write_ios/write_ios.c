@@ -10,94 +10,149 @@
     #define PWM_MODE_TEST
 #endif
 
-static volatile uint32_t** pwm_outputs = NULL;
-#ifdef PWM_MODE_TEST
-    static uint32_t* pwm_memory = NULL;
+#if (WRITE_IOS_TRACE_SIZE & (WRITE_IOS_TRACE_SIZE - 1)) != 0
+    #error "WRITE_IOS_TRACE_SIZE must be a power of 2"
 #endif
-static bool pwm_initialized = false;
 
-// Forward declaration of static function
-static void cleanup_pwm_outputs(void);
+#if MAX_NUM_MODULES > 8
+    #error "write_ios: the register map has 8 bridge outputs"
+#endif
 
-static bool initialize_pwm_outputs(void) {
-    if (pwm_initialized) return true;
-    
-    if (MAX_NUM_MODULES <= 0 || MAX_NUM_MODULES > 4) {
-        return false;
-    }
-    
-    pwm_outputs = (volatile uint32_t**)malloc(MAX_NUM_MODULES * sizeof(volatile uint32_t*));
-    if (!pwm_outputs) return false;
+#define LANE_MASK ((1u << GPIO_PATTERN_LANE_BITS) - 1u)
 
+// One register per bridge at a fixed address, so nothing is set up at run time
 #ifdef PWM_MODE_TEST
-    // Test mode: Allocate memory for simulation
-    pwm_memory = (uint32_t*)malloc(MAX_NUM_MODULES * sizeof(uint32_t));
-    if (!pwm_memory) {
-        free(pwm_outputs);
-        pwm_outputs = NULL;
-        return false;
-    }
-    
-    for (int i = 0; i < MAX_NUM_MODULES; i++) {
-        pwm_memory[i] = 0;
-        pwm_outputs[i] = (volatile uint32_t*)&pwm_memory[i];
-    }
+    // Test mode: registers simulated in memory, every word mirrored to the trace
+    static uint32_t pwm_memory[MAX_NUM_MODULES];
+    static pwm_word_t trace_ring[WRITE_IOS_TRACE_SIZE];
+    static uint32_t trace_total;
+    #define PWM_OUTPUT_REG(i) (*(volatile uint32_t*)&pwm_memory[(i)])
 #else
-    // Real mode: Use actual hardware addresses for 4 H-bridges
-    pwm_outputs[0] = (volatile uint32_t*)(PWM_OUTPUT_BASE_ADDR + PWM_OUTPUT1_OFFSET);
-    pwm_outputs[1] = (volatile uint32_t*)(PWM_OUTPUT_BASE_ADDR + PWM_OUTPUT2_OFFSET);
-    pwm_outputs[2] = (volatile uint32_t*)(PWM_OUTPUT_BASE_ADDR + PWM_OUTPUT3_OFFSET);
-    pwm_outputs[3] = (volatile uint32_t*)(PWM_OUTPUT_BASE_ADDR + PWM_OUTPUT4_OFFSET);
+    #define PWM_OUTPUT_REG(i) (*(volatile uint32_t*)(uintptr_t) \
+        (PWM_OUTPUT_BASE_ADDR + PWM_OUTPUT1_OFFSET + (i) * PWM_OUTPUT_STRIDE))
 #endif
 
-    pwm_initialized = true;
-    return true;
-}
+// Last word written, to skip the bridges that did not change
+static pwm_word_t port_word = 0;
 
-static void cleanup_pwm_outputs(void) {
+void initialize_pwm_ios(void) {
+    port_word = 0;
 #ifdef PWM_MODE_TEST
-    if (pwm_memory) {
-        free(pwm_memory);
-        pwm_memory = NULL;
-    }
+    trace_total = 0;
 #endif
-    if (pwm_outputs) {
-        free(pwm_outputs);
-        pwm_outputs = NULL;
+    for (int i = 0; i < MAX_NUM_MODULES; i++) {
+        PWM_OUTPUT_REG(i) = 0;    // all switches off
     }
-    pwm_initialized = false;
 }
 
-void write_ios_from_dc_sources(single_dc_source_t* dc_sources, int num_of_modules) {
+void cleanup_pwm_ios(void) {
+    initialize_pwm_ios();
+}
+
+pwm_word_t write_ios_pack(const single_dc_source_t* dc_sources, int num_of_modules) {
+    pwm_word_t word = 0;
     if (!dc_sources || num_of_modules <= 0 || num_of_modules > MAX_NUM_MODULES) {
-        return;
+        return word;
     }
-    
-    if (!initialize_pwm_outputs()) {
-        return;
-    }
-    
-    // Add debug prints
-    printf("\nWriting PWM states:\n");
     for (int i = 0; i < num_of_modules; i++) {
         int io_index = dc_sources[i].io_index;
-        if (io_index >= 0 && io_index < MAX_NUM_MODULES && pwm_outputs[io_index]) {
-            uint32_t state = convert_HBridgeState_to_binary(dc_sources[i].pwm_state);
-            *pwm_outputs[io_index] = state;
-            printf("Module %d (io_index %d): State=%d, Binary=0x%x\n", 
-                   i, io_index, dc_sources[i].pwm_state, state);
+        if (io_index >= 0 && io_index < MAX_NUM_MODULES) {
+            pwm_word_t lane = convert_HBridgeState_to_binary(dc_sources[i].pwm_state) & LANE_MASK;
+            word |= lane << (GPIO_PATTERN_LANE_BITS * io_index);
         }
     }
+    return word;
+}
+
+void write_ios_from_dc_sources(single_dc_source_t* dc_sources, int num_of_modules) {
+    if (!dc_sources || num_of_modules <= 0 || num_of_modules > MAX_NUM_MODULES) {
+        return;
+    }
+    write_ios_word(write_ios_pack(dc_sources, num_of_modules));
+}
 
+void write_ios_word(pwm_word_t word) {
+    pwm_word_t changed = word ^ port_word;
+    for (int i = 0; changed != 0 && i < MAX_NUM_MODULES; i++) {
+        if ((changed >> (GPIO_PATTERN_LANE_BITS * i)) & LANE_MASK) {
+            PWM_OUTPUT_REG(i) = (uint32_t)(word >> (GPIO_PATTERN_LANE_BITS * i)) & LANE_MASK;
+        }
+    }
+    port_word = word;
 #ifdef PWM_MODE_TEST
-    // Verify what was actually written
-    printf("\nVerifying PWM memory:\n");
-    for (int i = 0; i < num_of_modules; i++) {
-        printf("Memory[%d] = 0x%x\n", i, pwm_memory[i]);
+    trace_ring[trace_total & (WRITE_IOS_TRACE_SIZE - 1)] = word;
+    trace_total++;
+#endif
+}
+
+pwm_word_t write_ios_read_word(void) {
+#ifdef PWM_MODE_TEST
+    // Rebuild from the registers, so tests see what the stores left there
+    pwm_word_t word = 0;
+    for (int i = 0; i < MAX_NUM_MODULES; i++) {
+        word |= (pwm_word_t)(pwm_memory[i] & LANE_MASK) << (GPIO_PATTERN_LANE_BITS * i);
     }
+    return word;
+#else
+    return port_word;
 #endif
 }
 
-void cleanup_pwm_ios(void) {
-    cleanup_pwm_outputs();
-}
\ No newline at end of file
+uint32_t write_ios_play_pattern(const GpioPatternBuffer* buffer, uint32_t tick_begin, uint32_t tick_end) {
+    if (!buffer || buffer->num_entries == 0 || tick_begin >= tick_end) {
+        return 0;
+    }
+
+    // First entry at or after tick_begin
+    uint32_t i = 0;
+    while (i < buffer->num_entries && buffer->entries[i].tick < tick_begin) {
+        i++;
+    }
+
+    uint32_t written = 0;
+    for (; i < buffer->num_entries && buffer->entries[i].tick < tick_end; i++) {
+        write_ios_word(buffer->entries[i].word);
+        written++;
+    }
+    return written;
+}
+
+uint32_t write_ios_trace_total(void) {
+#ifdef PWM_MODE_TEST
+    return trace_total;
+#else
+    return 0;
+#endif
+}
+
+uint32_t write_ios_trace_read(pwm_word_t* dst, uint32_t max_words) {
+#ifdef PWM_MODE_TEST
+    if (!dst) return 0;
+    uint32_t count = trace_total < WRITE_IOS_TRACE_SIZE ? trace_total : WRITE_IOS_TRACE_SIZE;
+    if (count > max_words) count = max_words;
+    uint32_t first = trace_total - count;
+    for (uint32_t i = 0; i < count; i++) {
+        dst[i] = trace_ring[(first + i) & (WRITE_IOS_TRACE_SIZE - 1)];
+    }
+    return count;
+#else
+    (void)dst;
+    (void)max_words;
+    return 0;
+#endif
+}
+
+bool write_ios_trace_dump(const char* path) {
+#ifdef PWM_MODE_TEST
+    static pwm_word_t words[WRITE_IOS_TRACE_SIZE];
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+    uint32_t count = write_ios_trace_read(words, WRITE_IOS_TRACE_SIZE);
+    bool ok = fwrite(words, sizeof(pwm_word_t), count, file) == count;
+    fclose(file);
+    return ok;
+#else
+    (void)path;
+    return false;
+#endif
+}
@@ -3,7 +3,15 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+// Module types: the stair-wave tree has its own single_dc_source_t
+// (stairw_base_type.h). Its builds pass -DPWM_STAIR_WAVE_TYPES to every
+// file, write_ios.c included, so both sides agree on the layout.
+#ifdef PWM_STAIR_WAVE_TYPES
+#include "../../stair_wave/common/table_def/table_def.h"
+#else
 #include "../pwm_base_type/pwm_base_type.h"
+#endif
+#include "../gpio_pattern/gpio_pattern.h"
 
 // IO Address definitions for 4 H-bridges
 #define PWM_OUTPUT_BASE_ADDR    0x43C00000
@@ -13,18 +21,51 @@
 #define PWM_OUTPUT4_OFFSET      0x00000010
 #define PWM_OUTPUT5_OFFSET      0x00000014
 #define PWM_OUTPUT6_OFFSET      0x00000018
-#define PWM_OUTPUT7_OFFSET      0x0000001C  
+#define PWM_OUTPUT7_OFFSET      0x0000001C
 #define PWM_OUTPUT8_OFFSET      0x00000020
 
+// Bridge io_index i is driven by its own 32-bit register at
+// PWM_OUTPUT_BASE_ADDR + PWM_OUTPUT1_OFFSET + i * PWM_OUTPUT_STRIDE.
+// A port word (pwm_word_t, see gpio_pattern.h) is written as one store per
+// bridge whose lane changed, lowest io_index first: bridges switch on
+// consecutive bus writes, not on one. Switching them together needs a
+// packed register in the FPGA design, which this map does not have.
+#define PWM_OUTPUT_STRIDE       0x00000004
+
 // Add these definitions
 #define PWM_BASE_ADDRESS 0x40000000  // Replace with your actual base address
 #define PWM_OFFSET 0x1000            // Replace with your actual offset between PWM registers
 
-#ifndef MAX_NUM_MODULES
-    #define MAX_NUM_MODULES 4
+// Test mode keeps the last WRITE_IOS_TRACE_SIZE output words (power of 2)
+#ifndef WRITE_IOS_TRACE_SIZE
+    #define WRITE_IOS_TRACE_SIZE 1024
 #endif
 
 // Function declarations
+void initialize_pwm_ios(void);
+void cleanup_pwm_ios(void);
 void write_ios_from_dc_sources(single_dc_source_t * sorted_dc_sources, int num_of_modules);
 
-#endif // WRITE_IOS_H
\ No newline at end of file
+// Gate pattern of one bridge state, the lane value of a port word
+// (defined in modulation_2pwm.c)
+uint32_t convert_HBridgeState_to_binary(HBridgeState state);
+
+// Module states -> port word (lane io_index = convert_HBridgeState_to_binary)
+pwm_word_t write_ios_pack(const single_dc_source_t * dc_sources, int num_of_modules);
+
+// Write a port word, storing only the bridges whose lane changed;
+// read_word returns the last word written
+void write_ios_word(pwm_word_t word);
+pwm_word_t write_ios_read_word(void);
+
+// Host stand-in for the timer+DMA: applies the entries of one cycle with
+// tick in [tick_begin, tick_end) to the registers, returns the count written
+uint32_t write_ios_play_pattern(const GpioPatternBuffer* buffer, uint32_t tick_begin, uint32_t tick_end);
+
+// Trace ring (test mode, empty otherwise): words written since init,
+// copied oldest first; dump writes the same words as raw binary
+uint32_t write_ios_trace_total(void);
+uint32_t write_ios_trace_read(pwm_word_t * dst, uint32_t max_words);
+bool write_ios_trace_dump(const char * path);
+
+#endif // WRITE_IOS_H
@@ -9,9 +9,17 @@
 #include "../write_ios/write_ios.h"
 #include "../table_def/table_def.h"
 #include <math.h>
+#include "../../../common/gpio_pattern/gpio_pattern.h"    // MAX_NUM_MODULES
 
+// Ordering changes only when a module leads by more than these margins
+#ifndef SORT_SOC_HYSTERESIS
+#define SORT_SOC_HYSTERESIS 0.01f
+#endif
+#ifndef SORT_VDC_HYSTERESIS
+#define SORT_VDC_HYSTERESIS 0.5f
+#endif
 
-#define MAX_NUM_MODULES 4
+#define SORT_NETWORK_MAX_MODULES 16
 
 
 
@@ -36,6 +44,19 @@ void sort_dc_sources(
     float soc_threshold
 );
 
+// Index sort: order[] holds the previous io order on entry (any
+// permutation), the new one on return. Higher SOC first when the SOC gap
+// exceeds soc_threshold, else higher vdc first; a pair is exchanged only
+// when the gap also clears the hysteresis. The structs are not moved.
+void sort_dc_source_order(
+    const single_dc_source_t * dc_sources,
+    uint8_t * order,
+    int num_of_modules,
+    float soc_threshold,
+    float soc_hysteresis,
+    float vdc_hysteresis
+);
+
 void convert_system_state_to_module_state(
     single_dc_source_t *sorted_dc_sources,
     SwitchingStateResult * switching_sum,
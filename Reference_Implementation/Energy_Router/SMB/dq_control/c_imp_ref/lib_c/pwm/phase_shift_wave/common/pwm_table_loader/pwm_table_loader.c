@@ -1,6 +1,8 @@
 #include "pwm_table_loader.h"
+#include "../../../../misc/static_arena/static_arena.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
 
 float get_table_value(float* table, uint32_t n_init_phase, uint32_t n_mod_index, 
                      uint32_t points_per_cycle, uint32_t phase_idx, 
@@ -27,11 +29,20 @@ PWMTables load_pwm_tables(const char* filename) {
     // Calculate total size for each table
     size_t table_size = tables.n_init_phase * tables.n_mod_index * tables.points_per_cycle;
 
-    // Allocate memory for tables
-    tables.intersection_table = (float*)malloc(table_size * sizeof(float));
-    tables.pwm_value_table = (float*)malloc(table_size * sizeof(float));
-    tables.ref_point_table = (float*)malloc(table_size * sizeof(float));
-    tables.dt_value_table = (float*)malloc(table_size * sizeof(float));
+    // Tables live in the control arena, loaded once at start-up
+    StaticArena* arena = control_arena();
+    tables.intersection_table = STATIC_ARENA_NEW(arena, float, table_size);
+    tables.pwm_value_table = STATIC_ARENA_NEW(arena, float, table_size);
+    tables.ref_point_table = STATIC_ARENA_NEW(arena, float, table_size);
+    tables.dt_value_table = STATIC_ARENA_NEW(arena, float, table_size);
+    if (!tables.intersection_table || !tables.pwm_value_table ||
+        !tables.ref_point_table || !tables.dt_value_table) {
+        fprintf(stderr, "Control arena full loading %s (%zu bytes needed)\n",
+                filename, 4 * table_size * sizeof(float));
+        fclose(file);
+        PWMTables empty = {0};
+        return empty;
+    }
 
     // Read table data
     fread(tables.intersection_table, sizeof(float), table_size, file);
@@ -44,12 +55,8 @@ PWMTables load_pwm_tables(const char* filename) {
 }
 
 void free_pwm_tables(PWMTables* tables) {
+    // Arena memory: only detach, the block returns with static_arena_reset
     if (tables) {
-        free(tables->intersection_table);
-        free(tables->pwm_value_table);
-        free(tables->ref_point_table);
-        free(tables->dt_value_table);
-        
         tables->intersection_table = NULL;
         tables->pwm_value_table = NULL;
         tables->ref_point_table = NULL;
@@ -116,7 +123,7 @@ PWMSingleTable load_single_pwm_table(const char* filename) {
     fread(&table.num_points, sizeof(uint32_t), 1, file);
 
     // Allocate memory for PWM values
-    table.pwm_values = (float*)malloc(table.num_points * sizeof(float));
+    table.pwm_values = STATIC_ARENA_NEW(control_arena(), float, table.num_points);
     if (table.pwm_values) {
         // Read PWM values
         fread(table.pwm_values, sizeof(float), table.num_points, file);
@@ -128,7 +135,6 @@ PWMSingleTable load_single_pwm_table(const char* filename) {
 
 void free_single_pwm_table(PWMSingleTable* table) {
     if (table) {
-        free(table->pwm_values);
         table->pwm_values = NULL;
         table->num_points = 0;
     }
@@ -18,6 +18,9 @@ typedef struct {
     float* pwm_values;
 } PWMSingleTable;
 
+// Tables are placed in control_arena() (start-up only). free_* only detach
+// them: the memory stays in use until static_arena_reset(control_arena()),
+// so every load without a reset in between takes new arena space.
 PWMTables load_pwm_tables(const char* filename);
 void free_pwm_tables(PWMTables* tables);
 
@@ -0,0 +1,171 @@
+#include "mmc_event_timeline.h"
+#include <stddef.h>
+#include <math.h>
+
+// Merge cursor over one module's status changes, in global phase order
+typedef struct {
+    float phase;            // global phase of the pending change
+    uint32_t module;
+    uint32_t next;          // row segment entered by the pending change
+    uint32_t remaining;     // segments left to enter in this cycle
+    int8_t status;          // status after the pending change
+} ModuleStream;
+
+static float wrap_2pi(float phase) {
+    float wrapped = fmodf(phase, (float)(2 * M_PI));
+    if (wrapped < 0) wrapped += (float)(2 * M_PI);
+    return wrapped;
+}
+
+// Effective phase where segment j starts; segment 0 starts at the wrap
+static float segment_start(const float* row, uint32_t j) {
+    return j == 0 ? 0.0f : row[j];
+}
+
+static void heap_push(ModuleStream** heap, uint32_t* size, ModuleStream* s) {
+    uint32_t i = (*size)++;
+    while (i > 0) {
+        uint32_t parent = (i - 1) / 2;
+        if (heap[parent]->phase <= s->phase) break;
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = s;
+}
+
+static ModuleStream* heap_pop(ModuleStream** heap, uint32_t* size) {
+    ModuleStream* top = heap[0];
+    ModuleStream* last = heap[--(*size)];
+    uint32_t i = 0;
+    for (;;) {
+        uint32_t child = 2 * i + 1;
+        if (child >= *size) break;
+        if (child + 1 < *size && heap[child + 1]->phase < heap[child]->phase) child++;
+        if (heap[child]->phase >= last->phase) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    if (*size > 0) heap[i] = last;
+    return top;
+}
+
+void mmc_timeline_init(MMCTimeline* timeline, MMCEvent* buffer, uint32_t capacity, float tolerance) {
+    timeline->events = buffer;
+    timeline->capacity = buffer ? capacity : 0;
+    timeline->num_events = 0;
+    timeline->num_edges = 0;
+    timeline->tolerance = tolerance;
+    timeline->initial_word = 0;
+}
+
+// Load the pending change at segment s->next, skipping segments whose status
+// does not differ from the one before
+static void stream_advance(ModuleStream* s, const PWMTables* tables, const float* row,
+                           float mod_index, float init_phase, uint32_t segments) {
+    while (s->remaining > 0) {
+        uint32_t j = s->next;
+        uint32_t prev = j == 0 ? segments - 1 : j - 1;
+        s->next = j + 1 == segments ? 0 : j + 1;
+        s->remaining--;
+        int8_t status = mmc_pwm_segment_status(tables, s->module, mod_index, j);
+        if (status != mmc_pwm_segment_status(tables, s->module, mod_index, prev)) {
+            float phase = wrap_2pi(segment_start(row, j) - init_phase);
+            // Re-entering the first segment exactly at 0 is the initial state
+            if (phase < s->phase) break;
+            s->status = status;
+            s->phase = phase;
+            return;
+        }
+    }
+    s->phase = INFINITY;
+}
+
+int mmc_build_timeline(MMCPWMContext* ctx, const float* module_init_phases, float mod_index,
+                       MMCTimeline* timeline) {
+    const PWMTables* tables = ctx->tables;
+    const uint32_t segments = tables->points_per_cycle - 1;
+    ModuleStream streams[MMC_MAX_MODULES];
+    ModuleStream* heap[MMC_MAX_MODULES];
+    uint32_t heap_size = 0;
+
+    timeline->num_events = 0;
+    timeline->num_edges = 0;
+    timeline->initial_word = 0;
+
+    for (uint32_t i = 0; i < ctx->num_modules; i++) {
+        const float* row = mmc_pwm_context_row(ctx, i, mod_index, module_init_phases[i]);
+        float init_phase = module_init_phases[i];
+
+        // The segment holding global phase 0 gives the initial status; the
+        // module's changes follow it in global phase order
+        float phase0 = wrap_2pi(init_phase);
+        uint32_t first = 0;
+        while (first + 1 < segments && row[first + 1] <= phase0) first++;
+        int8_t status0 = mmc_pwm_segment_status(tables, i, mod_index, first);
+        timeline->initial_word |= mmc_gpio_code(status0) << (2 * i);
+
+        ModuleStream* s = &streams[i];
+        s->module = i;
+        s->next = first + 1 == segments ? 0 : first + 1;
+        s->remaining = segments;
+        s->phase = 0.0f;
+        stream_advance(s, tables, row, mod_index, init_phase, segments);
+        if (s->phase < INFINITY) heap_push(heap, &heap_size, s);
+    }
+
+    // k-way merge; a change within tolerance of the open event joins it
+    uint64_t word = timeline->initial_word;
+    while (heap_size > 0) {
+        ModuleStream* s = heap_pop(heap, &heap_size);
+        uint64_t mask = 3ull << (2 * s->module);
+        word = (word & ~mask) | (mmc_gpio_code(s->status) << (2 * s->module));
+        timeline->num_edges++;
+
+        MMCEvent* open = timeline->num_events ? &timeline->events[timeline->num_events - 1] : NULL;
+        if (open && s->phase - open->phase <= timeline->tolerance) {
+            open->num_edges++;
+            open->gpio_word = word;
+        } else {
+            if (timeline->num_events == timeline->capacity) return -1;
+            MMCEvent* e = &timeline->events[timeline->num_events++];
+            e->phase = s->phase;
+            e->num_edges = 1;
+            e->gpio_word = word;
+        }
+
+        const float* row = ctx->modules[s->module].intersection;
+        stream_advance(s, tables, row, mod_index, module_init_phases[s->module], segments);
+        if (s->phase < INFINITY) heap_push(heap, &heap_size, s);
+    }
+
+    return (int)timeline->num_events;
+}
+
+uint32_t mmc_timeline_next_event(const MMCTimeline* timeline, float phase) {
+    uint32_t left = 0;
+    uint32_t right = timeline->num_events;
+    while (left < right) {
+        uint32_t mid = (left + right) / 2;
+        if (timeline->events[mid].phase < phase) {
+            left = mid + 1;
+        } else {
+            right = mid;
+        }
+    }
+    return left;
+}
+
+uint64_t mmc_timeline_word_at(const MMCTimeline* timeline, float phase) {
+    // Last event at or before phase
+    uint32_t left = 0;
+    uint32_t right = timeline->num_events;
+    while (left < right) {
+        uint32_t mid = (left + right) / 2;
+        if (timeline->events[mid].phase <= phase) {
+            left = mid + 1;
+        } else {
+            right = mid;
+        }
+    }
+    return left == 0 ? timeline->initial_word : timeline->events[left - 1].gpio_word;
+}
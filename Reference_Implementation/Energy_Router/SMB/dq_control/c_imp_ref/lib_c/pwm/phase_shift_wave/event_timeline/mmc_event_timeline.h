@@ -0,0 +1,66 @@
+#ifndef MMC_EVENT_TIMELINE_H
+#define MMC_EVENT_TIMELINE_H
+
+#include "../phase_shift_xmodule/phase_shift_xmodule.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * One cycle of phase-shifted PWM as a single sorted event list.
+ *
+ * Every module's status changes are k-way merged by global phase; changes
+ * closer than `tolerance` to the first change of a group become one event.
+ * Each event carries the state of all modules after it, so one timer can
+ * drive the whole converter: program the next event's phase, write its word.
+ *
+ * GPIO word: 2 bits per module, module i at bits 2i..2i+1,
+ * 01 = +1, 10 = -1, 00 = 0 (MMC_MAX_MODULES <= 32). This is not the port
+ * format of gpio_pattern / write_ios (one byte lane per H-bridge);
+ * mmc_timeline_port_word in mmc_timeline_port.h converts.
+ */
+
+#define MMC_GPIO_POSITIVE 0x1u
+#define MMC_GPIO_NEGATIVE 0x2u
+
+typedef struct {
+    float phase;            // global phase of the event, [0, 2pi)
+    uint32_t num_edges;     // module status changes merged into it
+    uint64_t gpio_word;     // all modules after the event
+} MMCEvent;
+
+typedef struct {
+    MMCEvent* events;       // caller storage, e.g. from the control arena
+    uint32_t capacity;
+    uint32_t num_events;
+    uint32_t num_edges;     // status changes before coalescing
+    float tolerance;        // rad
+    uint64_t initial_word;  // all modules at phase 0
+} MMCTimeline;
+
+// 2-bit code of a status (-1, 0, 1)
+static inline uint64_t mmc_gpio_code(int8_t status) {
+    return status > 0 ? MMC_GPIO_POSITIVE : (status < 0 ? MMC_GPIO_NEGATIVE : 0u);
+}
+
+void mmc_timeline_init(MMCTimeline* timeline, MMCEvent* buffer, uint32_t capacity, float tolerance);
+
+/**
+ * Rebuild the timeline for the current parameters (rows come from the context cache)
+ *
+ * @return number of events, or -1 if the buffer is too small
+ */
+int mmc_build_timeline(MMCPWMContext* ctx, const float* module_init_phases, float mod_index,
+                       MMCTimeline* timeline);
+
+/**
+ * Index of the first event at or after phase (num_events wraps to event 0
+ * of the next cycle), binary search
+ */
+uint32_t mmc_timeline_next_event(const MMCTimeline* timeline, float phase);
+
+/**
+ * GPIO word in effect at phase
+ */
+uint64_t mmc_timeline_word_at(const MMCTimeline* timeline, float phase);
+
+#endif // MMC_EVENT_TIMELINE_H
@@ -0,0 +1,22 @@
+#include "mmc_timeline_port.h"
+#include <stddef.h>
+
+#define LANE_MASK ((1u << GPIO_PATTERN_LANE_BITS) - 1u)
+
+HBridgeState mmc_timeline_module_state(uint64_t gpio_word, uint32_t module) {
+    uint64_t code = (gpio_word >> (2 * module)) & 0x3u;
+    if (code == MMC_GPIO_POSITIVE) return STATE_POSITIVE;
+    if (code == MMC_GPIO_NEGATIVE) return STATE_NEGATIVE;
+    return STATE_BYPASS;
+}
+
+pwm_word_t mmc_timeline_port_word(uint64_t gpio_word, const uint8_t* io_index, uint32_t num_modules) {
+    pwm_word_t word = 0;
+    if (!io_index || num_modules > MAX_NUM_MODULES) return word;
+    for (uint32_t i = 0; i < num_modules; i++) {
+        if (io_index[i] >= MAX_NUM_MODULES) continue;
+        pwm_word_t lane = convert_HBridgeState_to_binary(mmc_timeline_module_state(gpio_word, i)) & LANE_MASK;
+        word |= lane << (GPIO_PATTERN_LANE_BITS * io_index[i]);
+    }
+    return word;
+}
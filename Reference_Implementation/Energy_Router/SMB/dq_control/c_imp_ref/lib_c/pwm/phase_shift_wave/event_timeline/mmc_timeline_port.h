@@ -0,0 +1,28 @@
+#ifndef MMC_TIMELINE_PORT_H
+#define MMC_TIMELINE_PORT_H
+
+#include "mmc_event_timeline.h"
+#include "../../common/write_ios/write_ios.h"
+
+/**
+ * Timeline words in the port format of gpio_pattern and write_ios.
+ *
+ * A timeline word holds 2 bits of status per module; the port word holds one
+ * byte lane per H-bridge, lane io_index[i] for module i, with the
+ * convert_HBridgeState_to_binary value of its state. Status +1 is
+ * STATE_POSITIVE, -1 STATE_NEGATIVE and 0 STATE_BYPASS, as in
+ * convert_system_state_to_module_state.
+ */
+
+// Bridge state of one module in a timeline word
+HBridgeState mmc_timeline_module_state(uint64_t gpio_word, uint32_t module);
+
+/**
+ * Port word of a timeline word (event gpio_word or initial_word)
+ *
+ * @param io_index bridge lane of each module; lanes >= MAX_NUM_MODULES are skipped
+ * @return 0 (all switches off) if num_modules exceeds MAX_NUM_MODULES
+ */
+pwm_word_t mmc_timeline_port_word(uint64_t gpio_word, const uint8_t* io_index, uint32_t num_modules);
+
+#endif // MMC_TIMELINE_PORT_H
@@ -3,12 +3,53 @@
 #include <float.h>
 #include <math.h>
 
-typedef struct {
-    float current_phase;
-    float init_phase;
-    uint32_t current_index;
-    int8_t current_status;  // -1, 0, or 1
-} ModuleState;
+// Segment of phase in an ascending intersection row: the last j in
+// [0, points - 2] with row[j] <= phase, 0 when phase is below row[0]
+static uint32_t find_segment(const float* row, uint32_t points, float phase) {
+    uint32_t left = 0;
+    uint32_t right = points - 2;
+    while (left < right) {
+        uint32_t mid = (left + right + 1) / 2;
+        if (row[mid] <= phase) {
+            left = mid;
+        } else {
+            right = mid - 1;
+        }
+    }
+    return left;
+}
+
+int8_t mmc_pwm_segment_status(const PWMTables* tables, uint32_t module, float mod_index, uint32_t idx) {
+    float pwm_value = get_table_value(tables->pwm_value_table, 
+                                    tables->n_init_phase,
+                                    tables->n_mod_index,
+                                    tables->points_per_cycle,
+                                    module % tables->n_init_phase,  // Wrap around if needed
+                                    (uint32_t)(mod_index * (tables->n_mod_index - 1)),
+                                    idx);
+
+    // Convert PWM value to status (-1, 0, 1)
+    return (pwm_value > 0.5) ? 1 : ((pwm_value < -0.5) ? -1 : 0);
+}
+
+// Module status and time to its next edge, given its segment
+static int8_t segment_status(const PWMTables* tables, uint32_t module, float mod_index,
+                             const float* row, uint32_t idx, float effective_phase,
+                             float* time_to_next) {
+    *time_to_next = row[idx + 1] - effective_phase;
+    if (*time_to_next < 0) {
+        *time_to_next += 2 * M_PI;  // Wrap around to next cycle
+    }
+    return mmc_pwm_segment_status(tables, module, mod_index, idx);
+}
+
+static float wrap_phase(float phase) {
+    float effective_phase = fmod(phase, 2 * M_PI);
+    if (effective_phase < 0) {
+        effective_phase += 2 * M_PI;
+    }
+    return effective_phase;
+}
 
 MMCPWMStatus get_mmc_pwm_status(const PWMTables* tables, 
                                const float* module_init_phases,
@@ -17,36 +58,18 @@ MMCPWMStatus get_mmc_pwm_status(const PWMTables* tables,
                                float current_phase,
                                float* next_interrupt_time) {
     MMCPWMStatus status = {
-        .module_status = malloc(num_modules * sizeof(int8_t)),
         .num_modules = num_modules
     };
-    
-    if (!status.module_status) {
-        status.num_modules = 0;
-        *next_interrupt_time = 0;
-        return status;
-    }
 
-    // Allocate temporary storage for module states
-    ModuleState* modules = malloc(num_modules * sizeof(ModuleState));
-    if (!modules) {
-        free(status.module_status);
-        status.module_status = NULL;
+    if (num_modules > MMC_MAX_MODULES || tables->points_per_cycle > MMC_MAX_POINTS_PER_CYCLE ||
+        tables->points_per_cycle < 2) {
         status.num_modules = 0;
         *next_interrupt_time = 0;
         return status;
     }
 
-    // Allocate temporary storage for intersection tables
-    float* intersection_table = malloc(tables->points_per_cycle * sizeof(float));
-    if (!intersection_table) {
-        free(modules);
-        free(status.module_status);
-        status.module_status = NULL;
-        status.num_modules = 0;
-        *next_interrupt_time = 0;
-        return status;
-    }
+    // Scratch intersection table on the stack, sized at compile time
+    float intersection_table[MMC_MAX_POINTS_PER_CYCLE];
 
     *next_interrupt_time = FLT_MAX;
 
@@ -55,37 +78,12 @@ MMCPWMStatus get_mmc_pwm_status(const PWMTables* tables,
         // Get intersection table for this module's initial phase
         get_intersection_1d_table(tables, mod_index, module_init_phases[i], intersection_table);
 
-        // Calculate effective phase for this module
-        float effective_phase = fmod(current_phase + module_init_phases[i], 2 * M_PI);
-        if (effective_phase < 0) {
-            effective_phase += 2 * M_PI;
-        }
+        float effective_phase = wrap_phase(current_phase + module_init_phases[i]);
+        uint32_t current_idx = find_segment(intersection_table, tables->points_per_cycle, effective_phase);
 
-        // Find current position in intersection table
-        uint32_t current_idx = 0;
-        while (current_idx < tables->points_per_cycle - 1 && 
-               intersection_table[current_idx] <= effective_phase) {
-            current_idx++;
-        }
-        if (current_idx > 0) current_idx--;
-
-        // Get PWM value for current position
-        float pwm_value = get_table_value(tables->pwm_value_table, 
-                                        tables->n_init_phase,
-                                        tables->n_mod_index,
-                                        tables->points_per_cycle,
-                                        i % tables->n_init_phase,  // Wrap around if needed
-                                        (uint32_t)(mod_index * (tables->n_mod_index - 1)),
-                                        current_idx);
-
-        // Convert PWM value to status (-1, 0, 1)
-        status.module_status[i] = (pwm_value > 0.5) ? 1 : ((pwm_value < -0.5) ? -1 : 0);
-
-        // Calculate time to next intersection
-        float time_to_next = intersection_table[current_idx + 1] - effective_phase;
-        if (time_to_next < 0) {
-            time_to_next += 2 * M_PI;  // Wrap around to next cycle
-        }
+        float time_to_next;
+        status.module_status[i] = segment_status(tables, i, mod_index, intersection_table,
+                                                 current_idx, effective_phase, &time_to_next);
 
         // Update minimum interrupt time
         if (time_to_next < *next_interrupt_time) {
@@ -93,17 +91,90 @@ MMCPWMStatus get_mmc_pwm_status(const PWMTables* tables,
         }
     }
 
-    // Cleanup
-    free(intersection_table);
-    free(modules);
-
     return status;
 }
 
 void free_mmc_pwm_status(MMCPWMStatus* status) {
     if (status) {
-        free(status->module_status);
-        status->module_status = NULL;
         status->num_modules = 0;
     }
-} 
\ No newline at end of file
+}
+
+bool mmc_pwm_context_init(MMCPWMContext* ctx, const PWMTables* tables, uint32_t num_modules) {
+    if (!ctx || !tables || num_modules > MMC_MAX_MODULES ||
+        tables->points_per_cycle > MMC_MAX_POINTS_PER_CYCLE || tables->points_per_cycle < 2) {
+        return false;
+    }
+    ctx->tables = tables;
+    ctx->num_modules = num_modules;
+    ctx->rebuilds = 0;
+    ctx->status.num_modules = num_modules;
+    for (uint32_t i = 0; i < MMC_MAX_MODULES; i++) {
+        ctx->modules[i].valid = false;
+        ctx->modules[i].cursor = 0;
+        ctx->status.module_status[i] = 0;
+    }
+    return true;
+}
+
+void mmc_pwm_context_invalidate(MMCPWMContext* ctx) {
+    if (!ctx) return;
+    for (uint32_t i = 0; i < MMC_MAX_MODULES; i++) {
+        ctx->modules[i].valid = false;
+    }
+}
+
+const float* mmc_pwm_context_row(MMCPWMContext* ctx, uint32_t module_index,
+                                 float mod_index, float init_phase) {
+    MMCModuleCache* module = &ctx->modules[module_index];
+
+    // Rebuild the row only when its parameters moved
+    if (!module->valid || module->mod_index != mod_index || module->init_phase != init_phase) {
+        get_intersection_1d_table(ctx->tables, mod_index, init_phase, module->intersection);
+        module->mod_index = mod_index;
+        module->init_phase = init_phase;
+        module->valid = true;
+        ctx->rebuilds++;
+    }
+    return module->intersection;
+}
+
+const MMCPWMStatus* mmc_pwm_context_update(MMCPWMContext* ctx,
+                                           const float* module_init_phases,
+                                           float mod_index,
+                                           float current_phase,
+                                           float* next_interrupt_time) {
+    const PWMTables* tables = ctx->tables;
+    const uint32_t points = tables->points_per_cycle;
+    *next_interrupt_time = FLT_MAX;
+
+    for (uint32_t i = 0; i < ctx->num_modules; i++) {
+        MMCModuleCache* module = &ctx->modules[i];
+
+        const float* row = mmc_pwm_context_row(ctx, i, mod_index, module_init_phases[i]);
+
+        // Phase moves forward between interrupts: try the cached segment and
+        // the next one before searching
+        float effective_phase = wrap_phase(current_phase + module_init_phases[i]);
+        uint32_t idx = module->cursor;
+        if (idx > points - 2) idx = 0;
+        if (row[idx] <= effective_phase && (idx == points - 2 || effective_phase < row[idx + 1])) {
+            // still in the same segment
+        } else if (idx + 1 <= points - 2 && row[idx + 1] <= effective_phase &&
+                   (idx + 1 == points - 2 || effective_phase < row[idx + 2])) {
+            idx++;
+        } else {
+            idx = find_segment(row, points, effective_phase);
+        }
+        module->cursor = idx;
+
+        float time_to_next;
+        ctx->status.module_status[i] = segment_status(tables, i, mod_index, row, idx,
+                                                      effective_phase, &time_to_next);
+        if (time_to_next < *next_interrupt_time) {
+            *next_interrupt_time = time_to_next;
+        }
+    }
+
+    return &ctx->status;
+}
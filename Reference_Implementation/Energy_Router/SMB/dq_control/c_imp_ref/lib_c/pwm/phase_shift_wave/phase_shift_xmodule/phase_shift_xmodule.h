@@ -3,10 +3,19 @@
 
 #include "../common/pwm_table_loader/pwm_table_loader.h"
 #include <stdint.h>
+#include <stdbool.h>
+
+// Fixed sizes so a status query needs no allocation
+#ifndef MMC_MAX_MODULES
+#define MMC_MAX_MODULES 32
+#endif
+#ifndef MMC_MAX_POINTS_PER_CYCLE
+#define MMC_MAX_POINTS_PER_CYCLE 256
+#endif
 
 typedef struct {
-    int8_t* module_status;  // Array of status values (-1, 0, 1)
-    uint32_t num_modules;   // Number of modules
+    int8_t module_status[MMC_MAX_MODULES];  // Array of status values (-1, 0, 1)
+    uint32_t num_modules;   // Number of modules, 0 on error
 } MMCPWMStatus;
 
 /**
@@ -19,6 +28,8 @@ typedef struct {
  * @param current_phase Current phase angle (0 to 2π)
  * @param next_interrupt_time Output parameter for time until next state change
  * @return MMCPWMStatus structure containing status for all modules
+ *         (num_modules = 0 if num_modules > MMC_MAX_MODULES or the tables
+ *         have more than MMC_MAX_POINTS_PER_CYCLE points)
  */
 MMCPWMStatus get_mmc_pwm_status(const PWMTables* tables,
                                const float* module_init_phases,
@@ -28,10 +39,68 @@ MMCPWMStatus get_mmc_pwm_status(const PWMTables* tables,
                                float* next_interrupt_time);
 
 /**
- * Free resources allocated for MMCPWMStatus
+ * Reset an MMCPWMStatus (no memory is held; kept for API compatibility)
  * 
  * @param status Pointer to MMCPWMStatus structure to free
  */
 void free_mmc_pwm_status(MMCPWMStatus* status);
 
+// Intersection row of one module, valid for (mod_index, init_phase)
+typedef struct {
+    float mod_index;
+    float init_phase;
+    uint32_t cursor;        // segment found at the last update
+    bool valid;
+    float intersection[MMC_MAX_POINTS_PER_CYCLE];
+} MMCModuleCache;
+
+/**
+ * Per-converter state for repeated status queries: cached intersection rows,
+ * a segment cursor per module and the status buffer returned to the caller.
+ * About MMC_MAX_MODULES * MMC_MAX_POINTS_PER_CYCLE * 4 bytes, keep it static.
+ */
+typedef struct {
+    const PWMTables* tables;
+    uint32_t num_modules;
+    uint32_t rebuilds;      // rows recomputed, for diagnostics
+    MMCPWMStatus status;
+    MMCModuleCache modules[MMC_MAX_MODULES];
+} MMCPWMContext;
+
+/**
+ * Bind a context to loaded tables
+ * 
+ * @return false if num_modules or the table size exceed the compile-time limits
+ */
+bool mmc_pwm_context_init(MMCPWMContext* ctx, const PWMTables* tables, uint32_t num_modules);
+
+/**
+ * Force every row to be rebuilt (e.g. after the tables were reloaded in place)
+ */
+void mmc_pwm_context_invalidate(MMCPWMContext* ctx);
+
+/**
+ * Cached intersection row of one module, rebuilt if (mod_index, init_phase) changed
+ */
+const float* mmc_pwm_context_row(MMCPWMContext* ctx, uint32_t module_index,
+                                 float mod_index, float init_phase);
+
+/**
+ * Status (-1, 0, 1) of a module in segment idx of its intersection row
+ */
+int8_t mmc_pwm_segment_status(const PWMTables* tables, uint32_t module, float mod_index, uint32_t idx);
+
+/**
+ * Same result as get_mmc_pwm_status. Rows are rebuilt only when mod_index or
+ * a module's init phase changed; the segment search starts from the previous
+ * one, so a steady-state call is O(modules) and at worst O(modules * log points).
+ * 
+ * @return Pointer to the context's status buffer, valid until the next call
+ */
+const MMCPWMStatus* mmc_pwm_context_update(MMCPWMContext* ctx,
+                                           const float* module_init_phases,
+                                           float mod_index,
+                                           float current_phase,
+                                           float* next_interrupt_time);
+
 #endif // PHASE_SHIFT_XMODULE_H
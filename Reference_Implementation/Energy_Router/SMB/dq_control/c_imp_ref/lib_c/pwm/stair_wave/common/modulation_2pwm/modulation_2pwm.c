@@ -3,10 +3,21 @@
 #include <math.h>
 #include <string.h>
 
-// Forward declarations of static functions
-static void swap_sources(single_dc_source_t *a, single_dc_source_t *b);
-static int partition(single_dc_source_t *dc_sources, int low, int high, float soc_threshold);
-static void quicksort(single_dc_source_t *dc_sources, int low, int high, float soc_threshold);
+// Batcher odd-even merge sort for 16 inputs. Comparators touching an index
+// >= n are skipped, which sorts the first n (as if padded with the lowest
+// rank), so one table serves every module count.
+static const uint8_t sort_network[63][2] = {
+    {0,1}, {2,3}, {0,2}, {1,3}, {1,2}, {4,5}, {6,7}, {4,6}, {5,7}, {5,6}, {0,4}, {2,6}, {2,4},
+    {1,5}, {3,7}, {3,5}, {1,2}, {3,4}, {5,6}, {8,9}, {10,11}, {8,10}, {9,11}, {9,10}, {12,13},
+    {14,15}, {12,14}, {13,15}, {13,14}, {8,12}, {10,14}, {10,12}, {9,13}, {11,15}, {11,13},
+    {9,10}, {11,12}, {13,14}, {0,8}, {4,12}, {4,8}, {2,10}, {6,14}, {6,10}, {2,4}, {6,8},
+    {10,12}, {1,9}, {5,13}, {5,9}, {3,11}, {7,15}, {7,11}, {3,5}, {7,9}, {11,13}, {1,2},
+    {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14}
+};
+
+// Previous order from the io_index of the last update; identity if it is
+// not a permutation (first call, mode change)
+static void previous_order(const single_dc_source_t *dc_sources, uint8_t *order, int num_of_modules);
 
 void init_dc_sources(
     single_dc_source_t * dc_sources,
@@ -53,13 +64,18 @@ void update_dc_sources(
 ) {
     if (!dc_sources || !new_dc_sources) return;
     // Copy back to original array while preserving io_index mapping
-    if(sort_mode == SORT_BY_SOC_BALANCE) {
-        * dc_sources = *new_dc_sources;
-        sort_dc_sources(dc_sources, num_of_modules, 0.05f);
-    }
-    else if(sort_mode == SORT_BY_VDC_HI) {
-        * dc_sources = * new_dc_sources;
-        sort_dc_sources(dc_sources, num_of_modules, 0.0f);
+    if(sort_mode == SORT_BY_SOC_BALANCE || sort_mode == SORT_BY_VDC_HI) {
+        if (num_of_modules <= 0 || num_of_modules > MAX_NUM_MODULES) return;
+        // new_dc_sources is indexed by io_index: sort indices, then gather once
+        uint8_t order[MAX_NUM_MODULES];
+        previous_order(dc_sources, order, num_of_modules);
+        sort_dc_source_order(new_dc_sources, order, num_of_modules,
+                             sort_mode == SORT_BY_SOC_BALANCE ? 0.05f : 0.0f,
+                             SORT_SOC_HYSTERESIS, SORT_VDC_HYSTERESIS);
+        for (int i = 0; i < num_of_modules; i++) {
+            dc_sources[i] = new_dc_sources[order[i]];
+            dc_sources[i].io_index = order[i];
+        }
     }
     else if (sort_mode == SORT_BY_PREV_ORDER) { 
         for (int i = 0; i < num_of_modules; i++) {
@@ -79,40 +95,52 @@ void update_dc_sources(
 
 }
 
-static void swap_sources(single_dc_source_t *a, single_dc_source_t *b) {
-    single_dc_source_t temp = *a;
-    *a = *b;
-    *b = temp;
+static void previous_order(const single_dc_source_t *dc_sources, uint8_t *order, int num_of_modules) {
+    uint32_t seen = 0;
+    for (int i = 0; i < num_of_modules; i++) {
+        int io_index = dc_sources[i].io_index;
+        if (io_index < 0 || io_index >= num_of_modules || (seen & (1u << io_index))) {
+            for (int k = 0; k < num_of_modules; k++) order[k] = (uint8_t)k;
+            return;
+        }
+        seen |= 1u << io_index;
+        order[i] = (uint8_t)io_index;
+    }
 }
 
-static int partition(single_dc_source_t *dc_sources, int low, int high, float soc_threshold) {
-    single_dc_source_t pivot = dc_sources[high];
-    int i = low - 1;
-
-    for (int j = low; j < high; j++) {
-        bool should_swap = false;
-        float soc_diff = dc_sources[j].soc - pivot.soc;
-        
-        if (fabsf(soc_diff) > soc_threshold) {
-            should_swap = (soc_diff > 0);  // Higher SOC first
-        } else {
-            should_swap = (dc_sources[j].vdc > pivot.vdc);  // Higher voltage first
-        }
-        
-        if (should_swap) {
-            i++;
-            swap_sources(&dc_sources[i], &dc_sources[j]);
-        }
+// true when b should move ahead of a
+static inline bool source_leads(const single_dc_source_t *b, const single_dc_source_t *a,
+                                float soc_threshold, float soc_hysteresis, float vdc_hysteresis) {
+    float soc_diff = b->soc - a->soc;
+    if (fabsf(soc_diff) > soc_threshold) {
+        return soc_diff > soc_threshold + soc_hysteresis;  // Higher SOC first
     }
-    swap_sources(&dc_sources[i + 1], &dc_sources[high]);
-    return i + 1;
+    return b->vdc - a->vdc > vdc_hysteresis;                // Higher voltage first
 }
 
-static void quicksort(single_dc_source_t *dc_sources, int low, int high, float soc_threshold) {
-    if (low < high) {
-        int pi = partition(dc_sources, low, high, soc_threshold);
-        quicksort(dc_sources, low, pi - 1, soc_threshold);
-        quicksort(dc_sources, pi + 1, high, soc_threshold);
+void sort_dc_source_order(
+    const single_dc_source_t * dc_sources,
+    uint8_t * order,
+    int num_of_modules,
+    float soc_threshold,
+    float soc_hysteresis,
+    float vdc_hysteresis
+) {
+    if (!dc_sources || !order || num_of_modules <= 1 || num_of_modules > SORT_NETWORK_MAX_MODULES) {
+        return;
+    }
+
+    // Fixed comparator sequence: same cost every call, no recursion
+    for (int k = 0; k < 63; k++) {
+        int i = sort_network[k][0];
+        int j = sort_network[k][1];
+        if (j >= num_of_modules) continue;
+        if (source_leads(&dc_sources[order[j]], &dc_sources[order[i]],
+                         soc_threshold, soc_hysteresis, vdc_hysteresis)) {
+            uint8_t t = order[i];
+            order[i] = order[j];
+            order[j] = t;
+        }
     }
 }
 
@@ -124,8 +152,15 @@ void sort_dc_sources(
     if (!dc_sources || num_of_modules <= 0 || num_of_modules > MAX_NUM_MODULES) {
         return;
     }
-    
-    quicksort(dc_sources, 0, num_of_modules - 1, soc_threshold);
+
+    // In place: sort positions, then permute once
+    uint8_t order[MAX_NUM_MODULES];
+    for (int i = 0; i < num_of_modules; i++) order[i] = (uint8_t)i;
+    sort_dc_source_order(dc_sources, order, num_of_modules, soc_threshold, 0.0f, 0.0f);
+
+    single_dc_source_t sorted[MAX_NUM_MODULES];
+    for (int i = 0; i < num_of_modules; i++) sorted[i] = dc_sources[order[i]];
+    memcpy(dc_sources, sorted, sizeof(single_dc_source_t) * (size_t)num_of_modules);
 }
 
 void convert_system_state_to_module_state(
@@ -6,17 +6,21 @@
 #include <stdint.h>
 #include "../../four_modules/lookup_table_1d/dyn_stair_wave_table.h"
 #include "../../four_modules/interp_table_5d/interp_table_5d.h"
-#include "../write_ios/write_ios.h"
 #include "../table_def/table_def.h"
 #include <math.h>
+#include "../../../common/write_ios/write_ios.h"    // MAX_NUM_MODULES via gpio_pattern.h
 
+// Ordering changes only when a module leads by more than these margins
+#ifndef SORT_SOC_HYSTERESIS
+#define SORT_SOC_HYSTERESIS 0.01f
+#endif
+#ifndef SORT_VDC_HYSTERESIS
+#define SORT_VDC_HYSTERESIS 0.5f
+#endif
 
-#define MAX_NUM_MODULES 4
+#define SORT_NETWORK_MAX_MODULES 16
 
 
-
-#include "../write_ios/write_ios.h"
-
 void init_dc_sources(
     single_dc_source_t * dc_sources,
     const int num_of_modules
@@ -36,6 +40,19 @@ void sort_dc_sources(
     float soc_threshold
 );
 
+// Index sort: order[] holds the previous io order on entry (any
+// permutation), the new one on return. Higher SOC first when the SOC gap
+// exceeds soc_threshold, else higher vdc first; a pair is exchanged only
+// when the gap also clears the hysteresis. The structs are not moved.
+void sort_dc_source_order(
+    const single_dc_source_t * dc_sources,
+    uint8_t * order,
+    int num_of_modules,
+    float soc_threshold,
+    float soc_hysteresis,
+    float vdc_hysteresis
+);
+
 void convert_system_state_to_module_state(
     single_dc_source_t *sorted_dc_sources,
     SwitchingStateResult * switching_sum,
@@ -44,6 +61,6 @@ void convert_system_state_to_module_state(
 
 uint8_t optimize_sort_strategy_based_on_interruption_mode(uint8_t interruption_mode);
 
-uint32_t convert_HBridgeState_to_binary(HBridgeState state);
+// convert_HBridgeState_to_binary is declared in write_ios.h
 
 #endif // MODULATION_2PWM_H
\ No newline at end of file
@@ -10,6 +10,10 @@
 #define NUM_1D_TABLE_POINTS 18
 #define STAIR_WAVE_ANGLE_SAFE_MARGIN 0.00001f
 
+// Phase accumulator: one electrical cycle is 2^32 counts, wrap-around is free
+#define STAIR_PHASE_PER_RAD 683565275.5764316f      // 2^32 / (2 pi)
+#define STAIR_RAD_PER_PHASE 1.4629180792671596e-9f  // 2 pi / 2^32
+
 #define SORT_BY_PREV_ORDER 0    // based on previous order
 #define SORT_BY_CURRENT_ORDER 1 // based on the seq of array 
 #define SORT_BY_SOC_BALANCE 2   // based on soc balance
@@ -43,10 +47,18 @@ typedef struct {
     float* angles;
     int*  sum_index;
     float * sum_value;
+    uint32_t* edges; // angles in phase counts, the last (2 pi) wraps to 0
     int num_points;
 } DynamicTable1D;
 typedef DynamicTable1D StairWaveTable;
 
+// Position in the stair wave: segment index and counts left to its end edge
+typedef struct {
+    uint32_t phase;
+    uint32_t remaining;
+    int index;
+} StairWaveCursor;
+
 // (total) lookup results for switching angles
 typedef struct {
     float theta[NUM_DC_SOURCES];
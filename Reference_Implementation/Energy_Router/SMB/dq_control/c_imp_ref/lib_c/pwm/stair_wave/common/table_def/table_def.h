@@ -0,0 +1,7 @@
+#ifndef TABLE_DEF_H
+#define TABLE_DEF_H
+
+// Types of the stair-wave tree (module, 1D table, lookup results)
+#include "../stariw_base_type/stairw_base_type.h"
+
+#endif // TABLE_DEF_H
@@ -0,0 +1,190 @@
+#include "adaptive_switching_table.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int adaptive_table_lookup_sorted(const AdaptiveSwitchingTable* table,
+                                 const float* c_sorted, float m, float* theta) {
+    if (!table || !c_sorted || !theta) return 0;
+
+    int flags = 0;
+    float x[ADAPTIVE_DIMS];
+    for (int d = 0; d < ADAPTIVE_DIMS; d++) {
+        float v = (d < NUM_DC_SOURCES) ? c_sorted[d] : m;
+        int bit = (d < NUM_DC_SOURCES) ? ADAPTIVE_CLAMPED_C : ADAPTIVE_CLAMPED_M;
+        if (v < table->lower[d]) { v = table->lower[d]; flags |= bit; }
+        if (v > table->upper[d]) { v = table->upper[d]; flags |= bit; }
+        x[d] = v;
+    }
+
+    // Descend to the leaf, tracking its cell
+    float lo[ADAPTIVE_DIMS], hi[ADAPTIVE_DIMS];
+    memcpy(lo, table->lower, sizeof(lo));
+    memcpy(hi, table->upper, sizeof(hi));
+    const AdaptiveNode* node = &table->nodes[0];
+    while (node->axis >= 0) {
+        int a = node->axis;
+        if (x[a] < node->split) {
+            hi[a] = node->split;
+            node = &table->nodes[node->child];
+        } else {
+            lo[a] = node->split;
+            node = &table->nodes[node->child + 1];
+        }
+    }
+    const uint32_t* corners = table->leaf_corners[node->child];
+
+    float frac[ADAPTIVE_DIMS];
+    int order[ADAPTIVE_DIMS];
+    for (int d = 0; d < ADAPTIVE_DIMS; d++) {
+        frac[d] = (x[d] - lo[d]) / (hi[d] - lo[d]);
+        int j = d;
+        while (j > 0 && frac[order[j - 1]] < frac[d]) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = d;
+    }
+
+    // Kuhn simplex: corners reached by setting axis bits in descending-fraction order
+    AngleQuad acc = {{0.0f}};
+    unsigned mask = 0;
+    float w = 1.0f - frac[order[0]];
+    for (int k = 0; k <= ADAPTIVE_DIMS; k++) {
+        if (k > 0) {
+            mask |= 1u << order[k - 1];
+            w = (k < ADAPTIVE_DIMS) ? frac[order[k - 1]] - frac[order[k]] : frac[order[k - 1]];
+        }
+        const AngleQuad* v = &table->vertices[corners[mask]];
+#ifdef ANGLE_QUAD_VECTOR
+        acc.vec += v->vec * w;
+#else
+        for (int i = 0; i < NUM_DC_SOURCES; i++) acc.theta[i] += w * v->theta[i];
+#endif
+    }
+    memcpy(theta, acc.theta, NUM_DC_SOURCES * sizeof(float));
+    return flags;
+}
+
+int adaptive_table_lookup(const AdaptiveSwitchingTable* table,
+                          const float* c, float m, float* theta) {
+    if (!table || !c || !theta) return 0;
+
+    float c_sorted[NUM_DC_SOURCES];
+    int perm[NUM_DC_SOURCES];
+    for (int i = 0; i < NUM_DC_SOURCES; i++) {
+        int j = i;
+        while (j > 0 && c_sorted[j - 1] < c[i]) {
+            c_sorted[j] = c_sorted[j - 1];
+            perm[j] = perm[j - 1];
+            j--;
+        }
+        c_sorted[j] = c[i];
+        perm[j] = i;
+    }
+    float theta_sorted[NUM_DC_SOURCES];
+    int flags = adaptive_table_lookup_sorted(table, c_sorted, m, theta_sorted);
+    for (int k = 0; k < NUM_DC_SOURCES; k++) {
+        theta[perm[k]] = theta_sorted[k];
+    }
+    return flags;
+}
+
+size_t adaptive_table_memory(const AdaptiveSwitchingTable* table) {
+    if (!table) return 0;
+    return table->num_nodes * sizeof(AdaptiveNode) +
+           table->num_leaves * sizeof(table->leaf_corners[0]) +
+           table->num_vertices * sizeof(AngleQuad);
+}
+
+int save_adaptive_switching_table(const AdaptiveSwitchingTable* table, const char* filename) {
+    if (!table || !filename) return -1;
+
+    FILE* fp = fopen(filename, "wb");
+    if (!fp) {
+        fprintf(stderr, "Error: Could not open file '%s'\n", filename);
+        return -1;
+    }
+    uint32_t header[6] = {ADAPTIVE_TABLE_MAGIC, ADAPTIVE_TABLE_VERSION, table->num_nodes,
+                          table->num_leaves, table->num_vertices, table->max_depth};
+    int ok = fwrite(header, sizeof(uint32_t), 6, fp) == 6 &&
+             fwrite(table->lower, sizeof(float), ADAPTIVE_DIMS, fp) == ADAPTIVE_DIMS &&
+             fwrite(table->upper, sizeof(float), ADAPTIVE_DIMS, fp) == ADAPTIVE_DIMS &&
+             fwrite(table->nodes, sizeof(AdaptiveNode), table->num_nodes, fp) == table->num_nodes &&
+             fwrite(table->leaf_corners, sizeof(table->leaf_corners[0]), table->num_leaves, fp) == table->num_leaves &&
+             fwrite(table->vertices, sizeof(AngleQuad), table->num_vertices, fp) == table->num_vertices;
+    if (fclose(fp) != 0) ok = 0;
+    if (!ok) {
+        fprintf(stderr, "Error: Failed to write adaptive table '%s'\n", filename);
+        return -1;
+    }
+    return 0;
+}
+
+AdaptiveSwitchingTable* load_adaptive_switching_table(const char* filename) {
+    if (!filename) return NULL;
+
+    FILE* fp = fopen(filename, "rb");
+    if (!fp) {
+        fprintf(stderr, "Error: Could not open file '%s'\n", filename);
+        return NULL;
+    }
+    uint32_t header[6];
+    if (fread(header, sizeof(uint32_t), 6, fp) != 6 ||
+        header[0] != ADAPTIVE_TABLE_MAGIC || header[1] != ADAPTIVE_TABLE_VERSION ||
+        header[2] == 0 || header[3] == 0 || header[4] == 0) {
+        fprintf(stderr, "Error: '%s' is not a version %d adaptive table\n", filename, ADAPTIVE_TABLE_VERSION);
+        fclose(fp);
+        return NULL;
+    }
+
+    AdaptiveSwitchingTable* table = (AdaptiveSwitchingTable*)calloc(1, sizeof(AdaptiveSwitchingTable));
+    if (!table) {
+        fclose(fp);
+        return NULL;
+    }
+    table->num_nodes = header[2];
+    table->num_leaves = header[3];
+    table->num_vertices = header[4];
+    table->max_depth = header[5];
+    table->nodes = (AdaptiveNode*)malloc(table->num_nodes * sizeof(AdaptiveNode));
+    table->leaf_corners = malloc(table->num_leaves * sizeof(table->leaf_corners[0]));
+    table->vertices = (AngleQuad*)aligned_alloc(16, table->num_vertices * sizeof(AngleQuad));
+
+    int ok = table->nodes && table->leaf_corners && table->vertices &&
+             fread(table->lower, sizeof(float), ADAPTIVE_DIMS, fp) == ADAPTIVE_DIMS &&
+             fread(table->upper, sizeof(float), ADAPTIVE_DIMS, fp) == ADAPTIVE_DIMS &&
+             fread(table->nodes, sizeof(AdaptiveNode), table->num_nodes, fp) == table->num_nodes &&
+             fread(table->leaf_corners, sizeof(table->leaf_corners[0]), table->num_leaves, fp) == table->num_leaves &&
+             fread(table->vertices, sizeof(AngleQuad), table->num_vertices, fp) == table->num_vertices;
+    fclose(fp);
+
+    // Reject indices that would leave the arrays
+    for (uint32_t n = 0; ok && n < table->num_nodes; n++) {
+        const AdaptiveNode* node = &table->nodes[n];
+        if (node->axis >= ADAPTIVE_DIMS ||
+            (node->axis >= 0 && (node->child <= (int32_t)n || (uint32_t)node->child + 1 >= table->num_nodes)) ||
+            (node->axis < 0 && (node->child < 0 || (uint32_t)node->child >= table->num_leaves))) {
+            ok = 0;
+        }
+    }
+    for (uint32_t l = 0; ok && l < table->num_leaves; l++) {
+        for (int k = 0; k < ADAPTIVE_CORNERS; k++) {
+            if (table->leaf_corners[l][k] >= table->num_vertices) ok = 0;
+        }
+    }
+    if (!ok) {
+        fprintf(stderr, "Error: Failed to read adaptive table '%s'\n", filename);
+        free_adaptive_switching_table(table);
+        return NULL;
+    }
+    return table;
+}
+
+void free_adaptive_switching_table(AdaptiveSwitchingTable* table) {
+    if (!table) return;
+    free(table->nodes);
+    free(table->leaf_corners);
+    free(table->vertices);
+    free(table);
+}
@@ -0,0 +1,88 @@
+#ifndef ADAPTIVE_SWITCHING_TABLE_H
+#define ADAPTIVE_SWITCHING_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "load_switching_angles_table_5d.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Adaptive-resolution four-module switching table.
+//
+// The domain (c1 >= c2 >= c3 >= c4, m) is a box split by a k-d tree: every
+// internal node halves its cell along one axis, leaves carry the 32 corner
+// angle quads of their cell as indices into a shared vertex pool. The builder
+// (adaptive_table_builder.c) splits cells whose interpolation error exceeds a
+// tolerance, so resolution follows the curvature of the solution instead of
+// a uniform grid. Lookup descends log2(leaves) nodes and interpolates the
+// leaf with Kuhn simplices (6 corners).
+//
+// Cells lying completely outside the ordered region are never refined; their
+// corners still hold the sorted solution, so any c order interpolates.
+
+#define ADAPTIVE_DIMS 5                         // c1..c4 (sorted descending), m
+#define ADAPTIVE_CORNERS (1 << ADAPTIVE_DIMS)   // bit d set: upper side of axis d
+
+#define ADAPTIVE_TABLE_MAGIC 0x54504441u        // "ADPT"
+#define ADAPTIVE_TABLE_VERSION 1
+
+typedef struct {
+    int32_t axis;       // split axis, -1 for a leaf
+    float split;        // split coordinate
+    int32_t child;      // internal: lower child (upper = child + 1); leaf: leaf index
+} AdaptiveNode;
+
+typedef struct {
+    float lower[ADAPTIVE_DIMS];
+    float upper[ADAPTIVE_DIMS];
+    AdaptiveNode* nodes;
+    uint32_t num_nodes;
+    uint32_t (*leaf_corners)[ADAPTIVE_CORNERS];    // vertex index per leaf corner
+    uint32_t num_leaves;
+    AngleQuad* vertices;                            // angles for sorted c
+    uint32_t num_vertices;
+    uint32_t max_depth;
+} AdaptiveSwitchingTable;
+
+// Bits of the lookup return value: input clamped to the domain
+#define ADAPTIVE_CLAMPED_C 0x1
+#define ADAPTIVE_CLAMPED_M 0x2
+
+// Angles for c (any module order) and m. theta[i] belongs to module i.
+// Returns 0, or ADAPTIVE_CLAMPED_* bits when the input was outside the domain.
+int adaptive_table_lookup(const AdaptiveSwitchingTable* table,
+                          const float* c, float m, float* theta);
+
+// Sorted lookup: c_sorted descending, theta in the same order
+int adaptive_table_lookup_sorted(const AdaptiveSwitchingTable* table,
+                                 const float* c_sorted, float m, float* theta);
+
+size_t adaptive_table_memory(const AdaptiveSwitchingTable* table);
+
+int save_adaptive_switching_table(const AdaptiveSwitchingTable* table, const char* filename);
+AdaptiveSwitchingTable* load_adaptive_switching_table(const char* filename);
+void free_adaptive_switching_table(AdaptiveSwitchingTable* table);
+
+// Builder, needs she_solver
+typedef struct {
+    float c_lower, c_upper;         // shared by c1..c4
+    float m_lower, m_upper;
+    int c_divisions;                // initial uniform cells per axis, powers of two
+    int m_divisions;
+    float angle_tolerance;          // rad, max |interpolated - solved| at a cell center
+    uint32_t max_leaves;
+    uint32_t max_depth;             // halvings per axis, <= 14
+} AdaptiveTableConfig;
+
+// Wider range than the uniform 5D table: c in [0.90, 1.10], m in [0.50, 1.00]
+void adaptive_table_default_config(AdaptiveTableConfig* config);
+
+AdaptiveSwitchingTable* build_adaptive_switching_table(const AdaptiveTableConfig* config);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ADAPTIVE_SWITCHING_TABLE_H
@@ -0,0 +1,477 @@
+#include "adaptive_switching_table.h"
+#include "she_solver.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Builder state. Coordinates are integer units: axis d spans [0, 1 << max_depth].
+typedef struct {
+    uint16_t u[ADAPTIVE_DIMS];
+} VertexKey;
+
+typedef struct {
+    AdaptiveTableConfig cfg;
+    uint32_t units;
+    float lower[ADAPTIVE_DIMS];
+    float upper[ADAPTIVE_DIMS];
+
+    AdaptiveNode* nodes;
+    uint32_t num_nodes, cap_nodes;
+
+    uint32_t (*leaf_corners)[ADAPTIVE_CORNERS];
+    uint16_t (*leaf_lo)[ADAPTIVE_DIMS];
+    uint16_t (*leaf_hi)[ADAPTIVE_DIMS];
+    uint32_t* leaf_node;
+    uint32_t num_leaves, cap_leaves;
+
+    AngleQuad* vertices;
+    uint32_t num_vertices, cap_vertices;
+
+    VertexKey* hash_keys;           // solved points, c units sorted descending
+    uint32_t* hash_values;          // vertex index + 1, 0: empty
+    uint32_t hash_cap;
+
+    uint32_t solves;
+    uint32_t failed_solves;
+} Builder;
+
+static int grow(void** ptr, uint32_t* cap, uint32_t need, size_t elem) {
+    if (need <= *cap) return 0;
+    uint32_t new_cap = *cap ? *cap : 64;
+    while (new_cap < need) new_cap *= 2;
+    void* p = realloc(*ptr, (size_t)new_cap * elem);
+    if (!p) return -1;
+    *ptr = p;
+    *cap = new_cap;
+    return 0;
+}
+
+static float unit_coord(const Builder* b, int d, uint32_t u) {
+    return b->lower[d] + (b->upper[d] - b->lower[d]) * (float)u / (float)b->units;
+}
+
+static uint32_t hash_key(const VertexKey* k) {
+    uint64_t h = 1469598103934665603ull;
+    for (int d = 0; d < ADAPTIVE_DIMS; d++) {
+        h = (h ^ k->u[d]) * 1099511628211ull;
+    }
+    return (uint32_t)(h ^ (h >> 32));
+}
+
+static int hash_insert(Builder* b, const VertexKey* key, uint32_t value);
+
+// The builder keeps the old table until both new arrays are allocated
+static int hash_grow(Builder* b) {
+    uint32_t old_cap = b->hash_cap;
+    uint32_t new_cap = old_cap ? old_cap * 2 : 1024;
+    VertexKey* new_keys = (VertexKey*)calloc(new_cap, sizeof(VertexKey));
+    uint32_t* new_values = (uint32_t*)calloc(new_cap, sizeof(uint32_t));
+    if (!new_keys || !new_values) {
+        free(new_keys);
+        free(new_values);
+        return -1;
+    }
+    VertexKey* old_keys = b->hash_keys;
+    uint32_t* old_values = b->hash_values;
+    b->hash_cap = new_cap;
+    b->hash_keys = new_keys;
+    b->hash_values = new_values;
+    for (uint32_t i = 0; i < old_cap; i++) {
+        if (old_values[i]) hash_insert(b, &old_keys[i], old_values[i] - 1);
+    }
+    free(old_keys);
+    free(old_values);
+    return 0;
+}
+
+static int hash_insert(Builder* b, const VertexKey* key, uint32_t value) {
+    uint32_t i = hash_key(key) & (b->hash_cap - 1);
+    while (b->hash_values[i]) i = (i + 1) & (b->hash_cap - 1);
+    b->hash_keys[i] = *key;
+    b->hash_values[i] = value + 1;
+    return 0;
+}
+
+static int64_t hash_find(const Builder* b, const VertexKey* key) {
+    uint32_t i = hash_key(key) & (b->hash_cap - 1);
+    while (b->hash_values[i]) {
+        if (memcmp(&b->hash_keys[i], key, sizeof(*key)) == 0) return b->hash_values[i] - 1;
+        i = (i + 1) & (b->hash_cap - 1);
+    }
+    return -1;
+}
+
+// Candidate order for cold starts: V1 held beats V1 missed, then lower THD
+static int better_solution(int status, const SheSolveStats* st, int best_status, const SheSolveStats* best) {
+    int failed = status == SHE_SOLVE_FAILED;
+    int best_failed = best_status == SHE_SOLVE_FAILED;
+    if (failed != best_failed) return !failed;
+    return st->thd < best->thd;
+}
+
+// Solved angles at a point (sorted c), warm-started from `warm` when given.
+// Points are cached, so shared corners and samples are solved once.
+static int64_t solve_point(Builder* b, const uint16_t* u, const float* warm) {
+    VertexKey key;
+    memcpy(key.u, u, sizeof(key.u));
+    for (int i = 1; i < NUM_DC_SOURCES; i++) {
+        for (int j = i; j > 0 && key.u[j - 1] < key.u[j]; j--) {
+            uint16_t t = key.u[j]; key.u[j] = key.u[j - 1]; key.u[j - 1] = t;
+        }
+    }
+    int64_t found = hash_find(b, &key);
+    if (found >= 0) return found;
+
+    float c[NUM_DC_SOURCES];
+    for (int i = 0; i < NUM_DC_SOURCES; i++) c[i] = unit_coord(b, i, key.u[i]);
+    float m = unit_coord(b, NUM_DC_SOURCES, key.u[NUM_DC_SOURCES]);
+
+    float theta[NUM_DC_SOURCES];
+    SheSolveStats st;
+    int status = SHE_SOLVE_FAILED;
+    if (warm) {
+        memcpy(theta, warm, sizeof(theta));
+        status = she_solve(c, m, theta, 4 * SHE_MAX_ITERATIONS, &st);
+        b->solves++;
+    }
+    if (status == SHE_SOLVE_FAILED) {
+        // Cold starts: spread angles of norm_4module.py and nearest-level staircase
+        float starts[2][NUM_DC_SOURCES];
+        for (int k = 0; k < NUM_DC_SOURCES; k++) {
+            starts[0][k] = (float)((k * M_PI / 3.0 + M_PI / 12.0) / NUM_DC_SOURCES);
+            starts[1][k] = asinf(fminf(1.0f, (k + 0.5f) / (NUM_DC_SOURCES * m)));
+        }
+        int have = warm != NULL;
+        for (int s = 0; s < 2; s++) {
+            float trial[NUM_DC_SOURCES];
+            SheSolveStats trial_st;
+            memcpy(trial, starts[s], sizeof(trial));
+            int trial_status = she_solve(c, m, trial, 4 * SHE_MAX_ITERATIONS, &trial_st);
+            b->solves++;
+            if (!have || better_solution(trial_status, &trial_st, status, &st)) {
+                memcpy(theta, trial, sizeof(theta));
+                st = trial_st;
+                status = trial_status;
+                have = 1;
+            }
+        }
+    }
+    if (status == SHE_SOLVE_FAILED) b->failed_solves++;
+
+    if (grow((void**)&b->vertices, &b->cap_vertices, b->num_vertices + 1, sizeof(AngleQuad)) != 0) return -1;
+    if ((b->num_vertices + 1) * 2 > b->hash_cap && hash_grow(b) != 0) return -1;
+    uint32_t index = b->num_vertices++;
+    memset(&b->vertices[index], 0, sizeof(AngleQuad));
+    memcpy(b->vertices[index].theta, theta, sizeof(theta));
+    hash_insert(b, &key, index);
+    return index;
+}
+
+// Kuhn simplex interpolation inside a leaf at unit coordinates x
+static void interp_leaf(const Builder* b, uint32_t leaf, const float* x, float* theta) {
+    float frac[ADAPTIVE_DIMS];
+    int order[ADAPTIVE_DIMS];
+    for (int d = 0; d < ADAPTIVE_DIMS; d++) {
+        float lo = b->leaf_lo[leaf][d], hi = b->leaf_hi[leaf][d];
+        frac[d] = (x[d] - lo) / (hi - lo);
+        int j = d;
+        while (j > 0 && frac[order[j - 1]] < frac[d]) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = d;
+    }
+    float acc[NUM_DC_SOURCES] = {0.0f};
+    unsigned mask = 0;
+    float w = 1.0f - frac[order[0]];
+    for (int k = 0; k <= ADAPTIVE_DIMS; k++) {
+        if (k > 0) {
+            mask |= 1u << order[k - 1];
+            w = (k < ADAPTIVE_DIMS) ? frac[order[k - 1]] - frac[order[k]] : frac[order[k - 1]];
+        }
+        const float* v = b->vertices[b->leaf_corners[leaf][mask]].theta;
+        for (int i = 0; i < NUM_DC_SOURCES; i++) acc[i] += w * v[i];
+    }
+    memcpy(theta, acc, sizeof(acc));
+}
+
+// Solution at a unit point of a leaf, warm-started from the leaf interpolation
+static int sample_leaf(Builder* b, uint32_t leaf, const uint16_t* u, float* theta) {
+    float x[ADAPTIVE_DIMS], warm[NUM_DC_SOURCES];
+    for (int d = 0; d < ADAPTIVE_DIMS; d++) x[d] = u[d];
+    interp_leaf(b, leaf, x, warm);
+    int64_t v = solve_point(b, u, warm);
+    if (v < 0) return -1;
+    memcpy(theta, b->vertices[v].theta, NUM_DC_SOURCES * sizeof(float));
+    return 0;
+}
+
+// Split a leaf in half along axis d; the lower half keeps the leaf index
+static int split_leaf(Builder* b, uint32_t leaf, int d) {
+    uint16_t mid = (uint16_t)((b->leaf_lo[leaf][d] + b->leaf_hi[leaf][d]) / 2);
+    uint32_t corners[2][ADAPTIVE_CORNERS];
+    for (int half = 0; half < 2; half++) {
+        for (int mask = 0; mask < ADAPTIVE_CORNERS; mask++) {
+            uint16_t u[ADAPTIVE_DIMS];
+            for (int a = 0; a < ADAPTIVE_DIMS; a++) {
+                int upper = (mask >> a) & 1;
+                u[a] = upper ? b->leaf_hi[leaf][a] : b->leaf_lo[leaf][a];
+            }
+            int upper_d = (mask >> d) & 1;
+            u[d] = half == 0 ? (upper_d ? mid : b->leaf_lo[leaf][d])
+                             : (upper_d ? b->leaf_hi[leaf][d] : mid);
+            int outside = (half == 0 && upper_d) || (half == 1 && !upper_d);
+            if (!outside) {
+                corners[half][mask] = b->leaf_corners[leaf][mask];
+                continue;
+            }
+            float x[ADAPTIVE_DIMS], warm[NUM_DC_SOURCES];
+            for (int a = 0; a < ADAPTIVE_DIMS; a++) x[a] = u[a];
+            interp_leaf(b, leaf, x, warm);
+            int64_t v = solve_point(b, u, warm);
+            if (v < 0) return -1;
+            corners[half][mask] = (uint32_t)v;
+        }
+    }
+
+    if (grow((void**)&b->nodes, &b->cap_nodes, b->num_nodes + 2, sizeof(AdaptiveNode)) != 0 ||
+        grow((void**)&b->leaf_corners, &b->cap_leaves, b->num_leaves + 1, sizeof(b->leaf_corners[0])) != 0) {
+        return -1;
+    }
+    // Companion arrays share cap_leaves
+    void* p1 = realloc(b->leaf_lo, (size_t)b->cap_leaves * sizeof(b->leaf_lo[0]));
+    if (p1) b->leaf_lo = p1;
+    void* p2 = realloc(b->leaf_hi, (size_t)b->cap_leaves * sizeof(b->leaf_hi[0]));
+    if (p2) b->leaf_hi = p2;
+    void* p3 = realloc(b->leaf_node, (size_t)b->cap_leaves * sizeof(uint32_t));
+    if (p3) b->leaf_node = p3;
+    if (!p1 || !p2 || !p3) return -1;
+
+    uint32_t node = b->leaf_node[leaf];
+    uint32_t child = b->num_nodes;
+    uint32_t right = b->num_leaves++;
+    b->num_nodes += 2;
+    b->nodes[node].axis = d;
+    b->nodes[node].split = unit_coord(b, d, mid);
+    b->nodes[node].child = (int32_t)child;
+    b->nodes[child] = (AdaptiveNode){-1, 0.0f, (int32_t)leaf};
+    b->nodes[child + 1] = (AdaptiveNode){-1, 0.0f, (int32_t)right};
+
+    memcpy(b->leaf_lo[right], b->leaf_lo[leaf], sizeof(b->leaf_lo[0]));
+    memcpy(b->leaf_hi[right], b->leaf_hi[leaf], sizeof(b->leaf_hi[0]));
+    b->leaf_hi[leaf][d] = mid;
+    b->leaf_lo[right][d] = mid;
+    memcpy(b->leaf_corners[leaf], corners[0], sizeof(corners[0]));
+    memcpy(b->leaf_corners[right], corners[1], sizeof(corners[1]));
+    b->leaf_node[leaf] = child;
+    b->leaf_node[right] = child + 1;
+    return 0;
+}
+
+// Some point of the cell satisfies c1 >= c2 >= c3 >= c4
+static int intersects_ordered(const Builder* b, uint32_t leaf) {
+    uint16_t x = b->leaf_lo[leaf][NUM_DC_SOURCES - 1];
+    for (int d = NUM_DC_SOURCES - 2; d >= 0; d--) {
+        if (b->leaf_lo[leaf][d] > x) x = b->leaf_lo[leaf][d];
+        if (x > b->leaf_hi[leaf][d]) return 0;
+    }
+    return 1;
+}
+
+static float max_abs_diff(const float* a, const float* b) {
+    float e = 0.0f;
+    for (int i = 0; i < NUM_DC_SOURCES; i++) e = fmaxf(e, fabsf(a[i] - b[i]));
+    return e;
+}
+
+// Check a leaf; split it along the axis of largest curvature when the
+// interpolation error at its center is above tolerance. Returns 1 on split.
+static int refine_leaf(Builder* b, uint32_t leaf) {
+    if (!intersects_ordered(b, leaf)) return 0;
+
+    uint16_t center[ADAPTIVE_DIMS];
+    int splittable = 0;
+    for (int d = 0; d < ADAPTIVE_DIMS; d++) {
+        center[d] = (uint16_t)((b->leaf_lo[leaf][d] + b->leaf_hi[leaf][d]) / 2);
+        if (b->leaf_hi[leaf][d] - b->leaf_lo[leaf][d] >= 2) splittable = 1;
+    }
+    if (!splittable) return 0;
+
+    float x[ADAPTIVE_DIMS], interp[NUM_DC_SOURCES], solved[NUM_DC_SOURCES];
+    for (int d = 0; d < ADAPTIVE_DIMS; d++) x[d] = center[d];
+    interp_leaf(b, leaf, x, interp);
+    if (sample_leaf(b, leaf, center, solved) != 0) return -1;
+    if (max_abs_diff(interp, solved) <= b->cfg.angle_tolerance) return 0;
+
+    // Second difference across the cell along each axis, at the face centers
+    int best_axis = -1;
+    float best_curvature = -1.0f;
+    for (int d = 0; d < ADAPTIVE_DIMS; d++) {
+        if (b->leaf_hi[leaf][d] - b->leaf_lo[leaf][d] < 2) continue;
+        uint16_t u_lo[ADAPTIVE_DIMS], u_hi[ADAPTIVE_DIMS];
+        memcpy(u_lo, center, sizeof(u_lo));
+        memcpy(u_hi, center, sizeof(u_hi));
+        u_lo[d] = b->leaf_lo[leaf][d];
+        u_hi[d] = b->leaf_hi[leaf][d];
+        float f_lo[NUM_DC_SOURCES], f_hi[NUM_DC_SOURCES];
+        if (sample_leaf(b, leaf, u_lo, f_lo) != 0 || sample_leaf(b, leaf, u_hi, f_hi) != 0) return -1;
+        float curvature = 0.0f;
+        for (int i = 0; i < NUM_DC_SOURCES; i++) {
+            curvature = fmaxf(curvature, fabsf(f_lo[i] + f_hi[i] - 2.0f * solved[i]));
+        }
+        if (curvature > best_curvature) {
+            best_curvature = curvature;
+            best_axis = d;
+        }
+    }
+    if (best_axis < 0) return 0;
+    return split_leaf(b, leaf, best_axis) == 0 ? 1 : -1;
+}
+
+static void free_builder(Builder* b) {
+    free(b->nodes);
+    free(b->leaf_corners);
+    free(b->leaf_lo);
+    free(b->leaf_hi);
+    free(b->leaf_node);
+    free(b->vertices);
+    free(b->hash_keys);
+    free(b->hash_values);
+}
+
+void adaptive_table_default_config(AdaptiveTableConfig* config) {
+    if (!config) return;
+    config->c_lower = 0.90f;
+    config->c_upper = 1.10f;
+    config->m_lower = 0.50f;
+    config->m_upper = 1.00f;
+    config->c_divisions = 2;
+    config->m_divisions = 4;
+    config->angle_tolerance = 0.005f;
+    config->max_leaves = 4000;
+    config->max_depth = 6;
+}
+
+AdaptiveSwitchingTable* build_adaptive_switching_table(const AdaptiveTableConfig* config) {
+    if (!config || config->max_depth < 1 || config->max_depth > 14 ||
+        config->c_divisions < 1 || config->m_divisions < 1 ||
+        (uint32_t)config->c_divisions > (1u << config->max_depth) ||
+        (uint32_t)config->m_divisions > (1u << config->max_depth)) {
+        fprintf(stderr, "Error: Invalid adaptive table configuration\n");
+        return NULL;
+    }
+
+    Builder b;
+    memset(&b, 0, sizeof(b));
+    b.cfg = *config;
+    b.units = 1u << config->max_depth;
+    for (int d = 0; d < ADAPTIVE_DIMS; d++) {
+        b.lower[d] = d < NUM_DC_SOURCES ? config->c_lower : config->m_lower;
+        b.upper[d] = d < NUM_DC_SOURCES ? config->c_upper : config->m_upper;
+    }
+
+    int ok = grow((void**)&b.nodes, &b.cap_nodes, 1, sizeof(AdaptiveNode)) == 0 &&
+             grow((void**)&b.leaf_corners, &b.cap_leaves, 1, sizeof(b.leaf_corners[0])) == 0 &&
+             hash_grow(&b) == 0;
+    if (ok) {
+        b.leaf_lo = malloc((size_t)b.cap_leaves * sizeof(b.leaf_lo[0]));
+        b.leaf_hi = malloc((size_t)b.cap_leaves * sizeof(b.leaf_hi[0]));
+        b.leaf_node = malloc((size_t)b.cap_leaves * sizeof(uint32_t));
+        ok = b.leaf_lo && b.leaf_hi && b.leaf_node;
+    }
+
+    // Root cell covers the domain
+    if (ok) {
+        b.num_nodes = 1;
+        b.num_leaves = 1;
+        b.nodes[0] = (AdaptiveNode){-1, 0.0f, 0};
+        b.leaf_node[0] = 0;
+        for (int d = 0; d < ADAPTIVE_DIMS; d++) {
+            b.leaf_lo[0][d] = 0;
+            b.leaf_hi[0][d] = (uint16_t)b.units;
+        }
+        for (int mask = 0; ok && mask < ADAPTIVE_CORNERS; mask++) {
+            uint16_t u[ADAPTIVE_DIMS];
+            for (int d = 0; d < ADAPTIVE_DIMS; d++) u[d] = ((mask >> d) & 1) ? (uint16_t)b.units : 0;
+            int64_t v = solve_point(&b, u, NULL);
+            ok = v >= 0;
+            if (ok) b.leaf_corners[0][mask] = (uint32_t)v;
+        }
+    }
+
+    // Uniform initial cells
+    for (int d = 0; ok && d < ADAPTIVE_DIMS; d++) {
+        uint32_t width = b.units / (uint32_t)(d < NUM_DC_SOURCES ? config->c_divisions : config->m_divisions);
+        int again = 1;
+        while (ok && again) {
+            again = 0;
+            uint32_t count = b.num_leaves;
+            for (uint32_t l = 0; ok && l < count; l++) {
+                if ((uint32_t)(b.leaf_hi[l][d] - b.leaf_lo[l][d]) > width) {
+                    ok = split_leaf(&b, l, d) == 0;
+                    again = 1;
+                }
+            }
+        }
+    }
+
+    // Breadth-first refinement: leaves are checked in creation order
+    for (uint32_t l = 0; ok && l < b.num_leaves && b.num_leaves < config->max_leaves; l++) {
+        // A split leaf keeps its index as the lower half: check it again
+        int r;
+        while ((r = refine_leaf(&b, l)) == 1 && b.num_leaves < config->max_leaves) {}
+        ok = r >= 0;
+    }
+    if (!ok) {
+        fprintf(stderr, "Error: Adaptive table build ran out of memory\n");
+        free_builder(&b);
+        return NULL;
+    }
+
+    // Keep only the vertices referenced by leaves
+    uint32_t* remap = (uint32_t*)malloc(b.num_vertices * sizeof(uint32_t));
+    AdaptiveSwitchingTable* table = (AdaptiveSwitchingTable*)calloc(1, sizeof(AdaptiveSwitchingTable));
+    if (!remap || !table) {
+        free(remap);
+        free(table);
+        free_builder(&b);
+        return NULL;
+    }
+    for (uint32_t v = 0; v < b.num_vertices; v++) remap[v] = UINT32_MAX;
+    uint32_t used = 0;
+    for (uint32_t l = 0; l < b.num_leaves; l++) {
+        for (int k = 0; k < ADAPTIVE_CORNERS; k++) {
+            uint32_t v = b.leaf_corners[l][k];
+            if (remap[v] == UINT32_MAX) remap[v] = used++;
+            b.leaf_corners[l][k] = remap[v];
+        }
+    }
+    table->vertices = (AngleQuad*)aligned_alloc(16, (size_t)used * sizeof(AngleQuad));
+    if (!table->vertices) {
+        free(remap);
+        free(table);
+        free_builder(&b);
+        return NULL;
+    }
+    for (uint32_t v = 0; v < b.num_vertices; v++) {
+        if (remap[v] != UINT32_MAX) table->vertices[remap[v]] = b.vertices[v];
+    }
+    free(remap);
+
+    memcpy(table->lower, b.lower, sizeof(table->lower));
+    memcpy(table->upper, b.upper, sizeof(table->upper));
+    table->nodes = b.nodes;
+    table->num_nodes = b.num_nodes;
+    table->leaf_corners = b.leaf_corners;
+    table->num_leaves = b.num_leaves;
+    table->num_vertices = used;
+    table->max_depth = config->max_depth;
+    b.nodes = NULL;
+    b.leaf_corners = NULL;
+
+    printf("Adaptive table: %u leaves, %u vertices, %u solves (%u missed V1)\n",
+           table->num_leaves, table->num_vertices, b.solves, b.failed_solves);
+    free_builder(&b);
+    return table;
+}
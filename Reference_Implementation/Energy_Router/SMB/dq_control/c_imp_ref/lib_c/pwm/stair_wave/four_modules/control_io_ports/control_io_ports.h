@@ -9,7 +9,6 @@
 #include <stdbool.h>
 
 #define NUM_OF_MODULES 4
-#define MAX_NUM_MODULES 4
 
 typedef struct {
     SwitchingAnglesTable* switching_angles_5d;  // static 5D lookup table
@@ -0,0 +1,22 @@
+#!/bin/bash
+
+echo "Building native switching-angle table generator..."
+
+SRC=..
+gcc -O2 -c $SRC/she_solver/she_solver.c -I$SRC/load_table_5d -o she_solver.o && \
+gcc -O2 -c $SRC/load_table_5d/load_switching_angles_table_5d.c -I$SRC/load_table_5d -o load_switching_angles_table_5d.o && \
+gcc -O2 -c $SRC/../n_modules/sym_table/sym_switching_table.c -I$SRC/load_table_5d -o sym_switching_table.o && \
+g++ -O2 -std=c++17 -pthread -o table_generator table_generator.cpp \
+    she_solver.o load_switching_angles_table_5d.o sym_switching_table.o \
+    -I$SRC/load_table_5d \
+    -I$SRC/she_solver \
+    -I$SRC/../n_modules/sym_table \
+    -lm
+
+if [ $? -eq 0 ]; then
+    rm -f she_solver.o load_switching_angles_table_5d.o sym_switching_table.o
+    echo "Build successful! Example: ./table_generator --reference ../load_table_5d/switching_angles_table.bin --out /tmp/switching_angles_table.bin"
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -1,7 +1,49 @@
+import struct
 import numpy as np
 import pandas as pd
 from norm_4module import calculate_switching_angles_4modules
 
+# Version 2 table file, see SwitchingTableFileHeader in
+# load_table_5d/load_switching_angles_table_5d.h
+TABLE_MAGIC = 0x54415753   # "SWAT"
+TABLE_VERSION = 2
+TABLE_LAYOUT_QUAD_F32 = 1
+TABLE_HEADER_SIZE = 64
+TABLE_SECTION_ALIGN = 64
+
+def _align_section(offset):
+    return (offset + TABLE_SECTION_ALIGN - 1) & ~(TABLE_SECTION_ALIGN - 1)
+
+def _fnv1a_32(data):
+    h = 2166136261
+    for b in data:
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+def write_table_v2(filename, ci_options, m_options, theta_tables, thd_table, v1_error_table):
+    n_ci, n_m, n_dc = len(ci_options), len(m_options), len(theta_tables)
+    axes_offset = _align_section(TABLE_HEADER_SIZE)
+    angles_offset = _align_section(axes_offset + (n_dc * n_ci + n_m) * 4)
+    stats_offset = _align_section(angles_offset + thd_table.size * n_dc * 4)
+    file_size = _align_section(stats_offset + 2 * thd_table.size * 4)
+
+    body = bytearray(file_size - TABLE_HEADER_SIZE)
+    def put(offset, array):
+        raw = np.ascontiguousarray(array, dtype='<f4').tobytes()
+        body[offset - TABLE_HEADER_SIZE:offset - TABLE_HEADER_SIZE + len(raw)] = raw
+    # Every ci axis uses the same grid
+    put(axes_offset, np.concatenate([np.tile(ci_options, n_dc), m_options]))
+    # One angle quad per grid point: [c1][c2][c3][c4][m][dc]
+    put(angles_offset, np.stack(theta_tables, axis=-1))
+    put(stats_offset, np.concatenate([thd_table.ravel(), v1_error_table.ravel()]))
+
+    header = struct.pack('<IIIIiiiIQQQQ', TABLE_MAGIC, TABLE_VERSION, TABLE_HEADER_SIZE,
+                         TABLE_LAYOUT_QUAD_F32, n_ci, n_m, n_dc, _fnv1a_32(body),
+                         axes_offset, angles_offset, stats_offset, file_size)
+    with open(filename, 'wb') as f:
+        f.write(header)
+        f.write(body)
+
 def generate_5d_lookup_table():
     # Define parameter ranges
     ci_options = np.array([0.95, 0.975, 1.0, 1.025, 1.05])
@@ -58,20 +100,10 @@ def generate_5d_lookup_table():
                         thd_table[i1,i2,i3,i4,im] = thd
                         v1_error_table[i1,i2,i3,i4,im] = 100*(V1-V1_desired)/V1_desired
     
-    # Save tables in binary format
-    with open('switching_angles_table.bin', 'wb') as f:
-        # Write dimensions first
-        np.array([len(ci_options), len(m_options)], dtype=np.int32).tofile(f)
-        # Write the parameter values
-        ci_options.astype(np.float32).tofile(f)
-        m_options.astype(np.float32).tofile(f)
-        # Write the lookup tables
-        theta1_table.astype(np.float32).tofile(f)
-        theta2_table.astype(np.float32).tofile(f)
-        theta3_table.astype(np.float32).tofile(f)
-        theta4_table.astype(np.float32).tofile(f)
-        thd_table.astype(np.float32).tofile(f)
-        v1_error_table.astype(np.float32).tofile(f)
+    # Save tables in the version 2 runtime format (load_table_5d)
+    write_table_v2('switching_angles_table.bin', ci_options, m_options,
+                   [theta1_table, theta2_table, theta3_table, theta4_table],
+                   thd_table, v1_error_table)
     
     print("\nTable dimensions:")
     print(f"ci values: {ci_options}")
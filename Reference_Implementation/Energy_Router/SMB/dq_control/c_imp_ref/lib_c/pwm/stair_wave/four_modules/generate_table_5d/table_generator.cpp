@@ -0,0 +1,344 @@
+// Native switching-angle table generator.
+//
+// Solves the per-grid-point SHE problem of norm_4module.py with the
+// Levenberg-Marquardt solver in she_solver/ on all cores and writes the
+// runtime formats directly:
+//   - four modules on the compiled 5 x 6 grid and its bounds: version 2
+//     dense table
+//     (load_table_5d, memory-mapped at startup)
+//   - any other module count / grid: symmetric table (n_modules/sym_table)
+//
+// Only ordered ratio tuples c1 >= ... >= cN are solved (the optimizer sorts
+// ci anyway). Each worker claims one tuple and sweeps m, warm-starting every
+// point from the previous m and from an already finished neighbour tuple.
+//
+// Usage:
+//   table_generator [--modules N] [--c-points P] [--c-range lo hi]
+//                   [--m-points M] [--m-range lo hi] [--threads T]
+//                   [--reference table.bin] --out file
+//
+// --out is required, so a run inside this directory cannot overwrite the
+// checked-in switching_angles_table.bin by accident.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+#include "load_switching_angles_table_5d.h"
+#include "sym_switching_table.h"
+#include "she_solver.h"
+
+struct GeneratorConfig
+{
+    int   num_modules  = NUM_DC_SOURCES;
+    int   num_c_points = N_POINTS_PER_CI;
+    float c_lower      = CI_MIN;
+    float c_upper      = CI_MAX;
+    int   num_m_points = N_MOD_INDEX;
+    float m_lower      = MOD_INDEX_MIN;
+    float m_upper      = MOD_INDEX_MAX;
+    unsigned num_threads = 0;   // 0: all cores
+    std::string out_file;       // required
+    std::string reference_file;
+};
+
+struct PointResult
+{
+    int   status = SHE_SOLVE_FAILED;
+    float thd = 0.0f;
+    float v1_error = 0.0f;
+    float max_low_order = 0.0f;
+};
+
+// Better candidate: constraints met beats relaxed beats failed; then lower
+// low-order content for relaxed points, lower THD otherwise
+static bool better(int status, const SheSolveStats& st, int best_status, const SheSolveStats& best)
+{
+    auto rank = [](int s) { return s == SHE_SOLVE_OK ? 0 : (s == SHE_SOLVE_RELAXED ? 1 : 2); };
+    if (rank(status) != rank(best_status)) return rank(status) < rank(best_status);
+    if (status == SHE_SOLVE_RELAXED && fabsf(st.max_low_order - best.max_low_order) > 1e-4f)
+        return st.max_low_order < best.max_low_order;
+    return st.thd < best.thd;
+}
+
+struct TableGenerator
+{
+    GeneratorConfig cfg;
+    SymSwitchingTable* table = nullptr;
+    std::vector<int> tuples;            // num_sorted * N, in rank order
+    std::vector<PointResult> results;   // [rank][m]
+    std::vector<std::atomic<int>> done; // per rank, set once all m are solved
+
+    explicit TableGenerator(const GeneratorConfig& config) : cfg(config), done(0) {}
+    ~TableGenerator() { free_sym_switching_table(table); }
+
+    bool init()
+    {
+        std::vector<float> c_values(cfg.num_c_points), m_values(cfg.num_m_points);
+        for (int i = 0; i < cfg.num_c_points; i++)
+            c_values[i] = cfg.c_lower + (cfg.c_upper - cfg.c_lower) * i / (cfg.num_c_points - 1);
+        for (int i = 0; i < cfg.num_m_points; i++)
+            m_values[i] = cfg.m_lower + (cfg.m_upper - cfg.m_lower) * i / (cfg.num_m_points - 1);
+
+        table = create_sym_switching_table(cfg.num_modules, c_values.data(), cfg.num_c_points,
+                                           m_values.data(), cfg.num_m_points);
+        if (!table) return false;
+
+        const int n = cfg.num_modules;
+        std::vector<int> idx(n, 0);
+        do {
+            tuples.insert(tuples.end(), idx.begin(), idx.end());
+        } while (sym_table_next_tuple(table, idx.data()));
+
+        results.assign(table->num_sorted * cfg.num_m_points, PointResult());
+        done = std::vector<std::atomic<int>>(table->num_sorted);
+        for (auto& d : done) d.store(0);
+        return true;
+    }
+
+    // Finished tuple one index step below `rank`, or -1
+    long finished_neighbour(size_t rank) const
+    {
+        const int n = cfg.num_modules;
+        std::vector<int> idx(tuples.begin() + rank * n, tuples.begin() + (rank + 1) * n);
+        for (int k = n - 1; k >= 0; k--) {
+            if (idx[k] == 0) continue;
+            idx[k]--;
+            bool ordered = (k == n - 1) || idx[k] >= idx[k + 1];
+            if (ordered) {
+                size_t r = sym_table_rank(table, idx.data());
+                if (done[r].load(std::memory_order_acquire)) return long(r);
+            }
+            idx[k]++;
+        }
+        return -1;
+    }
+
+    void solve_tuple(size_t rank)
+    {
+        const int n = cfg.num_modules;
+        float c[SHE_MAX_MODULES];
+        for (int k = 0; k < n; k++) c[k] = table->c_values[tuples[rank * n + k]];
+
+        long neighbour = finished_neighbour(rank);
+        std::vector<float> previous;
+
+        // Sweep m downwards: high modulation indices have the tightest angles
+        for (int im = cfg.num_m_points - 1; im >= 0; im--) {
+            const float m = table->m_values[im];
+            std::vector<std::vector<float>> starts;
+            if (!previous.empty()) starts.push_back(previous);
+            if (neighbour >= 0) {
+                const float* a = sym_table_entry(table, size_t(neighbour), im);
+                starts.emplace_back(a, a + n);
+            }
+            // Cold start of norm_4module.py: spread angles
+            std::vector<float> spread(n);
+            for (int k = 0; k < n; k++) spread[k] = float((k * M_PI / 3.0 + M_PI / 12.0) / n);
+            starts.push_back(spread);
+            // Nearest-level staircase of a sine with peak n * m
+            std::vector<float> staircase(n);
+            for (int k = 0; k < n; k++) staircase[k] = asinf(std::min(1.0f, (k + 0.5f) / (n * m)));
+            starts.push_back(staircase);
+
+            int best_status = SHE_SOLVE_FAILED + 1;     // worse than any result
+            SheSolveStats best = {};
+            std::vector<float> best_theta;
+            for (auto& s : starts) {
+                std::vector<float> theta = s;
+                SheSolveStats st;
+                int status = she_solve_n(c, n, m, theta.data(), 4 * SHE_MAX_ITERATIONS, &st);
+                if (best_theta.empty() || better(status, st, best_status, best)) {
+                    best_status = status;
+                    best = st;
+                    best_theta = theta;
+                }
+                if (status == SHE_SOLVE_OK && &s == &starts.front() && !previous.empty()) break;
+            }
+
+            memcpy(sym_table_entry(table, rank, im), best_theta.data(), n * sizeof(float));
+            PointResult& res = results[rank * cfg.num_m_points + im];
+            res.status = best_status;
+            res.thd = best.thd;
+            res.v1_error = best.v1_error;
+            res.max_low_order = best.max_low_order;
+            previous = best_theta;
+        }
+        done[rank].store(1, std::memory_order_release);
+    }
+
+    void generate()
+    {
+        unsigned num_threads = cfg.num_threads;
+        if (num_threads == 0) num_threads = std::max(1u, std::thread::hardware_concurrency());
+        num_threads = unsigned(std::min<size_t>(num_threads, table->num_sorted));
+
+        std::atomic<size_t> next(0);
+        auto worker = [&]() {
+            for (size_t r = next.fetch_add(1); r < table->num_sorted; r = next.fetch_add(1))
+                solve_tuple(r);
+        };
+        std::vector<std::thread> workers;
+        for (unsigned t = 1; t < num_threads; t++) workers.emplace_back(worker);
+        worker();
+        for (auto& w : workers) w.join();
+    }
+
+    // Dense four-module table in the version 2 runtime format
+    bool write_dense(const char* filename) const
+    {
+        typedef AngleQuad AngleGrid[N_POINTS_PER_CI][N_POINTS_PER_CI][N_POINTS_PER_CI][N_MOD_INDEX];
+        std::vector<AngleGrid> angles(N_POINTS_PER_CI);
+        SwitchingAnglesStats* stats = new SwitchingAnglesStats();
+        SwitchingAnglesTable dense = {};
+        dense.angles = angles.data();
+        dense.stats = stats;
+        memcpy(dense.c1_values, table->c_values, sizeof(dense.c1_values));
+        memcpy(dense.c2_values, table->c_values, sizeof(dense.c2_values));
+        memcpy(dense.c3_values, table->c_values, sizeof(dense.c3_values));
+        memcpy(dense.c4_values, table->c_values, sizeof(dense.c4_values));
+        memcpy(dense.m_values, table->m_values, sizeof(dense.m_values));
+
+        int idx[NUM_DC_SOURCES];
+        for (idx[0] = 0; idx[0] < N_POINTS_PER_CI; idx[0]++)
+        for (idx[1] = 0; idx[1] < N_POINTS_PER_CI; idx[1]++)
+        for (idx[2] = 0; idx[2] < N_POINTS_PER_CI; idx[2]++)
+        for (idx[3] = 0; idx[3] < N_POINTS_PER_CI; idx[3]++) {
+            // Angles belong to the sorted ratios, whatever the tuple order
+            int sorted[NUM_DC_SOURCES];
+            memcpy(sorted, idx, sizeof(sorted));
+            std::sort(sorted, sorted + NUM_DC_SOURCES, [](int a, int b) { return a > b; });
+            size_t rank = sym_table_rank(table, sorted);
+            for (int im = 0; im < N_MOD_INDEX; im++) {
+                memcpy(dense.angles[idx[0]][idx[1]][idx[2]][idx[3]][im].theta,
+                       sym_table_entry(table, rank, im), NUM_DC_SOURCES * sizeof(float));
+                const PointResult& res = results[rank * N_MOD_INDEX + im];
+                stats->thd[idx[0]][idx[1]][idx[2]][idx[3]][im] = res.thd;
+                stats->v1_error[idx[0]][idx[1]][idx[2]][idx[3]][im] = res.v1_error;
+            }
+        }
+        int ret = save_switching_angles_table_5d(&dense, filename);
+        delete stats;
+        return ret == 0;
+    }
+
+    // The dense lookup clamps c and m to the compiled bounds, so a grid over
+    // any other range is written as a symmetric table
+    bool compiled_grid() const
+    {
+        return cfg.num_modules == NUM_DC_SOURCES &&
+               cfg.num_c_points == N_POINTS_PER_CI && cfg.c_lower == CI_MIN && cfg.c_upper == CI_MAX &&
+               cfg.num_m_points == N_MOD_INDEX && cfg.m_lower == MOD_INDEX_MIN && cfg.m_upper == MOD_INDEX_MAX;
+    }
+
+    bool write(const char* filename) const
+    {
+        if (compiled_grid()) {
+            printf("Writing dense version 2 table to %s\n", filename);
+            return write_dense(filename);
+        }
+        printf("Writing symmetric table to %s\n", filename);
+        return save_sym_switching_table(table, filename) == 0;
+    }
+
+    void summary(const char* label, const std::vector<PointResult>& res) const
+    {
+        int ok = 0, relaxed = 0, failed = 0;
+        double thd = 0.0, low = 0.0, v1 = 0.0;
+        for (const auto& r : res) {
+            ok += r.status == SHE_SOLVE_OK;
+            relaxed += r.status == SHE_SOLVE_RELAXED;
+            failed += r.status == SHE_SOLVE_FAILED;
+            thd += r.thd;
+            low += r.max_low_order;
+            v1 = std::max(v1, double(fabsf(r.v1_error)));
+        }
+        printf("%-10s ok %5d  relaxed %5d  failed %4d | mean THD %6.3f%%  mean |V3..| %6.3f%%  max |V1 err| %.3f%%\n",
+               label, ok, relaxed, failed, thd / res.size(), low / res.size(), v1);
+    }
+
+    // Evaluate a four-module runtime table at the same ordered nodes
+    void compare_reference(const char* filename) const
+    {
+        if (!compiled_grid()) {
+            printf("Reference comparison needs the compiled four-module grid\n");
+            return;
+        }
+        SwitchingAnglesTable* ref = load_switching_angles_table_5d_from(filename);
+        if (!ref) return;
+        std::vector<PointResult> res(results.size());
+        for (size_t rank = 0; rank < table->num_sorted; rank++) {
+            const int* idx = &tuples[rank * NUM_DC_SOURCES];
+            float c[NUM_DC_SOURCES];
+            for (int k = 0; k < NUM_DC_SOURCES; k++) c[k] = ref->c1_values[idx[k]];
+            for (int im = 0; im < N_MOD_INDEX; im++) {
+                SheSolveStats st;
+                she_evaluate(c, ref->m_values[im], ref->angles[idx[0]][idx[1]][idx[2]][idx[3]][im].theta, &st);
+                PointResult& r = res[rank * N_MOD_INDEX + im];
+                r.thd = st.thd;
+                r.v1_error = st.v1_error;
+                r.max_low_order = st.max_low_order;
+                r.status = fabsf(st.v1_error) > SHE_V1_TOLERANCE ? SHE_SOLVE_FAILED
+                         : (st.max_low_order <= SHE_LOW_ORDER_LIMIT ? SHE_SOLVE_OK : SHE_SOLVE_RELAXED);
+            }
+        }
+        summary("reference", res);
+        free_switching_angles_table_5d(ref);
+    }
+};
+
+static bool parse_args(int argc, char** argv, GeneratorConfig& cfg)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        auto need = [&](int k) { return i + k < argc; };
+        if (a == "--modules" && need(1)) cfg.num_modules = atoi(argv[++i]);
+        else if (a == "--c-points" && need(1)) cfg.num_c_points = atoi(argv[++i]);
+        else if (a == "--m-points" && need(1)) cfg.num_m_points = atoi(argv[++i]);
+        else if (a == "--c-range" && need(2)) { cfg.c_lower = float(atof(argv[++i])); cfg.c_upper = float(atof(argv[++i])); }
+        else if (a == "--m-range" && need(2)) { cfg.m_lower = float(atof(argv[++i])); cfg.m_upper = float(atof(argv[++i])); }
+        else if (a == "--threads" && need(1)) cfg.num_threads = unsigned(atoi(argv[++i]));
+        else if (a == "--out" && need(1)) cfg.out_file = argv[++i];
+        else if (a == "--reference" && need(1)) cfg.reference_file = argv[++i];
+        else {
+            fprintf(stderr, "Unknown or incomplete argument '%s'\n", a.c_str());
+            return false;
+        }
+    }
+    if (cfg.out_file.empty()) {
+        fprintf(stderr, "Missing --out file\n");
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    GeneratorConfig cfg;
+    if (!parse_args(argc, argv, cfg)) return 1;
+
+    TableGenerator gen(cfg);
+    if (!gen.init()) return 1;
+
+    unsigned threads = cfg.num_threads ? cfg.num_threads : std::max(1u, std::thread::hardware_concurrency());
+    printf("Generating N=%d, %d ratio points [%.3f, %.3f], %d m points [%.3f, %.3f]: %zu ordered tuples, %u threads\n",
+           cfg.num_modules, cfg.num_c_points, cfg.c_lower, cfg.c_upper,
+           cfg.num_m_points, cfg.m_lower, cfg.m_upper, gen.table->num_sorted, threads);
+
+    auto t0 = std::chrono::steady_clock::now();
+    gen.generate();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    printf("Solved %zu points in %.2f s\n", gen.results.size(), secs);
+
+    gen.summary("generated", gen.results);
+    if (!cfg.reference_file.empty()) gen.compare_reference(cfg.reference_file.c_str());
+
+    return gen.write(cfg.out_file.c_str()) ? 0 : 1;
+}
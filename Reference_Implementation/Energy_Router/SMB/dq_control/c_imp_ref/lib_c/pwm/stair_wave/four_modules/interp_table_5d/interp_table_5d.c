@@ -33,6 +33,90 @@ static void find_index_and_factor(float value, const float* array, int size,
               (array[*lower_idx + 1] - array[*lower_idx]);
 }
 
+// Angle quad (all DC sources) at one grid corner
+static inline const AngleQuad* corner_angles(const SwitchingAnglesTable* table, const int* c) {
+    return &table->angles[c[0]][c[1]][c[2]][c[3]][c[4]];
+}
+
+// acc += w * q over the whole quad; a single vector multiply-add when the
+// compiler supports vector extensions
+static inline void quad_fma(AngleQuad* acc, const AngleQuad* q, float w) {
+#ifdef ANGLE_QUAD_VECTOR
+    acc->vec += q->vec * w;
+#else
+    for (int dc = 0; dc < NUM_DC_SOURCES; dc++) {
+        acc->theta[dc] += w * q->theta[dc];
+    }
+#endif
+}
+
+static inline void quad_store(float* theta, const AngleQuad* q) {
+    memcpy(theta, q->theta, NUM_DC_SOURCES * sizeof(float));
+}
+
+// First-order Taylor step from the lower corner: one independent delta per
+// axis, no cross terms. Kept for comparison with the exact schemes.
+static void interp_taylor(const SwitchingAnglesTable* table, const int* idx,
+                          const float* frac, float* theta) {
+    const AngleQuad* base = corner_angles(table, idx);
+    AngleQuad acc = *base;
+    float w_base = 0.0f;
+    for (int d = 0; d < INTERP_5D_DIMS; d++) {
+        int c[INTERP_5D_DIMS] = {idx[0], idx[1], idx[2], idx[3], idx[4]};
+        c[d]++;
+        quad_fma(&acc, corner_angles(table, c), frac[d]);
+        w_base -= frac[d];
+    }
+    quad_fma(&acc, base, w_base);
+    quad_store(theta, &acc);
+}
+
+// Kuhn (simplex) interpolation. The unit 5-cube is split into 5! simplices by
+// the ordering of the fractional parts; the point is a convex combination of
+// the 6 vertices reached by stepping from the lower corner along the axes in
+// descending-fraction order. Exact at every grid node, continuous across cells.
+static void interp_simplex(const SwitchingAnglesTable* table, const int* idx,
+                           const float* frac, float* theta) {
+    int order[INTERP_5D_DIMS] = {0, 1, 2, 3, 4};
+    for (int i = 1; i < INTERP_5D_DIMS; i++) {
+        int key = order[i];
+        int j = i - 1;
+        while (j >= 0 && frac[order[j]] < frac[key]) {
+            order[j + 1] = order[j];
+            j--;
+        }
+        order[j + 1] = key;
+    }
+
+    int c[INTERP_5D_DIMS] = {idx[0], idx[1], idx[2], idx[3], idx[4]};
+    AngleQuad acc = {{0.0f}};
+    quad_fma(&acc, corner_angles(table, c), 1.0f - frac[order[0]]);
+
+    for (int k = 0; k < INTERP_5D_DIMS; k++) {
+        c[order[k]]++;
+        float w = (k < INTERP_5D_DIMS - 1) ? frac[order[k]] - frac[order[k + 1]] : frac[order[k]];
+        quad_fma(&acc, corner_angles(table, c), w);
+    }
+    quad_store(theta, &acc);
+}
+
+// Full multilinear interpolation over all 32 corners of the cell
+static void interp_multilinear(const SwitchingAnglesTable* table, const int* idx,
+                               const float* frac, float* theta) {
+    AngleQuad acc = {{0.0f}};
+    for (int mask = 0; mask < (1 << INTERP_5D_DIMS); mask++) {
+        int c[INTERP_5D_DIMS];
+        float w = 1.0f;
+        for (int d = 0; d < INTERP_5D_DIMS; d++) {
+            int bit = (mask >> d) & 1;
+            c[d] = idx[d] + bit;
+            w *= bit ? frac[d] : 1.0f - frac[d];
+        }
+        quad_fma(&acc, corner_angles(table, c), w);
+    }
+    quad_store(theta, &acc);
+}
+
 // Helper function to compute V1 magnitude
 static float compute_v1(float * theta, single_dc_source_t *dc_sources) {
     if (!theta || !dc_sources) {
@@ -60,74 +144,174 @@ static float compute_v1_error(float * theta,
     return 100.0f * (v1_actual - v1_ideal) / v1_ideal;
 }
 
-// Compensate switching angles to minimize V1 error
-static void compensate_angles(float* theta,
-                              single_dc_source_t *dc_sources,
-                              float* final_error) {
-    if (!theta || !dc_sources || !final_error) {
-        fprintf(stderr, "Null pointer in compensate_angles\n");
-        return;
+// Solve (J J^T) y = -f for up to NUM_DC_SOURCES rows, partial pivoting.
+// Returns false when the rows are (nearly) dependent.
+static bool solve_normal_equations(float jjt[][NUM_DC_SOURCES], float* rhs, int rows) {
+    for (int col = 0; col < rows; col++) {
+        int pivot = col;
+        for (int r = col + 1; r < rows; r++) {
+            if (fabsf(jjt[r][col]) > fabsf(jjt[pivot][col])) pivot = r;
+        }
+        if (fabsf(jjt[pivot][col]) < 1e-9f) return false;
+        if (pivot != col) {
+            for (int k = 0; k < rows; k++) {
+                float t = jjt[col][k]; jjt[col][k] = jjt[pivot][k]; jjt[pivot][k] = t;
+            }
+            float t = rhs[col]; rhs[col] = rhs[pivot]; rhs[pivot] = t;
+        }
+        for (int r = col + 1; r < rows; r++) {
+            float f = jjt[r][col] / jjt[col][col];
+            for (int k = col; k < rows; k++) jjt[r][k] -= f * jjt[col][k];
+            rhs[r] -= f * rhs[col];
+        }
+    }
+    for (int r = rows - 1; r >= 0; r--) {
+        for (int k = r + 1; k < rows; k++) rhs[r] -= jjt[r][k] * rhs[k];
+        rhs[r] /= jjt[r][r];
     }
+    return true;
+}
 
-    // Validate input angles
+// Newton compensation of the fundamental: V1(theta) = sum c_i cos(theta_i)
+// is driven to pi * m_common with the minimum-norm step
+//     dtheta = J^T (J J^T)^-1 (target - V(theta)),  J_1i = -c_i sin(theta_i).
+// Each harmonic in `orders` adds a row J_ki = -c_i sin(k theta_i) holding
+// sum c_i cos(k theta_i) / k at its table value, so the correction does not
+// move low-order harmonics. Angles resting on a bound are left out of the
+// harmonic rows and steps are limited to MAX_NEWTON_STEP_RAD; if the
+// constrained solve does not reach the V1 threshold, the V1-only step is used.
+// Converges in 1-2 steps from table angles.
+#define MAX_NEWTON_STEP_RAD 0.1f
+
+static void compensate_angles_newton(float* theta,
+                                     const single_dc_source_t* dc_sources,
+                                     const int* orders, int num_orders,
+                                     float* final_error) {
+    if (!theta || !dc_sources || !final_error) return;
     for (int i = 0; i < NUM_DC_SOURCES; i++) {
         if (!isfinite(theta[i])) {
-            fprintf(stderr, "Invalid input angle at index %d\n", i);
+            *final_error = NAN;
             return;
         }
     }
+    if (num_orders > NUM_DC_SOURCES - 1) num_orders = NUM_DC_SOURCES - 1;
+    if (!orders) num_orders = 0;
+
+    const float ERROR_THRESHOLD = 0.1f;     // percent of V1
+    const int MAX_NEWTON_STEPS = 3;
+    const float v1_ideal = (float)M_PI * dc_sources[0].m_common;
+    const int rows = 1 + num_orders;
+
+    float target[NUM_DC_SOURCES];
+    target[0] = v1_ideal;
+    for (int r = 1; r < rows; r++) {
+        float vk = 0.0f;
+        for (int i = 0; i < NUM_DC_SOURCES; i++) {
+            vk += dc_sources[i].c * cosf(orders[r - 1] * theta[i]);
+        }
+        target[r] = vk;
+    }
 
-    const float LEARNING_RATE = 0.1f;
-    const float ERROR_THRESHOLD = 0.1f;
-    const int MAX_ITERATIONS = 7;
-    
     float working_theta[NUM_DC_SOURCES];
     memcpy(working_theta, theta, NUM_DC_SOURCES * sizeof(float));
-    
-    float v1_error = compute_v1_error(working_theta, dc_sources);
-    if (!isfinite(v1_error)) {
-        fprintf(stderr, "Invalid initial v1_error\n");
-        return;
-    }
+    float v1_error = 0.0f;
 
-    float v1_ideal = M_PI * dc_sources[0].m_common;
-    int iterations = 0;
-    
-    while (fabsf(v1_error) > ERROR_THRESHOLD && iterations < MAX_ITERATIONS) {
-        float v1_actual = compute_v1(working_theta, dc_sources);
-        if (!isfinite(v1_actual)) {
-            fprintf(stderr, "Invalid v1_actual at iteration %d\n", iterations);
+    for (int step = 0; ; step++) {
+        float jac[NUM_DC_SOURCES][NUM_DC_SOURCES];
+        float residual[NUM_DC_SOURCES];
+        float v1 = 0.0f;
+        for (int i = 0; i < NUM_DC_SOURCES; i++) {
+            float s = sinf(working_theta[i]);
+            float c = cosf(working_theta[i]);
+            v1 += dc_sources[i].c * c;
+            jac[0][i] = -dc_sources[i].c * s;
+        }
+        v1_error = 100.0f * (v1 - v1_ideal) / v1_ideal;
+        if (!isfinite(v1_error)) {
+            *final_error = NAN;
             return;
         }
+        if (fabsf(v1_error) <= ERROR_THRESHOLD || step == MAX_NEWTON_STEPS) break;
 
-        float error_factor = 2.0f * (v1_actual - v1_ideal);
-        
+        residual[0] = v1_ideal - v1;
+        int num_free = 0;
         for (int i = 0; i < NUM_DC_SOURCES; i++) {
-            float gradient = error_factor * (-dc_sources[i].c * sinf(working_theta[i]));
-            if (!isfinite(gradient)) {
-                fprintf(stderr, "Invalid gradient for angle %d\n", i);
-                return;
+            if (working_theta[i] > 0.0f && working_theta[i] < (float)M_PI_2) num_free++;
+        }
+        for (int r = 1; r < rows; r++) {
+            float k = (float)orders[r - 1];
+            float vk = 0.0f;
+            for (int i = 0; i < NUM_DC_SOURCES; i++) {
+                float s = sinf(k * working_theta[i]);
+                float c = cosf(k * working_theta[i]);
+                vk += dc_sources[i].c * c;
+                jac[r][i] = -k * dc_sources[i].c * s;
             }
-            working_theta[i] -= LEARNING_RATE * gradient;
-            working_theta[i] = fmaxf(0.0f, fminf(M_PI_2, working_theta[i]));
+            residual[r] = target[r] - vk;
         }
-        
-        v1_error = compute_v1_error(working_theta, dc_sources);
-        iterations++;
-    }
-    
-    // Validate final results before copying back
-    for (int i = 0; i < NUM_DC_SOURCES; i++) {
-        if (!isfinite(working_theta[i])) {
-            fprintf(stderr, "Invalid compensated angle at index %d\n", i);
-            return;
+        // Angles on a bound cannot follow the harmonic rows
+        for (int i = 0; i < NUM_DC_SOURCES; i++) {
+            if (working_theta[i] <= 0.0f || working_theta[i] >= (float)M_PI_2) {
+                for (int r = 1; r < rows; r++) jac[r][i] = 0.0f;
+            }
+        }
+
+        int active_rows = rows < num_free ? rows : 1;
+        float jjt[NUM_DC_SOURCES][NUM_DC_SOURCES];
+        bool stuck = false;
+        for (;;) {
+            for (int r = 0; r < active_rows; r++) {
+                for (int q = 0; q < active_rows; q++) {
+                    float sum = 0.0f;
+                    for (int i = 0; i < NUM_DC_SOURCES; i++) sum += jac[r][i] * jac[q][i];
+                    jjt[r][q] = sum;
+                }
+            }
+            float y[NUM_DC_SOURCES];
+            memcpy(y, residual, active_rows * sizeof(float));
+            if (solve_normal_equations(jjt, y, active_rows)) {
+                memcpy(residual, y, active_rows * sizeof(float));
+                break;
+            }
+            if (active_rows == 1) {         // all angles at 0: V1 cannot move
+                stuck = true;
+                break;
+            }
+            active_rows = 1;                // drop harmonic rows, V1 only
+        }
+        if (stuck) break;                   // keep the last angles and their error
+
+        float delta[NUM_DC_SOURCES];
+        float max_delta = 0.0f;
+        for (int i = 0; i < NUM_DC_SOURCES; i++) {
+            float d = 0.0f;
+            for (int r = 0; r < active_rows; r++) d += jac[r][i] * residual[r];
+            delta[i] = d;
+            max_delta = fmaxf(max_delta, fabsf(d));
+        }
+        float scale = max_delta > MAX_NEWTON_STEP_RAD ? MAX_NEWTON_STEP_RAD / max_delta : 1.0f;
+        for (int i = 0; i < NUM_DC_SOURCES; i++) {
+            working_theta[i] = fmaxf(0.0f, fminf((float)M_PI_2, working_theta[i] + scale * delta[i]));
         }
     }
-    
+
+    if (rows > 1 && fabsf(v1_error) > ERROR_THRESHOLD) {
+        compensate_angles_newton(theta, dc_sources, NULL, 0, final_error);
+        return;
+    }
     memcpy(theta, working_theta, NUM_DC_SOURCES * sizeof(float));
     *final_error = v1_error;
-    
-    // printf("Debug: Compensation completed after %d iterations\n", iterations);
+}
+
+// Compensate switching angles to minimize V1 error
+static void compensate_angles(float* theta,
+                              single_dc_source_t *dc_sources,
+                              float* final_error) {
+    if (!theta || !dc_sources || !final_error) {
+        fprintf(stderr, "Null pointer in compensate_angles\n");
+        return;
+    }
+    compensate_angles_newton(theta, dc_sources, NULL, 0, final_error);
 }
 
 const SwitchingAnglesTable* init_switching_angles_lookup_table(void) {
@@ -233,13 +417,13 @@ void interpolate_switching_angles_5d(
     //     printf("Debug: dc_source[%d].c = %.3f\n", i, dc_sources[i].c);
     // }
 
-    // Constrain ci values to [0.95, 1.05]
+    // Constrain ci values to [CI_MIN, CI_MAX]
     for (int i = 0; i < NUM_DC_SOURCES; i++) {
-        dc_sources[i].c = dc_sources[i].c < 0.95f ? 0.95f : (dc_sources[i].c > 1.05f ? 1.05f : dc_sources[i].c);
+        dc_sources[i].c = dc_sources[i].c < CI_MIN ? CI_MIN : (dc_sources[i].c > CI_MAX ? CI_MAX : dc_sources[i].c);
     }
     
     // Constrain m to [0.75, 1.0]
-    dc_sources[0].m_common = dc_sources[0].m_common < 0.75f ? 0.75f : (dc_sources[0].m_common > 1.0f ? 1.0f : dc_sources[0].m_common);
+    dc_sources[0].m_common = dc_sources[0].m_common < MOD_INDEX_MIN ? MOD_INDEX_MIN : (dc_sources[0].m_common > MOD_INDEX_MAX ? MOD_INDEX_MAX : dc_sources[0].m_common);
 
     // Find indices and factors for ci values
     int ci_idx[NUM_DC_SOURCES];
@@ -253,31 +437,18 @@ void interpolate_switching_angles_5d(
     float m_factor;
     find_index_and_factor(dc_sources[0].m_common, table->m_values, N_MOD_INDEX, &m_idx, &m_factor);
 
-    // Interpolate angles for each DC source
+    if (ci_idx[0] >= N_POINTS_PER_CI-1 || ci_idx[1] >= N_POINTS_PER_CI-1 || 
+        ci_idx[2] >= N_POINTS_PER_CI-1 || ci_idx[3] >= N_POINTS_PER_CI-1 || 
+        m_idx >= N_MOD_INDEX-1) {
+        fprintf(stderr, "Index out of bounds in interpolation\n");
+        return;
+    }
+
+    int idx[INTERP_5D_DIMS] = {ci_idx[0], ci_idx[1], ci_idx[2], ci_idx[3], m_idx};
+    float frac[INTERP_5D_DIMS] = {ci_factor[0], ci_factor[1], ci_factor[2], ci_factor[3], m_factor};
+    interp_simplex(table, idx, frac, result->theta);
+
     for (int dc = 0; dc < NUM_DC_SOURCES; dc++) {
-        if (ci_idx[0] >= N_POINTS_PER_CI-1 || ci_idx[1] >= N_POINTS_PER_CI-1 || 
-            ci_idx[2] >= N_POINTS_PER_CI-1 || ci_idx[3] >= N_POINTS_PER_CI-1 || 
-            m_idx >= N_MOD_INDEX-1) {
-            fprintf(stderr, "Index out of bounds in interpolation\n");
-            return;
-        }
-        // Get base angle
-        float base_angle = table->angles[ci_idx[0]][ci_idx[1]][ci_idx[2]][ci_idx[3]][m_idx][dc];
-        
-        // First-order approximation (Taylor expansion)
-        float delta_angle = 0.0f;
-        
-        // Add contribution from each ci dimension
-        for (int i = 0; i < NUM_DC_SOURCES; i++) {
-            float next_angle = table->angles[ci_idx[0] + (i==0)][ci_idx[1] + (i==1)][ci_idx[2] + (i==2)][ci_idx[3] + (i==3)][m_idx][dc];
-            delta_angle += (next_angle - base_angle) * ci_factor[i];
-        }
-        
-        // Add contribution from modulation index
-        float next_m_angle = table->angles[ci_idx[0]][ci_idx[1]][ci_idx[2]][ci_idx[3]][m_idx + 1][dc];
-        delta_angle += (next_m_angle - base_angle) * m_factor;
-        
-        result->theta[dc] = base_angle + delta_angle;
         result->theta[dc] = fmaxf(0.0f, fminf(M_PI_2, result->theta[dc]));
     }
     
@@ -312,7 +483,7 @@ void interpolate_switching_angles_5d(
             break;
         }
         // Ensure angles are within valid range
-        if (result->theta[i] < 0.0f || result->theta[i] > M_PI_2) {
+        if (result->theta[i] < 0.0f || result->theta[i] > (float)M_PI_2) {
             valid_results = false;
             fprintf(stderr, "Angle out of range at index %d: %.3f\n", i, result->theta[i]);
             break;
@@ -379,4 +550,48 @@ void interpolate_switching_angles_5d_with_correction(
     } else {
         result->v1_error = final_error;
     }
-} 
\ No newline at end of file
+}
+
+void interpolate_switching_angles_5d_raw(
+    const SwitchingAnglesTable* table,
+    const single_dc_source_t* dc_sources,
+    Interp5dMethod method,
+    float* theta
+) {
+    if (!table || !dc_sources || !theta) return;
+
+    int idx[INTERP_5D_DIMS];
+    float frac[INTERP_5D_DIMS];
+    for (int i = 0; i < NUM_DC_SOURCES; i++) {
+        float c = fmaxf(CI_MIN, fminf(CI_MAX, dc_sources[i].c));
+        find_index_and_factor(c, table->c1_values, N_POINTS_PER_CI, &idx[i], &frac[i]);
+    }
+    float m = fmaxf(MOD_INDEX_MIN, fminf(MOD_INDEX_MAX, dc_sources[0].m_common));
+    find_index_and_factor(m, table->m_values, N_MOD_INDEX, &idx[4], &frac[4]);
+
+    switch (method) {
+        case INTERP_5D_TAYLOR:
+            interp_taylor(table, idx, frac, theta);
+            break;
+        case INTERP_5D_MULTILINEAR:
+            interp_multilinear(table, idx, frac, theta);
+            break;
+        case INTERP_5D_SIMPLEX:
+        default:
+            interp_simplex(table, idx, frac, theta);
+            break;
+    }
+}
+
+void compensate_switching_angles(float* theta,
+                                 single_dc_source_t* dc_sources,
+                                 float* final_error) {
+    compensate_angles(theta, dc_sources, final_error);
+}
+
+void compensate_switching_angles_harmonics(float* theta,
+                                           const single_dc_source_t* dc_sources,
+                                           const int* orders, int num_orders,
+                                           float* final_error) {
+    compensate_angles_newton(theta, dc_sources, orders, num_orders, final_error);
+}
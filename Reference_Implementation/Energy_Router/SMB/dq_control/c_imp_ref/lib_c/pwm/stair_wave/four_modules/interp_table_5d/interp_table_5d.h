@@ -5,6 +5,14 @@
 #include "../../common/table_def/table_def.h"
 
 #define MAX_ITERATIONS_FOR_ANGLE_CORRECTION 50
+#define INTERP_5D_DIMS 5    // c1..c4, m
+
+// Interpolation scheme over one 5D grid cell
+typedef enum {
+    INTERP_5D_TAYLOR = 0,       // first-order step from the lower corner (6 corners, no cross terms)
+    INTERP_5D_SIMPLEX = 1,      // Kuhn simplex decomposition (6 corners, exact at nodes)
+    INTERP_5D_MULTILINEAR = 2   // full multilinear (32 corners)
+} Interp5dMethod;
 
 // Initialize the lookup table
 // Returns: Pointer to initialized table on success, NULL on failure
@@ -26,4 +34,27 @@ void interpolate_switching_angles_5d_with_correction(
     SwitchingAnglesResult* result
 );
 
+// Interpolated angles only: inputs are clamped to the table range but
+// dc_sources is not modified, and no V1 compensation is applied
+void interpolate_switching_angles_5d_raw(
+    const SwitchingAnglesTable* table,
+    const single_dc_source_t* dc_sources,
+    Interp5dMethod method,
+    float* theta
+);
+
+// Adjust theta in place so the fundamental matches pi * m_common
+// (Newton steps, typically one). final_error is always written: the V1 error
+// (%) of the returned angles, NAN when the input angles are not finite.
+void compensate_switching_angles(float* theta,
+                                 single_dc_source_t* dc_sources,
+                                 float* final_error);
+
+// As above, additionally holding the listed harmonics (e.g. {5, 7}) at their
+// value for the input angles; at most NUM_DC_SOURCES - 1 orders are used
+void compensate_switching_angles_harmonics(float* theta,
+                                           const single_dc_source_t* dc_sources,
+                                           const int* orders, int num_orders,
+                                           float* final_error);
+
 #endif // LOOKUP_TABLE_5D_H 
\ No newline at end of file
@@ -1,22 +1,115 @@
 #ifndef LOAD_SWITCHING_ANGLES_TABLE_5D_H
 #define LOAD_SWITCHING_ANGLES_TABLE_5D_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #define N_POINTS_PER_CI 5   // Points per voltage ratio (0.95 to 1.05)
 #define N_MOD_INDEX 6       // Points for modulation index (0.75 to 1.0)
 #define NUM_DC_SOURCES 4    // Number of DC sources
 
+// Grid bounds; lookups clamp to them
+#define CI_MIN 0.95f
+#define CI_MAX 1.05f
+#define MOD_INDEX_MIN 0.75f
+#define MOD_INDEX_MAX 1.0f
+
+// Vector type for one angle quad; falls back to scalar loops without GCC/Clang
+#if defined(__GNUC__)
+#define ANGLE_QUAD_VECTOR 1
+typedef float angle_vec4_t __attribute__((vector_size(4 * sizeof(float))));
+#endif
+
+#ifdef __cplusplus
+#define ANGLE_QUAD_ALIGN alignas(16)
+extern "C" {
+#else
+#define ANGLE_QUAD_ALIGN _Alignas(16)
+#endif
+
+// Switching angles of all DC sources at one grid point, 16-byte aligned so a
+// corner is one vector load
+typedef union {
+    ANGLE_QUAD_ALIGN float theta[NUM_DC_SOURCES];
+#ifdef ANGLE_QUAD_VECTOR
+    angle_vec4_t vec;
+#endif
+} AngleQuad;
+
+// Offline quality data, not needed by the interpolation path
 typedef struct {
+    float thd[N_POINTS_PER_CI][N_POINTS_PER_CI][N_POINTS_PER_CI][N_POINTS_PER_CI][N_MOD_INDEX];
+    float v1_error[N_POINTS_PER_CI][N_POINTS_PER_CI][N_POINTS_PER_CI][N_POINTS_PER_CI][N_MOD_INDEX];
+} SwitchingAnglesStats;
+
+// Runtime table. angles and stats point into one table image that is either
+// memory-mapped from a version 2 file or built on the heap from a legacy file.
+typedef struct {
+    AngleQuad (*angles)[N_POINTS_PER_CI][N_POINTS_PER_CI][N_POINTS_PER_CI][N_MOD_INDEX];
     float c1_values[N_POINTS_PER_CI];
     float c2_values[N_POINTS_PER_CI];
     float c3_values[N_POINTS_PER_CI];
     float c4_values[N_POINTS_PER_CI];
     float m_values[N_MOD_INDEX];
-    float angles[N_POINTS_PER_CI][N_POINTS_PER_CI][N_POINTS_PER_CI][N_POINTS_PER_CI][N_MOD_INDEX][NUM_DC_SOURCES];
-    float thd[N_POINTS_PER_CI][N_POINTS_PER_CI][N_POINTS_PER_CI][N_POINTS_PER_CI][N_MOD_INDEX];
-    float v1_error[N_POINTS_PER_CI][N_POINTS_PER_CI][N_POINTS_PER_CI][N_POINTS_PER_CI][N_MOD_INDEX];
+    SwitchingAnglesStats* stats;
+    void* image;            // mapped file or heap copy
+    size_t image_size;
+    int image_mapped;       // 1: munmap on free, 0: free()
 } SwitchingAnglesTable;
 
+// Version 2 file: this header followed by the sections at the given offsets,
+// each already in runtime layout and 64-byte aligned. The checksum is FNV-1a
+// over all bytes after the header. It is written and checked by
+// save_switching_angles_table_5d(); loads check only the header and layout
+// unless SWITCHING_TABLE_VERIFY_ON_LOAD is 1, so a mapped table is not paged
+// in at startup.
+#define SWITCHING_TABLE_MAGIC 0x54415753u      // "SWAT"
+#define SWITCHING_TABLE_VERSION 2
+#define SWITCHING_TABLE_LAYOUT_QUAD_F32 1      // AngleQuad [c1][c2][c3][c4][m], float32
+#define SWITCHING_TABLE_SECTION_ALIGN 64
+
+#ifndef SWITCHING_TABLE_VERIFY_ON_LOAD
+#define SWITCHING_TABLE_VERIFY_ON_LOAD 0
+#endif
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t layout;
+    int32_t n_points_per_ci;
+    int32_t n_mod_index;
+    int32_t num_dc_sources;
+    uint32_t checksum;
+    uint64_t axes_offset;   // float c_values[NUM_DC_SOURCES][N_POINTS_PER_CI], m_values[N_MOD_INDEX]
+    uint64_t angles_offset;
+    uint64_t stats_offset;
+    uint64_t file_size;
+} SwitchingTableFileHeader;
+
+// Environment variable consulted when no path has been set
+#define SWITCHING_TABLE_PATH_ENV "SWITCHING_ANGLES_TABLE_5D"
+
+// Table path used by load_switching_angles_table_5d(); NULL restores the
+// default (environment variable, then switching_angles_table.bin next to
+// this source file)
+void set_switching_angles_table_5d_path(const char* filename);
+
 SwitchingAnglesTable* load_switching_angles_table_5d(void);
+
+// Load a version 2 file (mmap, no copy) or a legacy file (read and reorder)
+SwitchingAnglesTable* load_switching_angles_table_5d_from(const char* filename);
+
+// Write the table as a version 2 file and verify it. Returns 0 on success.
+int save_switching_angles_table_5d(const SwitchingAnglesTable* table, const char* filename);
+
+// Check header, layout and checksum of a version 2 file. Returns 0 if valid.
+int verify_switching_angles_table_5d(const char* filename);
+
 void free_switching_angles_table_5d(SwitchingAnglesTable* table);
 
-#endif // LOAD_SWITCHING_ANGLES_TABLE_5D_H
\ No newline at end of file
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOAD_SWITCHING_ANGLES_TABLE_5D_H
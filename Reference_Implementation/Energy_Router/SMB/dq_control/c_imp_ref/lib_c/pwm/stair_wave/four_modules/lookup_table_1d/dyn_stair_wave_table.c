@@ -1,20 +1,40 @@
 #include "dyn_stair_wave_table.h"
 #include "../interp_table_5d/interp_table_5d.h"
+#include "../../../../misc/static_arena/static_arena.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
 
+// Phase counts of the table angles, saturated inside [0, 2 pi) so the edges
+// stay ascending; edges[num_points - 1] is 2 pi, i.e. 0 after the wrap
+static void update_stair_wave_edges(StairWaveTable* table) {
+    for (int i = 0; i < table->num_points - 1; i++) {
+        float phase = table->angles[i] * STAIR_PHASE_PER_RAD;
+        table->edges[i] = phase <= 0.0f ? 0u
+                        : phase >= 4294967296.0f ? UINT32_MAX
+                        : (uint32_t)phase;
+    }
+    table->edges[table->num_points - 1] = 0u;
+}
+
 StairWaveTable* init_stair_wave_table(const int num_modules) {
-    StairWaveTable* table = (StairWaveTable*)malloc(sizeof(StairWaveTable));
-    if (!table) return NULL;
+    // Start-up allocation from the control arena, released with static_arena_reset
+    StaticArena* arena = control_arena();
+    StairWaveTable* table = STATIC_ARENA_NEW(arena, StairWaveTable, 1);
+    if (!table) {
+        fprintf(stderr, "Control arena full in init_stair_wave_table\n");
+        return NULL;
+    }
 
     table->num_points = 4 * num_modules + 2;
-    table->angles = (float*)malloc(table->num_points * sizeof(float));
-    table->sum_index = (int*)malloc(table->num_points * sizeof(int));
-    table->sum_value = (float*)malloc(table->num_points * sizeof(float));
+    table->angles = STATIC_ARENA_NEW(arena, float, table->num_points);
+    table->sum_index = STATIC_ARENA_NEW(arena, int, table->num_points);
+    table->sum_value = STATIC_ARENA_NEW(arena, float, table->num_points);
+    table->edges = STATIC_ARENA_NEW(arena, uint32_t, table->num_points);
 
     
-    if (!table->angles || !table->sum_index || !table->sum_value) {
+    if (!table->angles || !table->sum_index || !table->sum_value || !table->edges) {
+        fprintf(stderr, "Control arena full in init_stair_wave_table\n");
         free_stair_wave_table(table);
         return NULL;
     }
@@ -65,6 +85,8 @@ StairWaveTable* init_stair_wave_table(const int num_modules) {
     for (int i = 0; i < table->num_points; i++) {
         table->angles[i] = 2.0f * M_PI * i / (table->num_points - 2);
     }
+    table->angles[table->num_points - 1] = 2.0f * M_PI;
+    update_stair_wave_edges(table);
 
     return table;
 }
@@ -80,7 +102,7 @@ void update_stair_wave_table(StairWaveTable* table,
     }
 
     // Validate table arrays
-    if (!table->angles || !table->sum_index || !table->sum_value) {
+    if (!table->angles || !table->sum_index || !table->sum_value || !table->edges) {
         fprintf(stderr, "Invalid table arrays in update_stair_wave_table\n");
         return;
     }
@@ -136,73 +158,83 @@ void update_stair_wave_table(StairWaveTable* table,
     table->angles[15] = 2.0f * M_PI - alpha2;
     table->angles[16] = 2.0f * M_PI - alpha1;
     table->angles[17] = 2.0f * M_PI;
-    printf("xxxx alpha1: %f, alpha2: %f, alpha3: %f, alpha4: %f\n", alpha1, alpha2, alpha3, alpha4);
-
+    update_stair_wave_edges(table);
 }
 
 void free_stair_wave_table(StairWaveTable* table) {
+    // Arena memory: only detach, the block returns with static_arena_reset
     if (table) {
-        free(table->angles);
-        free(table->sum_index);
-        free(table->sum_value);
-        free(table);
+        table->angles = NULL;
+        table->sum_index = NULL;
+        table->sum_value = NULL;
+        table->edges = NULL;
+        table->num_points = 0;
     }
 }
 void get_switching_state(
     const StairWaveTable* table,
     float angle,
     float margin,
-    bool update_table, 
     SwitchingStateResult* result
 ) {
-    
-    // Normalize angle with margin to [0, 2π]
-    float angle_w_margin = fmod(angle + margin, 2.0f * M_PI);
-
-    // Set search boundaries based on update_table flag
-    int left, right;
-    if (update_table || !result) {
-        left = 0;
-        right = table->num_points - 1;
-    } else {
-        // Find appropriate search window
-        left = result->index;
-        right = left + 2;
-        // Ensure bounds are valid
-        if (right >= table->num_points) {
-            left = 0;
-            right = table->num_points - 1;
-        }
-
-        if (table->angles[right] < angle_w_margin) {
-            left = 0; 
-            right = table->num_points - 1;
-        }
-    }
+    // Wrapping to [0, 2pi) is the uint32 overflow of the phase, no fmod
+    StairWaveCursor cursor;
+    stair_wave_cursor_seek(table, &cursor, stair_wave_phase_from_angle(angle + margin));
+    stair_wave_cursor_result(table, &cursor, result);
+}
 
-    while (left <= right) {
-        // Check if angle_w_margin is within current bounds
-        if (table->angles[left] <= angle_w_margin && table->angles[right] > angle_w_margin && right - left <= 1)
-            break;
+uint32_t stair_wave_phase_from_angle(float angle) {
+    // int64 keeps negative angles and several turns exact before the wrap
+    return (uint32_t)(int64_t)(angle * STAIR_PHASE_PER_RAD);
+}
 
-        int mid = (left + right) / 2;
-        
-        if (mid == left) break;  // Prevent infinite loop
-    
-        if (angle_w_margin >= table->angles[mid]) {
+void stair_wave_cursor_seek(const StairWaveTable* table, StairWaveCursor* cursor, uint32_t phase) {
+    // Segment i is [edges[i], edges[i + 1]), the last segment ends at the wrap
+    int left = 0;
+    int right = table->num_points - 2;
+    while (left < right) {
+        int mid = (left + right + 1) / 2;
+        if (table->edges[mid] <= phase) {
             left = mid;
         } else {
             right = mid - 1;
         }
     }
+    cursor->phase = phase;
+    cursor->index = left;
+    cursor->remaining = table->edges[left + 1] - phase;
+}
 
-    result->index = left;
-    result->state = table->sum_index[left];
-    result->phase_2next = table->angles[right] - angle_w_margin;
+void stair_wave_cursor_advance(const StairWaveTable* table, StairWaveCursor* cursor, uint32_t delta) {
+    if (delta < cursor->remaining) {
+        cursor->phase += delta;
+        cursor->remaining -= delta;
+        return;
+    }
 
-    // if (right == table->num_points - 1) {
-    //     result->phase_2next +=  table->angles[1];
-    // }
+    // Crossed at least one edge: walk the segments, skipping empty ones
+    const int segments = table->num_points - 1;
+    uint32_t left = delta - cursor->remaining;
+    int index = cursor->index;
+    for (int step = 0; step <= segments; step++) {
+        if (++index == segments) index = 0;
+        uint32_t width = table->edges[index + 1] - table->edges[index];
+        if (left < width) {
+            cursor->phase += delta;
+            cursor->index = index;
+            cursor->remaining = width - left;
+            return;
+        }
+        left -= width;
+    }
+
+    // Edges out of order (table being rewritten): fall back to a search
+    stair_wave_cursor_seek(table, cursor, cursor->phase + delta);
+}
 
-    return;
+void stair_wave_cursor_result(const StairWaveTable* table, const StairWaveCursor* cursor,
+                              SwitchingStateResult* result) {
+    result->index = cursor->index;
+    result->state = table->sum_index[cursor->index];
+    result->phase_2next = (float)cursor->remaining * STAIR_RAD_PER_PHASE;
 }
@@ -11,17 +11,31 @@ void update_stair_wave_table(StairWaveTable* table,
                             single_dc_source_t* dc_sources, 
                             const int num_modules);
 
-// Free the allocated memory for the switching table
+// Detach the table; its memory stays in use until static_arena_reset(control_arena())
 void free_stair_wave_table(StairWaveTable* table);
 
-// Get switching state and index for any angle using binary search
+// Get switching state and index for any angle using binary search. Every
+// call searches all edges, so there is no force_reset flag any more.
 void get_switching_state(const StairWaveTable* table, 
                         float angle, 
                         float angle_safe_margin, 
-                        bool force_reset, 
                         SwitchingStateResult* last_result);
 
-// Initialize a new stair wave table with memory allocation
+// Angle (rad, any range) to phase counts
+uint32_t stair_wave_phase_from_angle(float angle);
+
+// Place the cursor at phase (binary search, after a table update or a jump)
+void stair_wave_cursor_seek(const StairWaveTable* table, StairWaveCursor* cursor, uint32_t phase);
+
+// Move the cursor forward by delta counts (< one cycle). Between edges this
+// is one compare and one subtraction.
+void stair_wave_cursor_advance(const StairWaveTable* table, StairWaveCursor* cursor, uint32_t delta);
+
+// State, index and phase to the next edge at the cursor
+void stair_wave_cursor_result(const StairWaveTable* table, const StairWaveCursor* cursor,
+                              SwitchingStateResult* result);
+
+// Initialize a new stair wave table in the control arena (start-up only)
 StairWaveTable* init_stair_wave_table(const int num_modules);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include "she_service.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Quantized operating point packed into 64 bits: 12 bits per ci, 16 for m
+static uint64_t quantize_key(const single_dc_source_t* dc_sources, float* c_q, float* m_q) {
+    uint64_t key = 0;
+    for (int i = 0; i < NUM_DC_SOURCES; i++) {
+        float c = fmaxf(0.95f, fminf(1.05f, dc_sources[i].c));
+        uint32_t q = (uint32_t)lrintf(c / SHE_C_QUANTUM) & 0xfffu;
+        key = (key << 12) | q;
+        if (c_q) c_q[i] = lrintf(c / SHE_C_QUANTUM) * SHE_C_QUANTUM;
+    }
+    float m = fmaxf(0.75f, fminf(1.0f, dc_sources[0].m_common));
+    uint32_t q = (uint32_t)lrintf(m / SHE_M_QUANTUM);
+    key = (key << 16) | (q & 0xffffu);
+    if (m_q) *m_q = q * SHE_M_QUANTUM;
+    return key | (1ull << 63);      // never 0
+}
+
+static uint32_t set_index(const SheService* service, uint64_t key) {
+    uint64_t h = key * 0x9e3779b97f4a7c15ull;
+    return (uint32_t)(h >> 32) & (service->num_sets - 1);
+}
+
+int she_service_init(SheService* service, uint32_t capacity) {
+    if (!service) return -1;
+    memset(service, 0, sizeof(*service));
+
+    uint32_t num_sets = 1;
+    while (num_sets * SHE_CACHE_WAYS < capacity) num_sets <<= 1;
+    service->entries = (SheCacheEntry*)calloc((size_t)num_sets * SHE_CACHE_WAYS, sizeof(SheCacheEntry));
+    if (!service->entries) {
+        fprintf(stderr, "Error: Failed to allocate SHE cache\n");
+        return -1;
+    }
+    service->num_sets = num_sets;
+    if (sem_init(&service->pending, 0, 0) != 0) {
+        free(service->entries);
+        service->entries = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+bool she_service_find(SheService* service, const single_dc_source_t* dc_sources, float* theta) {
+    if (!service || !service->entries || !dc_sources || !theta) return false;
+
+    uint64_t key = quantize_key(dc_sources, NULL, NULL);
+    SheCacheEntry* set = &service->entries[(size_t)set_index(service, key) * SHE_CACHE_WAYS];
+    for (int w = 0; w < SHE_CACHE_WAYS; w++) {
+        SheCacheEntry* e = &set[w];
+        unsigned seq = atomic_load_explicit(&e->seq, memory_order_acquire);
+        if (seq & 1u) continue;     // being written
+        if (e->key != key) continue;
+        float copy[NUM_DC_SOURCES];
+        memcpy(copy, e->theta, sizeof(copy));
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&e->seq, memory_order_relaxed) != seq) continue;
+        memcpy(theta, copy, sizeof(copy));
+        return true;
+    }
+    return false;
+}
+
+static void cache_insert(SheService* service, uint64_t key, const float* theta) {
+    SheCacheEntry* set = &service->entries[(size_t)set_index(service, key) * SHE_CACHE_WAYS];
+    SheCacheEntry* victim = &set[0];
+    for (int w = 0; w < SHE_CACHE_WAYS; w++) {
+        if (set[w].key == key || set[w].key == 0) {
+            victim = &set[w];
+            break;
+        }
+        if (set[w].age < victim->age) victim = &set[w];
+    }
+
+    unsigned seq = atomic_load_explicit(&victim->seq, memory_order_relaxed);
+    atomic_store_explicit(&victim->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    victim->key = key;
+    victim->age = ++service->insert_stamp;
+    memcpy(victim->theta, theta, sizeof(victim->theta));
+    atomic_store_explicit(&victim->seq, seq + 2, memory_order_release);
+}
+
+// Controller side: queue a point unless it is already waiting or the queue is full
+static void enqueue(SheService* service, uint64_t key, const float* c, float m, const float* theta) {
+    unsigned head = atomic_load_explicit(&service->queue_head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&service->queue_tail, memory_order_acquire);
+    for (unsigned i = tail; i != head; i++) {
+        if (service->queue[i & (SHE_QUEUE_SIZE - 1)].key == key) return;
+    }
+    if (head - tail >= SHE_QUEUE_SIZE) {
+        atomic_fetch_add_explicit(&service->dropped, 1, memory_order_relaxed);
+        return;
+    }
+    SheRequest* req = &service->queue[head & (SHE_QUEUE_SIZE - 1)];
+    req->key = key;
+    memcpy(req->c, c, sizeof(req->c));
+    req->m = m;
+    memcpy(req->theta, theta, sizeof(req->theta));
+    atomic_store_explicit(&service->queue_head, head + 1, memory_order_release);
+    if (service->thread_started) {
+        sem_post(&service->pending);
+    }
+}
+
+int she_service_process(SheService* service, int max_requests) {
+    if (!service || !service->entries) return 0;
+
+    int done = 0;
+    while (done < max_requests) {
+        unsigned tail = atomic_load_explicit(&service->queue_tail, memory_order_relaxed);
+        unsigned head = atomic_load_explicit(&service->queue_head, memory_order_acquire);
+        if (tail == head) break;
+
+        SheRequest req = service->queue[tail & (SHE_QUEUE_SIZE - 1)];
+        atomic_store_explicit(&service->queue_tail, tail + 1, memory_order_release);
+
+        // she_solve pairs theta ascending with c descending: solve the
+        // modules in descending c order, then put the angles back in
+        // controller order (theta[i] belongs to module i)
+        int order[NUM_DC_SOURCES];
+        for (int i = 0; i < NUM_DC_SOURCES; i++) {
+            int j = i;
+            for (; j > 0 && req.c[order[j - 1]] < req.c[i]; j--) order[j] = order[j - 1];
+            order[j] = i;
+        }
+        float c_sorted[NUM_DC_SOURCES], theta_sorted[NUM_DC_SOURCES];
+        for (int k = 0; k < NUM_DC_SOURCES; k++) {
+            c_sorted[k] = req.c[order[k]];
+            theta_sorted[k] = req.theta[order[k]];
+        }
+
+        SheSolveStats stats;
+        if (she_solve(c_sorted, req.m, theta_sorted, SHE_MAX_ITERATIONS, &stats) != SHE_SOLVE_FAILED) {
+            for (int k = 0; k < NUM_DC_SOURCES; k++) req.theta[order[k]] = theta_sorted[k];
+            cache_insert(service, req.key, req.theta);
+            atomic_fetch_add_explicit(&service->solved, 1, memory_order_relaxed);
+        } else {
+            atomic_fetch_add_explicit(&service->rejected, 1, memory_order_relaxed);
+        }
+        done++;
+    }
+    return done;
+}
+
+static void* worker_main(void* arg) {
+    SheService* service = (SheService*)arg;
+    while (atomic_load(&service->running)) {
+        sem_wait(&service->pending);
+        she_service_process(service, SHE_QUEUE_SIZE);
+    }
+    return NULL;
+}
+
+int she_service_start(SheService* service) {
+    if (!service || !service->entries || service->thread_started) return -1;
+    atomic_store(&service->running, true);
+    service->thread_started = true;
+    if (pthread_create(&service->worker, NULL, worker_main, service) != 0) {
+        fprintf(stderr, "Error: Failed to start SHE worker\n");
+        atomic_store(&service->running, false);
+        service->thread_started = false;
+        return -1;
+    }
+    // Points queued before the start were not posted
+    unsigned head = atomic_load_explicit(&service->queue_head, memory_order_acquire);
+    unsigned tail = atomic_load_explicit(&service->queue_tail, memory_order_acquire);
+    for (unsigned i = tail; i != head; i++) {
+        sem_post(&service->pending);
+    }
+    return 0;
+}
+
+void she_service_stop(SheService* service) {
+    if (!service || !service->thread_started) return;
+    atomic_store(&service->running, false);
+    sem_post(&service->pending);
+    pthread_join(service->worker, NULL);
+    service->thread_started = false;
+}
+
+void she_service_free(SheService* service) {
+    if (!service) return;
+    she_service_stop(service);
+    if (service->entries) {
+        sem_destroy(&service->pending);
+        free(service->entries);
+        service->entries = NULL;
+    }
+}
+
+bool she_service_lookup(SheService* service,
+                        const SwitchingAnglesTable* table,
+                        single_dc_source_t* dc_sources,
+                        SwitchingAnglesResult* result) {
+    if (!service || !table || !dc_sources || !result) return false;
+
+    if (she_service_find(service, dc_sources, result->theta)) {
+        atomic_fetch_add_explicit(&service->hits, 1, memory_order_relaxed);
+        float v1 = 0.0f;
+        for (int i = 0; i < NUM_DC_SOURCES; i++) v1 += dc_sources[i].c * cosf(result->theta[i]);
+        float v1_ideal = (float)M_PI * dc_sources[0].m_common;
+        result->v1_error = 100.0f * (v1 - v1_ideal) / v1_ideal;
+        return true;
+    }
+    atomic_fetch_add_explicit(&service->misses, 1, memory_order_relaxed);
+
+    interpolate_switching_angles_5d(table, dc_sources, result);
+
+    float c_q[NUM_DC_SOURCES];
+    float m_q;
+    uint64_t key = quantize_key(dc_sources, c_q, &m_q);
+    enqueue(service, key, c_q, m_q, result->theta);
+    return false;
+}
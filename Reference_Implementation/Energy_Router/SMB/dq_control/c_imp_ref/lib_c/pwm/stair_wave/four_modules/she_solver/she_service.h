@@ -0,0 +1,85 @@
+#ifndef SHE_SERVICE_H
+#define SHE_SERVICE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include "she_solver.h"
+#include "interp_table_5d.h"
+
+// Background SHE refinement with a bounded result cache.
+//
+// The controller calls she_service_lookup() at every table refresh. On a
+// cache hit it gets solver-optimal angles for the quantized operating point;
+// on a miss it gets interpolated + compensated angles as before and the
+// point is queued for the worker. The controller never blocks: the queue is
+// single-producer/single-consumer and cache entries are read under a
+// per-entry sequence counter.
+
+#define SHE_CACHE_WAYS 4
+#define SHE_QUEUE_SIZE 16           // power of two
+#define SHE_C_QUANTUM 0.0005f       // ci quantization step
+#define SHE_M_QUANTUM 0.0005f       // m quantization step
+
+typedef struct {
+    atomic_uint seq;                // odd while the worker writes the entry
+    uint64_t key;                   // 0: empty
+    uint32_t age;                   // insertion stamp, oldest is replaced
+    float theta[NUM_DC_SOURCES];
+} SheCacheEntry;
+
+// c and theta are in controller order, theta[i] belongs to module i; the
+// worker sorts the pairs by c for she_solve and restores the order
+typedef struct {
+    uint64_t key;
+    float c[NUM_DC_SOURCES];        // quantized operating point
+    float m;
+    float theta[NUM_DC_SOURCES];    // warm start
+} SheRequest;
+
+typedef struct {
+    SheCacheEntry* entries;         // num_sets * SHE_CACHE_WAYS
+    uint32_t num_sets;              // power of two
+    uint32_t insert_stamp;
+
+    SheRequest queue[SHE_QUEUE_SIZE];
+    atomic_uint queue_head;         // written by the controller
+    atomic_uint queue_tail;         // written by the worker
+
+    pthread_t worker;
+    sem_t pending;
+    atomic_bool running;
+    bool thread_started;
+
+    atomic_uint hits;
+    atomic_uint misses;
+    atomic_uint dropped;            // queue full
+    atomic_uint solved;
+    atomic_uint rejected;           // solver missed the V1 tolerance
+} SheService;
+
+// capacity is rounded up to a power of two multiple of SHE_CACHE_WAYS
+int she_service_init(SheService* service, uint32_t capacity);
+
+// Start the worker thread; points queued before the start are picked up.
+// Without it, call she_service_process() from an idle loop instead.
+int she_service_start(SheService* service);
+void she_service_stop(SheService* service);
+void she_service_free(SheService* service);
+
+// Solve up to max_requests queued points; returns the number solved
+int she_service_process(SheService* service, int max_requests);
+
+// Cache probe only: true and theta filled on a hit
+bool she_service_find(SheService* service, const single_dc_source_t* dc_sources, float* theta);
+
+// Cache probe, falling back to table interpolation + V1 compensation and
+// queueing the point. Returns true when result holds cached solver angles.
+bool she_service_lookup(SheService* service,
+                        const SwitchingAnglesTable* table,
+                        single_dc_source_t* dc_sources,
+                        SwitchingAnglesResult* result);
+
+#endif // SHE_SERVICE_H
@@ -0,0 +1,183 @@
+#include "she_solver.h"
+#include <math.h>
+#include <string.h>
+
+#define SHE_NUM_HIGH_ORDERS 4                           // minimized harmonics after the eliminated ones
+#define SHE_MAX_RESIDUALS (SHE_MAX_MODULES + SHE_NUM_HIGH_ORDERS)
+
+// sqrt of the residual weights. N angles cannot always cancel the N-1 low
+// orders and hold V1 at once, so V1 is the stiffest term, the eliminated
+// orders a penalty, and the next four orders carry the generator's weight of 10.
+#define SHE_WEIGHT_V1 1000.0
+#define SHE_WEIGHT_LOW 30.0
+#define SHE_WEIGHT_HIGH 3.16227766
+
+// Residual h: order 1, then 3, 5, ... (2N-1) eliminated, then four more
+static inline int residual_order(int h) {
+    return h == 0 ? 1 : 2 * h + 1;
+}
+
+static inline double residual_weight(int h, int n) {
+    return h == 0 ? SHE_WEIGHT_V1 : (h < n ? SHE_WEIGHT_LOW : SHE_WEIGHT_HIGH);
+}
+
+static double residuals(const float* c, int n, double v1_desired, const double* theta,
+                        double* r, double jac[][SHE_MAX_MODULES]) {
+    double cost = 0.0;
+    for (int h = 0; h < n + SHE_NUM_HIGH_ORDERS; h++) {
+        int k = residual_order(h);
+        double w = residual_weight(h, n);
+        double vk = 0.0;
+        for (int i = 0; i < n; i++) {
+            vk += c[i] * cos(k * theta[i]);
+            if (jac) {
+                jac[h][i] = -w * c[i] * sin(k * theta[i]) / v1_desired;
+            }
+        }
+        vk /= k;
+        r[h] = w * (h == 0 ? vk - v1_desired : vk) / v1_desired;
+        cost += r[h] * r[h];
+    }
+    return cost;
+}
+
+// Clamp to [0, pi/2] and restore the ascending order
+static void project(double* theta, int n) {
+    for (int i = 0; i < n; i++) {
+        theta[i] = fmin(M_PI_2, fmax(0.0, theta[i]));
+    }
+    for (int i = 1; i < n; i++) {
+        double key = theta[i];
+        int j = i - 1;
+        while (j >= 0 && theta[j] > key) {
+            theta[j + 1] = theta[j];
+            j--;
+        }
+        theta[j + 1] = key;
+    }
+}
+
+// Cholesky solve of the damped normal equations; false if not SPD
+static int solve_spd(double a[][SHE_MAX_MODULES], double* b, int n) {
+    double l[SHE_MAX_MODULES][SHE_MAX_MODULES] = {{0.0}};
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j <= i; j++) {
+            double sum = a[i][j];
+            for (int k = 0; k < j; k++) sum -= l[i][k] * l[j][k];
+            if (i == j) {
+                if (sum <= 0.0) return 0;
+                l[i][i] = sqrt(sum);
+            } else {
+                l[i][j] = sum / l[j][j];
+            }
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        for (int k = 0; k < i; k++) b[i] -= l[i][k] * b[k];
+        b[i] /= l[i][i];
+    }
+    for (int i = n - 1; i >= 0; i--) {
+        for (int k = i + 1; k < n; k++) b[i] -= l[k][i] * b[k];
+        b[i] /= l[i][i];
+    }
+    return 1;
+}
+
+void she_evaluate_n(const float* c, int n, float m, const float* theta, SheSolveStats* stats) {
+    if (!c || !theta || !stats || n < 1 || n > SHE_MAX_MODULES) return;
+
+    const double v1_desired = M_PI * m;
+    double v1 = 0.0;
+    for (int i = 0; i < n; i++) v1 += c[i] * cos(theta[i]);
+
+    double low = 0.0, sum_sq = 0.0;
+    for (int k = 3; k <= 2 * n + 11; k += 2) {
+        double vk = 0.0;
+        for (int i = 0; i < n; i++) vk += c[i] * cos(k * theta[i]);
+        vk = fabs(vk) / k;
+        if (k <= 2 * n - 1) low = fmax(low, vk);
+        sum_sq += vk * vk;
+    }
+    stats->v1_error = (float)(100.0 * (v1 - v1_desired) / v1_desired);
+    stats->max_low_order = (float)(100.0 * low / fabs(v1));
+    stats->thd = (float)(100.0 * sqrt(sum_sq) / fabs(v1));
+}
+
+void she_evaluate(const float* c, float m, const float* theta, SheSolveStats* stats) {
+    she_evaluate_n(c, NUM_DC_SOURCES, m, theta, stats);
+}
+
+int she_solve_n(const float* c, int n, float m, float* theta, int max_iterations, SheSolveStats* stats) {
+    if (!c || !theta || m <= 0.0f || n < 1 || n > SHE_MAX_MODULES) return SHE_SOLVE_FAILED;
+
+    const int num_residuals = n + SHE_NUM_HIGH_ORDERS;
+    const double v1_desired = M_PI * m;
+    double x[SHE_MAX_MODULES];
+    for (int i = 0; i < n; i++) x[i] = theta[i];
+    project(x, n);
+
+    double r[SHE_MAX_RESIDUALS];
+    double jac[SHE_MAX_RESIDUALS][SHE_MAX_MODULES];
+    double cost = residuals(c, n, v1_desired, x, r, jac);
+    double lambda = 1e-3;
+    int it = 0;
+    int converged = 0;
+
+    while (it < max_iterations && !converged) {
+        double jtj[SHE_MAX_MODULES][SHE_MAX_MODULES];
+        double grad[SHE_MAX_MODULES];
+        for (int i = 0; i < n; i++) {
+            grad[i] = 0.0;
+            for (int h = 0; h < num_residuals; h++) grad[i] += jac[h][i] * r[h];
+            for (int j = 0; j < n; j++) {
+                double sum = 0.0;
+                for (int h = 0; h < num_residuals; h++) sum += jac[h][i] * jac[h][j];
+                jtj[i][j] = sum;
+            }
+        }
+
+        // Damp until a step lowers the cost
+        int accepted = 0;
+        while (lambda < 1e8) {
+            double a[SHE_MAX_MODULES][SHE_MAX_MODULES];
+            double step[SHE_MAX_MODULES];
+            for (int i = 0; i < n; i++) {
+                for (int j = 0; j < n; j++) a[i][j] = jtj[i][j];
+                a[i][i] += lambda * (jtj[i][i] + 1e-9);
+                step[i] = -grad[i];
+            }
+            if (solve_spd(a, step, n)) {
+                double trial[SHE_MAX_MODULES];
+                for (int i = 0; i < n; i++) trial[i] = x[i] + step[i];
+                project(trial, n);
+                double trial_r[SHE_MAX_RESIDUALS];
+                double trial_cost = residuals(c, n, v1_desired, trial, trial_r, NULL);
+                if (trial_cost < cost) {
+                    memcpy(x, trial, n * sizeof(double));
+                    accepted = 1;
+                    lambda = fmax(lambda / 3.0, 1e-9);
+                    double drop = cost - trial_cost;
+                    cost = residuals(c, n, v1_desired, x, r, jac);
+                    converged = drop < 1e-12 * (1.0 + cost);
+                    break;
+                }
+            }
+            lambda *= 4.0;
+        }
+        if (!accepted) break;
+        it++;
+    }
+
+    for (int i = 0; i < n; i++) theta[i] = (float)x[i];
+
+    SheSolveStats local;
+    she_evaluate_n(c, n, m, theta, &local);
+    local.iterations = it;
+    if (stats) *stats = local;
+    if (fabsf(local.v1_error) > SHE_V1_TOLERANCE) return SHE_SOLVE_FAILED;
+    return local.max_low_order <= SHE_LOW_ORDER_LIMIT ? SHE_SOLVE_OK : SHE_SOLVE_RELAXED;
+}
+
+int she_solve(const float* c, float m, float* theta, int max_iterations, SheSolveStats* stats) {
+    return she_solve_n(c, NUM_DC_SOURCES, m, theta, max_iterations, stats);
+}
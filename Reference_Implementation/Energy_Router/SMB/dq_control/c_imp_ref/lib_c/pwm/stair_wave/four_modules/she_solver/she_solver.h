@@ -0,0 +1,52 @@
+#ifndef SHE_SOLVER_H
+#define SHE_SOLVER_H
+
+#include "load_switching_angles_table_5d.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Native selective-harmonic-elimination solve for four modules, the same
+// problem generate_table_5d/norm_4module.py hands to IPOPT:
+//   V1 = sum c_i cos(theta_i) at pi * m (0.25% band),
+//   V3, V5, V7 within 0.1% of V1 (hard constraints),
+//   V9..V15 minimized, 0 <= theta_1 <= ... <= theta_4 <= pi/2,
+// with V_k = sum c_i cos(k theta_i) / k. Solved as a weighted least-squares
+// problem by Levenberg-Marquardt, warm-started from table angles.
+
+#define SHE_MAX_MODULES 8
+#define SHE_MAX_ITERATIONS 40
+#define SHE_V1_TOLERANCE 0.25f      // percent of pi * m
+#define SHE_LOW_ORDER_LIMIT 0.1f    // percent of V1, for each eliminated harmonic
+
+#define SHE_SOLVE_OK 0              // all constraints met
+#define SHE_SOLVE_RELAXED 1         // V1 met, V3..V7 minimized but above the limit
+#define SHE_SOLVE_FAILED -1         // V1 outside the tolerance
+
+typedef struct {
+    int iterations;
+    float v1_error;         // percent of pi * m
+    float max_low_order;    // max |V3|..|V(2N-1)| in percent of V1
+    float thd;              // percent, harmonics 3..(2N+11), 3..19 for four modules
+} SheSolveStats;
+
+// Refine theta (sorted ascending, paired with c sorted descending) in place.
+// Returns SHE_SOLVE_*; theta always holds the best point found.
+int she_solve(const float* c, float m, float* theta, int max_iterations, SheSolveStats* stats);
+
+// Quality figures of an angle set, as reported in SheSolveStats
+void she_evaluate(const float* c, float m, const float* theta, SheSolveStats* stats);
+
+// Same problem for N <= SHE_MAX_MODULES modules: V3..V(2N-1) are the
+// eliminated orders and the next four odd orders are minimized
+int she_solve_n(const float* c, int num_modules, float m, float* theta,
+                int max_iterations, SheSolveStats* stats);
+void she_evaluate_n(const float* c, int num_modules, float m, const float* theta,
+                    SheSolveStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SHE_SOLVER_H
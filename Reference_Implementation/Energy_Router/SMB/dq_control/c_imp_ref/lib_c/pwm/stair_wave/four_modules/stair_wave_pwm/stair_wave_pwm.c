@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "stair_wave_pwm.h"
+#include "../../../../misc/static_arena/static_arena.h"
 
 bool init_pwm_control(PWMControlState* state) {
     if (!state) {
@@ -19,9 +20,10 @@ bool init_pwm_control(PWMControlState* state) {
     state->dc_sources_sort_mode = SORT_BY_PREV_ORDER;
     state->is_initialized = false;
     state->phase_shift = 0.0f;
+    state->phase_step = 0;
 
-    // Allocate and initialize dc_sources
-    state->dc_sources = (single_dc_source_t*)malloc(state->num_modules * sizeof(single_dc_source_t));
+    // Allocate and initialize dc_sources (control arena, start-up only)
+    state->dc_sources = STATIC_ARENA_NEW(control_arena(), single_dc_source_t, state->num_modules);
     if (!state->dc_sources) {
         fprintf(stderr, "Failed to allocate dc_sources\n");
         return false;
@@ -42,7 +44,7 @@ bool init_pwm_control(PWMControlState* state) {
     }
 
     // Initialize pwm_out_state
-    state->pwm_out_state = (SwitchingStateResult*)malloc(sizeof(SwitchingStateResult));
+    state->pwm_out_state = STATIC_ARENA_NEW(control_arena(), SwitchingStateResult, 1);
     if (!state->pwm_out_state) {
         fprintf(stderr, "Failed to allocate pwm_out_state\n");
         cleanup_pwm_control(state);
@@ -55,8 +57,8 @@ bool init_pwm_control(PWMControlState* state) {
     state->angles_table = load_switching_angles_table_5d();
     if (!state->angles_table) {
         fprintf(stderr, "Failed to load angles table\n");
-        free(state->dc_sources);
         state->dc_sources = NULL;
+        state->pwm_out_state = NULL;
         return false;
     }
 
@@ -65,12 +67,15 @@ bool init_pwm_control(PWMControlState* state) {
     if (!state->table) {
         fprintf(stderr, "Failed to init stair wave table\n");
         free_switching_angles_table_5d(state->angles_table);
-        free(state->dc_sources);
         state->dc_sources = NULL;
+        state->pwm_out_state = NULL;
         state->angles_table = NULL;
         return false;
     }
 
+    stair_wave_cursor_seek(state->table, &state->cursor, 0);
+    initialize_pwm_ios();
+
     state->is_initialized = true;
     return true;
 }
@@ -88,16 +93,9 @@ void cleanup_pwm_control(PWMControlState* state) {
         state->angles_table = NULL;
     }
 
-    if (state->dc_sources) {
-        free(state->dc_sources);
-        state->dc_sources = NULL;
-    }
-
-    // Add cleanup for pwm_out_state
-    if (state->pwm_out_state) {
-        free(state->pwm_out_state);
-        state->pwm_out_state = NULL;
-    }
+    // dc_sources and pwm_out_state live in the control arena
+    state->dc_sources = NULL;
+    state->pwm_out_state = NULL;
 
     state->is_initialized = false;
 }
@@ -125,11 +123,20 @@ bool update_pwm_control(PWMControlState* state, single_dc_source_t* current_dc_s
     }
 
 
-    get_switching_state(state->table, 
-                        state->current_angle + state->phase_shift, 
-                        STAIR_WAVE_ANGLE_SAFE_MARGIN, 
-                        state->update_table, 
-                        state->pwm_out_state);
+    // Phase of this call: from the accumulator step, or from the angle
+    uint32_t phase = state->phase_step
+        ? state->cursor.phase + state->phase_step
+        : stair_wave_phase_from_angle(state->current_angle + state->phase_shift +
+                                      STAIR_WAVE_ANGLE_SAFE_MARGIN);
+
+    // New edges or an external angle jump: search once. Otherwise step the
+    // cursor, which crosses an edge only a few times per cycle.
+    if (state->update_1d_table || state->update_table) {
+        stair_wave_cursor_seek(state->table, &state->cursor, phase);
+    } else {
+        stair_wave_cursor_advance(state->table, &state->cursor, phase - state->cursor.phase);
+    }
+    stair_wave_cursor_result(state->table, &state->cursor, state->pwm_out_state);
 
 
     for (int i = 0; i < state->num_modules; i++) 
@@ -138,4 +145,54 @@ bool update_pwm_control(PWMControlState* state, single_dc_source_t* current_dc_s
     write_ios_from_dc_sources(state->dc_sources, state->num_modules);
     
     return true;
-}
\ No newline at end of file
+}
+
+// Packed GPIO word for a sum state, module roles as in the sorted order
+static pwm_word_t pack_sum_state(const PWMControlState* state, int sum_state) {
+    single_dc_source_t modules[MAX_NUM_MODULES];
+    SwitchingStateResult sum = { .state = sum_state };
+
+    for (int i = 0; i < state->num_modules; i++) {
+        modules[i] = state->dc_sources[i];
+        modules[i].pwm_state = STATE_ALL_OFF;
+    }
+    convert_system_state_to_module_state(modules, &sum, state->num_modules);
+
+    return write_ios_pack(modules, state->num_modules);
+}
+
+bool render_pwm_cycle(const PWMControlState* state, uint32_t cycle_ticks, GpioPatternBuffer* out) {
+    if (!state || !state->is_initialized || !state->table || !out || cycle_ticks == 0 ||
+        state->num_modules > MAX_NUM_MODULES) {
+        return false;
+    }
+
+    // Sum states span -num_modules .. num_modules; pack each once
+    pwm_word_t words[2 * MAX_NUM_MODULES + 1];
+    for (int s = -state->num_modules; s <= state->num_modules; s++) {
+        words[s + state->num_modules] = pack_sum_state(state, s);
+    }
+
+    // Walk the segments for one full turn of the phase accumulator
+    StairWaveCursor cursor;
+    stair_wave_cursor_seek(state->table, &cursor,
+                           stair_wave_phase_from_angle(state->phase_shift + STAIR_WAVE_ANGLE_SAFE_MARGIN));
+
+    gpio_pattern_begin(out, cycle_ticks);
+    uint64_t elapsed = 0;
+    while (elapsed < (1ull << 32)) {
+        int sum_state = state->table->sum_index[cursor.index];
+        if (sum_state < -state->num_modules) sum_state = -state->num_modules;
+        if (sum_state > state->num_modules) sum_state = state->num_modules;
+
+        uint32_t tick = (uint32_t)((elapsed * cycle_ticks) >> 32);
+        if (!gpio_pattern_append(out, tick, words[sum_state + state->num_modules])) {
+            return false;
+        }
+
+        uint32_t step = cursor.remaining ? cursor.remaining : 1;
+        elapsed += step;
+        stair_wave_cursor_advance(state->table, &cursor, step);
+    }
+    return true;
+}
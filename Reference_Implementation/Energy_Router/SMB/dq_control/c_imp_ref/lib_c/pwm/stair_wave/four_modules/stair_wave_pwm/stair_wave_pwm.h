@@ -5,8 +5,9 @@
 #include "../load_table_5d/load_switching_angles_table_5d.h"
 #include "../lookup_table_1d/dyn_stair_wave_table.h"
 #include "../../common/table_def/table_def.h"
-#include "../../common/write_ios/write_ios.h"
+#include "../../../common/write_ios/write_ios.h"
 #include "../../common/modulation_2pwm/modulation_2pwm.h"
+#include "../../../common/gpio_pattern/gpio_pattern.h"
 
 
 typedef struct {
@@ -23,13 +24,25 @@ typedef struct {
     bool update_1d_table;
     float phase_shift;
     SwitchingStateResult * pwm_out_state;
+    StairWaveCursor cursor;             // position in the 1D table (angle + shift + margin)
+    uint32_t phase_step;                // counts per call from the phase accumulator, 0: follow current_angle
 } PWMControlState;
 
 
+// Objects come from control_arena(); seal it once start-up is done so the
+// update path is guaranteed allocation-free
 bool init_pwm_control(PWMControlState* state);
 bool update_pwm_control( PWMControlState* state, 
                         single_dc_source_t * current_dc_sources);
 
+// Detaches the objects but does not return their memory: the control arena
+// is shared with the table loaders, so it only comes back with
+// static_arena_reset(control_arena()). Reset before initializing again.
 void cleanup_pwm_control(PWMControlState* state);
 
+// Render one grid cycle (current_angle 0 .. 2 pi, same shift and margin as
+// update_pwm_control) of packed H-bridge states into out, for timer+DMA
+// playback. Uses the current 1D table and module order; false on overflow.
+bool render_pwm_cycle(const PWMControlState* state, uint32_t cycle_ticks, GpioPatternBuffer* out);
+
 #endif // STAIR_WAVE_PWM_H
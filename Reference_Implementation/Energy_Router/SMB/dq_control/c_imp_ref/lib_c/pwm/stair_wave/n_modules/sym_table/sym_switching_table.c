@@ -0,0 +1,257 @@
+#include "sym_switching_table.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+SymSwitchingTable* create_sym_switching_table(int num_modules,
+                                              const float* c_values, int num_c_points,
+                                              const float* m_values, int num_m_points) {
+    if (!c_values || !m_values ||
+        num_modules < 1 || num_modules > SYM_TABLE_MAX_MODULES ||
+        num_c_points < 2 || num_c_points > SYM_TABLE_MAX_C_POINTS ||
+        num_m_points < 2 || num_m_points > SYM_TABLE_MAX_M_POINTS) {
+        fprintf(stderr, "Error: Invalid symmetric table dimensions (N=%d, P=%d, M=%d)\n",
+                num_modules, num_c_points, num_m_points);
+        return NULL;
+    }
+
+    SymSwitchingTable* table = (SymSwitchingTable*)calloc(1, sizeof(SymSwitchingTable));
+    if (!table) {
+        fprintf(stderr, "Error: Failed to allocate symmetric table\n");
+        return NULL;
+    }
+    table->num_modules = num_modules;
+    table->num_c_points = num_c_points;
+    table->num_m_points = num_m_points;
+    memcpy(table->c_values, c_values, num_c_points * sizeof(float));
+    memcpy(table->m_values, m_values, num_m_points * sizeof(float));
+
+    for (int a = 0; a < SYM_TABLE_MAX_C_POINTS + SYM_TABLE_MAX_MODULES; a++) {
+        table->binom[a][0] = 1;
+        for (int b = 1; b <= SYM_TABLE_MAX_MODULES; b++) {
+            table->binom[a][b] = (a == 0) ? 0 : table->binom[a - 1][b - 1] + table->binom[a - 1][b];
+        }
+    }
+    table->num_sorted = table->binom[num_c_points + num_modules - 1][num_modules];
+
+    table->angles = (float*)calloc(table->num_sorted * num_m_points * num_modules, sizeof(float));
+    if (!table->angles) {
+        fprintf(stderr, "Error: Failed to allocate symmetric table angles\n");
+        free(table);
+        return NULL;
+    }
+    return table;
+}
+
+void free_sym_switching_table(SymSwitchingTable* table) {
+    if (table) {
+        free(table->angles);
+        free(table);
+    }
+}
+
+// Combinatorial number system: s_k = idx[k] + (N-1-k) is strictly decreasing,
+// rank = sum_k C(s_k, N-k)
+size_t sym_table_rank(const SymSwitchingTable* table, const int* idx) {
+    const int n = table->num_modules;
+    size_t rank = 0;
+    for (int k = 0; k < n; k++) {
+        rank += table->binom[idx[k] + (n - 1 - k)][n - k];
+    }
+    return rank;
+}
+
+int sym_table_next_tuple(const SymSwitchingTable* table, int* idx) {
+    for (int k = table->num_modules - 1; k >= 0; k--) {
+        int limit = (k == 0) ? table->num_c_points - 1 : idx[k - 1];
+        if (idx[k] < limit) {
+            idx[k]++;
+            for (int j = k + 1; j < table->num_modules; j++) {
+                idx[j] = 0;
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
+
+SymSwitchingTable* sym_switching_table_from_5d(const SwitchingAnglesTable* dense) {
+    if (!dense) return NULL;
+
+    SymSwitchingTable* table = create_sym_switching_table(NUM_DC_SOURCES,
+                                                          dense->c1_values, N_POINTS_PER_CI,
+                                                          dense->m_values, N_MOD_INDEX);
+    if (!table) return NULL;
+
+    int idx[NUM_DC_SOURCES] = {0};
+    do {
+        size_t rank = sym_table_rank(table, idx);
+        for (int im = 0; im < N_MOD_INDEX; im++) {
+            memcpy(sym_table_entry(table, rank, im),
+                   dense->angles[idx[0]][idx[1]][idx[2]][idx[3]][im].theta,
+                   NUM_DC_SOURCES * sizeof(float));
+        }
+    } while (sym_table_next_tuple(table, idx));
+    return table;
+}
+
+int save_sym_switching_table(const SymSwitchingTable* table, const char* filename) {
+    if (!table || !filename) return -1;
+
+    FILE* fp = fopen(filename, "wb");
+    if (!fp) {
+        fprintf(stderr, "Error: Could not open file '%s'\n", filename);
+        return -1;
+    }
+    int32_t header[5] = {(int32_t)SYM_TABLE_MAGIC, SYM_TABLE_VERSION,
+                         table->num_modules, table->num_c_points, table->num_m_points};
+    size_t num_angles = table->num_sorted * table->num_m_points * table->num_modules;
+    int ok = fwrite(header, sizeof(int32_t), 5, fp) == 5 &&
+             fwrite(table->c_values, sizeof(float), table->num_c_points, fp) == (size_t)table->num_c_points &&
+             fwrite(table->m_values, sizeof(float), table->num_m_points, fp) == (size_t)table->num_m_points &&
+             fwrite(table->angles, sizeof(float), num_angles, fp) == num_angles;
+    fclose(fp);
+    if (!ok) {
+        fprintf(stderr, "Error: Failed to write symmetric table '%s'\n", filename);
+        return -1;
+    }
+    return 0;
+}
+
+SymSwitchingTable* load_sym_switching_table(const char* filename) {
+    if (!filename) return NULL;
+
+    FILE* fp = fopen(filename, "rb");
+    if (!fp) {
+        fprintf(stderr, "Error: Could not open file '%s'\n", filename);
+        return NULL;
+    }
+
+    int32_t header[5];
+    if (fread(header, sizeof(int32_t), 5, fp) != 5 ||
+        (uint32_t)header[0] != SYM_TABLE_MAGIC || header[1] != SYM_TABLE_VERSION) {
+        fprintf(stderr, "Error: '%s' is not a version %d symmetric table\n", filename, SYM_TABLE_VERSION);
+        fclose(fp);
+        return NULL;
+    }
+    if (header[3] < 2 || header[3] > SYM_TABLE_MAX_C_POINTS ||
+        header[4] < 2 || header[4] > SYM_TABLE_MAX_M_POINTS) {
+        fprintf(stderr, "Error: Invalid symmetric table dimensions (P=%d, M=%d)\n", header[3], header[4]);
+        fclose(fp);
+        return NULL;
+    }
+
+    float c_values[SYM_TABLE_MAX_C_POINTS];
+    float m_values[SYM_TABLE_MAX_M_POINTS];
+    if (fread(c_values, sizeof(float), header[3], fp) != (size_t)header[3] ||
+        fread(m_values, sizeof(float), header[4], fp) != (size_t)header[4]) {
+        fprintf(stderr, "Error: Failed to read parameter values\n");
+        fclose(fp);
+        return NULL;
+    }
+
+    SymSwitchingTable* table = create_sym_switching_table(header[2], c_values, header[3],
+                                                          m_values, header[4]);
+    if (!table) {
+        fclose(fp);
+        return NULL;
+    }
+    size_t num_angles = table->num_sorted * table->num_m_points * table->num_modules;
+    if (fread(table->angles, sizeof(float), num_angles, fp) != num_angles) {
+        fprintf(stderr, "Error: Failed to read symmetric table angles\n");
+        fclose(fp);
+        free_sym_switching_table(table);
+        return NULL;
+    }
+    fclose(fp);
+    return table;
+}
+
+void sym_table_sort_modules(const float* c, int num_modules, float* c_sorted, uint8_t* perm) {
+    // Insertion sort, N <= SYM_TABLE_MAX_MODULES
+    for (int i = 0; i < num_modules; i++) {
+        int j = i;
+        while (j > 0 && c_sorted[j - 1] < c[i]) {
+            c_sorted[j] = c_sorted[j - 1];
+            perm[j] = perm[j - 1];
+            j--;
+        }
+        c_sorted[j] = c[i];
+        perm[j] = (uint8_t)i;
+    }
+}
+
+// Lower cell index and fraction with the value clamped to the grid. Picks the
+// cell whose lower node is the largest one <= value, so the index is monotone
+// in value and sorted ratios give non-increasing indices.
+static void locate(float value, const float* grid, int size, int* idx, float* frac) {
+    if (value <= grid[0]) {
+        *idx = 0;
+        *frac = 0.0f;
+        return;
+    }
+    if (value >= grid[size - 1]) {
+        *idx = size - 2;
+        *frac = 1.0f;
+        return;
+    }
+    int i = 0;
+    while (i < size - 2 && grid[i + 1] <= value) {
+        i++;
+    }
+    *idx = i;
+    *frac = (value - grid[i]) / (grid[i + 1] - grid[i]);
+}
+
+void interpolate_sym_switching_angles(const SymSwitchingTable* table,
+                                      const float* c, float m,
+                                      float* theta, uint8_t* perm) {
+    if (!table || !c || !theta) return;
+
+    const int n = table->num_modules;
+    const int dims = n + 1;     // c1..cN, m
+    float c_sorted[SYM_TABLE_MAX_MODULES];
+    uint8_t order_perm[SYM_TABLE_MAX_MODULES];
+    sym_table_sort_modules(c, n, c_sorted, order_perm);
+
+    int idx[SYM_TABLE_MAX_MODULES + 1];
+    float frac[SYM_TABLE_MAX_MODULES + 1];
+    for (int k = 0; k < n; k++) {
+        locate(c_sorted[k], table->c_values, table->num_c_points, &idx[k], &frac[k]);
+    }
+    locate(m, table->m_values, table->num_m_points, &idx[n], &frac[n]);
+
+    // Axes in descending-fraction order. The sort is stable, so tied ratios
+    // step the larger module first and every corner stays an ordered tuple.
+    int order[SYM_TABLE_MAX_MODULES + 1];
+    for (int i = 0; i < dims; i++) {
+        int j = i;
+        while (j > 0 && frac[order[j - 1]] < frac[i]) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    float acc[SYM_TABLE_MAX_MODULES] = {0.0f};
+    float w = 1.0f - frac[order[0]];
+    for (int k = 0; k <= dims; k++) {
+        if (k > 0) {
+            idx[order[k - 1]]++;
+            w = (k < dims) ? frac[order[k - 1]] - frac[order[k]] : frac[order[k - 1]];
+        }
+        if (w == 0.0f) continue;
+        const float* a = sym_table_entry(table, sym_table_rank(table, idx), idx[n]);
+        for (int i = 0; i < n; i++) {
+            acc[i] += w * a[i];
+        }
+    }
+
+    for (int k = 0; k < n; k++) {
+        theta[order_perm[k]] = acc[k];
+    }
+    if (perm) {
+        memcpy(perm, order_perm, n * sizeof(uint8_t));
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef SYM_SWITCHING_TABLE_H
+#define SYM_SWITCHING_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../../four_modules/load_table_5d/load_switching_angles_table_5d.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Switching-angle table for N modules that stores only the ordered voltage
+// ratios c1 >= c2 >= ... >= cN. The optimizer sorts ci before solving, so any
+// permutation of a grid point carries the same sorted angles; a lookup sorts
+// the inputs, interpolates in the ordered region and maps the angles back to
+// the modules through the sort permutation.
+//
+// Stored points: C(P+N-1, N) * M instead of P^N * M
+// (P=5, M=6, N=8: 495 * 6 * 8 floats = 95 KB instead of 75 MB).
+
+#define SYM_TABLE_MAX_MODULES 8
+#define SYM_TABLE_MAX_C_POINTS 16
+#define SYM_TABLE_MAX_M_POINTS 32
+
+#define SYM_TABLE_MAGIC 0x544d5953u   // "SYMT"
+#define SYM_TABLE_VERSION 1
+
+typedef struct {
+    int num_modules;    // N
+    int num_c_points;   // P, grid points per voltage ratio (shared by all ci)
+    int num_m_points;   // M, grid points of the modulation index
+    size_t num_sorted;  // C(P+N-1, N) ordered ci tuples
+    float c_values[SYM_TABLE_MAX_C_POINTS];
+    float m_values[SYM_TABLE_MAX_M_POINTS];
+    // binom[a][b] = C(a, b), used to rank ordered index tuples
+    uint32_t binom[SYM_TABLE_MAX_C_POINTS + SYM_TABLE_MAX_MODULES][SYM_TABLE_MAX_MODULES + 1];
+    float* angles;      // [num_sorted][num_m_points][num_modules], sorted module order
+} SymSwitchingTable;
+
+// Allocate an empty table; angles are zeroed. Returns NULL on bad dimensions.
+SymSwitchingTable* create_sym_switching_table(int num_modules,
+                                              const float* c_values, int num_c_points,
+                                              const float* m_values, int num_m_points);
+void free_sym_switching_table(SymSwitchingTable* table);
+
+// Rank of a non-increasing index tuple idx[0] >= ... >= idx[N-1] in [0, num_sorted)
+size_t sym_table_rank(const SymSwitchingTable* table, const int* idx);
+
+// Step idx to the next non-increasing tuple in rank order. Start from all
+// zeros; returns 0 after the last tuple.
+int sym_table_next_tuple(const SymSwitchingTable* table, int* idx);
+
+// Angles of ordered tuple `rank` at modulation index grid point im
+static inline float* sym_table_entry(const SymSwitchingTable* table, size_t rank, int im) {
+    return table->angles + (rank * table->num_m_points + im) * table->num_modules;
+}
+
+// Extract the ordered part of the dense four-module table
+SymSwitchingTable* sym_switching_table_from_5d(const SwitchingAnglesTable* dense);
+
+// Binary file: magic, version, N, P, M (int32), c_values, m_values, angles (float32)
+int save_sym_switching_table(const SymSwitchingTable* table, const char* filename);
+SymSwitchingTable* load_sym_switching_table(const char* filename);
+
+// Sort c descending. perm[k] is the module index holding the k-th largest
+// ratio; equal ratios keep their module order.
+void sym_table_sort_modules(const float* c, int num_modules, float* c_sorted, uint8_t* perm);
+
+// Kuhn simplex interpolation over the N+1 axes (N+2 corners). c is given per
+// module in any order and clamped to the grid; theta is written per module.
+// perm (optional, N entries) receives the sort permutation.
+void interpolate_sym_switching_angles(const SymSwitchingTable* table,
+                                      const float* c, float m,
+                                      float* theta, uint8_t* perm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYM_SWITCHING_TABLE_H
@@ -0,0 +1,23 @@
+#!/bin/bash
+
+echo "Building adaptive switching table test..."
+
+gcc -O2 -o adaptive_table_test main.c \
+    ../../pwm/stair_wave/four_modules/load_table_5d/load_switching_angles_table_5d.c \
+    ../../pwm/stair_wave/four_modules/interp_table_5d/interp_table_5d.c \
+    ../../pwm/stair_wave/four_modules/she_solver/she_solver.c \
+    ../../pwm/stair_wave/four_modules/adaptive_table/adaptive_switching_table.c \
+    ../../pwm/stair_wave/four_modules/adaptive_table/adaptive_table_builder.c \
+    -I../../pwm/stair_wave/four_modules/load_table_5d \
+    -I../../pwm/stair_wave/four_modules/interp_table_5d \
+    -I../../pwm/stair_wave/four_modules/she_solver \
+    -I../../pwm/stair_wave/four_modules/adaptive_table \
+    -lm
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    ./adaptive_table_test
+else
+    echo "Build failed!"
+    exit 1
+fi
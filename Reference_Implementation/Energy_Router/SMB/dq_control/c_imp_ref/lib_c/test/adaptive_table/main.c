@@ -0,0 +1,225 @@
+#define _USE_MATH_DEFINES
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "../../pwm/stair_wave/four_modules/interp_table_5d/interp_table_5d.h"
+#include "../../pwm/stair_wave/four_modules/she_solver/she_solver.h"
+#include "../../pwm/stair_wave/four_modules/adaptive_table/adaptive_switching_table.h"
+
+#define NUM_TEST_POINTS 1000
+#define NUM_LOOKUPS 200000
+#define SAVE_FILE "adaptive_table_test.bin"
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static float rand_range(float lo, float hi) {
+    return lo + (hi - lo) * ((float)rand() / RAND_MAX);
+}
+
+static void sort_descending(float* c) {
+    for (int i = 1; i < NUM_DC_SOURCES; i++) {
+        for (int j = i; j > 0 && c[j - 1] < c[j]; j--) {
+            float t = c[j]; c[j] = c[j - 1]; c[j - 1] = t;
+        }
+    }
+}
+
+static float max_abs_diff(const float* a, const float* b) {
+    float e = 0.0f;
+    for (int i = 0; i < NUM_DC_SOURCES; i++) e = fmaxf(e, fabsf(a[i] - b[i]));
+    return e;
+}
+
+// Reference angles: solver warm-started from the looked-up angles
+static void reference_angles(const float* c, float m, const float* start, float* theta) {
+    SheSolveStats st;
+    memcpy(theta, start, NUM_DC_SOURCES * sizeof(float));
+    she_solve(c, m, theta, 4 * SHE_MAX_ITERATIONS, &st);
+}
+
+typedef struct {
+    double sum_angle, sum_v1, sum_thd;
+    float max_angle, max_v1;
+    int count;
+} LookupQuality;
+
+static void add_quality(LookupQuality* q, const float* c, float m, const float* theta, const float* ref) {
+    SheSolveStats st;
+    she_evaluate(c, m, theta, &st);
+    float e = max_abs_diff(theta, ref);
+    q->sum_angle += e;
+    q->max_angle = fmaxf(q->max_angle, e);
+    q->sum_v1 += fabsf(st.v1_error);
+    q->max_v1 = fmaxf(q->max_v1, fabsf(st.v1_error));
+    q->sum_thd += st.thd;
+    q->count++;
+}
+
+static void print_quality(const char* name, const LookupQuality* q) {
+    printf("%s: angle err mean %.4f max %.4f rad | |V1 err| mean %.3f%% max %.3f%% | THD %.2f%%\n",
+           name, q->sum_angle / q->count, q->max_angle, q->sum_v1 / q->count, q->max_v1,
+           q->sum_thd / q->count);
+}
+
+int main(void) {
+    int failures = 0;
+    AdaptiveTableConfig config;
+    adaptive_table_default_config(&config);
+
+    double t0 = now_sec();
+    AdaptiveSwitchingTable* table = build_adaptive_switching_table(&config);
+    double build_time = now_sec() - t0;
+    if (!table) return 1;
+    printf("Build: %.1f s, %u nodes, %.1f KB\n", build_time, table->num_nodes,
+           adaptive_table_memory(table) / 1024.0);
+
+    const SwitchingAnglesTable* dense = init_switching_angles_lookup_table();
+    if (dense) {
+        printf("Dense 5D table: %.1f KB of angles over c in [0.95, 1.05], m in [0.75, 1.00]\n",
+               5 * 5 * 5 * 5 * 6 * sizeof(AngleQuad) / 1024.0);
+    }
+
+    // Raw lookup quality (no V1 compensation) over the full adaptive range
+    // and over the dense table's range, against the solver at the same point
+    srand(7);
+    for (int range = 0; range < 2; range++) {
+        float c_lo = range ? 0.95f : config.c_lower, c_hi = range ? 1.05f : config.c_upper;
+        float m_lo = range ? 0.75f : config.m_lower, m_hi = range ? 1.00f : config.m_upper;
+        LookupQuality adaptive = {0}, dense_q = {0}, solved = {0};
+        for (int p = 0; p < NUM_TEST_POINTS; p++) {
+            float c[NUM_DC_SOURCES], theta[NUM_DC_SOURCES], ref[NUM_DC_SOURCES];
+            for (int i = 0; i < NUM_DC_SOURCES; i++) c[i] = rand_range(c_lo, c_hi);
+            sort_descending(c);
+            float m = rand_range(m_lo, m_hi);
+
+            if (adaptive_table_lookup_sorted(table, c, m, theta) != 0) failures++;
+            reference_angles(c, m, theta, ref);
+            add_quality(&adaptive, c, m, theta, ref);
+            add_quality(&solved, c, m, ref, ref);
+
+            if (range && dense) {
+                single_dc_source_t dc[NUM_DC_SOURCES];
+                float theta_dense[NUM_DC_SOURCES];
+                for (int i = 0; i < NUM_DC_SOURCES; i++) {
+                    dc[i].c = c[i];
+                    dc[i].m_common = m;
+                }
+                interpolate_switching_angles_5d_raw(dense, dc, INTERP_5D_SIMPLEX, theta_dense);
+                add_quality(&dense_q, c, m, theta_dense, ref);
+            }
+        }
+        printf("%s range, c in [%.2f, %.2f], m in [%.2f, %.2f]:\n",
+               range ? "Dense table" : "Adaptive table", c_lo, c_hi, m_lo, m_hi);
+        print_quality("  adaptive", &adaptive);
+        if (range && dense) print_quality("  dense   ", &dense_q);
+        print_quality("  solver  ", &solved);
+        if (adaptive.max_v1 > 5.0f) {
+            printf("FAIL: adaptive lookup V1 error above 5%%\n");
+            failures++;
+        }
+    }
+
+    // Unsorted input must match the sorted lookup, permuted back
+    for (int p = 0; p < NUM_TEST_POINTS; p++) {
+        float c[NUM_DC_SOURCES], sorted[NUM_DC_SOURCES];
+        float theta[NUM_DC_SOURCES], theta_sorted[NUM_DC_SOURCES];
+        for (int i = 0; i < NUM_DC_SOURCES; i++) c[i] = sorted[i] = rand_range(0.9f, 1.1f);
+        sort_descending(sorted);
+        float m = rand_range(0.5f, 1.0f);
+        adaptive_table_lookup(table, c, m, theta);
+        adaptive_table_lookup_sorted(table, sorted, m, theta_sorted);
+        for (int i = 0; i < NUM_DC_SOURCES; i++) {
+            int rank = 0;
+            for (int j = 0; j < NUM_DC_SOURCES; j++) {
+                if (c[j] > c[i] || (c[j] == c[i] && j < i)) rank++;
+            }
+            if (theta[i] != theta_sorted[rank]) {
+                printf("FAIL: unsorted lookup mismatch at point %d\n", p);
+                failures++;
+                break;
+            }
+        }
+    }
+
+    // Out-of-range inputs are clamped and flagged
+    float c_out[NUM_DC_SOURCES] = {1.2f, 1.0f, 1.0f, 0.8f};
+    float theta_out[NUM_DC_SOURCES];
+    int flags = adaptive_table_lookup(table, c_out, 1.1f, theta_out);
+    if (flags != (ADAPTIVE_CLAMPED_C | ADAPTIVE_CLAMPED_M)) {
+        printf("FAIL: out-of-range flags %d\n", flags);
+        failures++;
+    }
+
+    // Lookup timing
+    static float points[1024][NUM_DC_SOURCES + 1];
+    for (int p = 0; p < 1024; p++) {
+        for (int i = 0; i <= NUM_DC_SOURCES; i++) points[p][i] = rand_range(0.9f, 1.1f);
+        points[p][NUM_DC_SOURCES] = rand_range(0.5f, 1.0f);
+    }
+    float sink = 0.0f;
+    t0 = now_sec();
+    for (int k = 0; k < NUM_LOOKUPS; k++) {
+        float theta[NUM_DC_SOURCES];
+        const float* pt = points[k & 1023];
+        adaptive_table_lookup(table, pt, pt[NUM_DC_SOURCES], theta);
+        sink += theta[0];
+    }
+    printf("Lookup: %.1f ns (checksum %.1f)\n", (now_sec() - t0) / NUM_LOOKUPS * 1e9, sink);
+
+    // Save / load round trip
+    if (save_adaptive_switching_table(table, SAVE_FILE) != 0) {
+        printf("FAIL: save\n");
+        failures++;
+    } else {
+        AdaptiveSwitchingTable* loaded = load_adaptive_switching_table(SAVE_FILE);
+        if (!loaded) {
+            printf("FAIL: load\n");
+            failures++;
+        } else {
+            for (int p = 0; p < 1024; p++) {
+                float a[NUM_DC_SOURCES], b[NUM_DC_SOURCES];
+                adaptive_table_lookup(table, points[p], points[p][NUM_DC_SOURCES], a);
+                adaptive_table_lookup(loaded, points[p], points[p][NUM_DC_SOURCES], b);
+                if (memcmp(a, b, sizeof(a)) != 0) {
+                    printf("FAIL: loaded table differs at point %d\n", p);
+                    failures++;
+                    break;
+                }
+            }
+            free_adaptive_switching_table(loaded);
+        }
+        remove(SAVE_FILE);
+    }
+
+    free_adaptive_switching_table(table);
+
+    // A shallower build records its own depth, and the file keeps it
+    AdaptiveTableConfig shallow = config;
+    shallow.max_depth = 4;
+    shallow.max_leaves = 200;
+    AdaptiveSwitchingTable* small = build_adaptive_switching_table(&shallow);
+    if (!small || small->max_depth != shallow.max_depth) {
+        printf("FAIL: max_depth %u, configured %u\n", small ? small->max_depth : 0, shallow.max_depth);
+        failures++;
+    } else if (save_adaptive_switching_table(small, SAVE_FILE) == 0) {
+        AdaptiveSwitchingTable* loaded = load_adaptive_switching_table(SAVE_FILE);
+        if (!loaded || loaded->max_depth != shallow.max_depth) {
+            printf("FAIL: saved max_depth not %u\n", shallow.max_depth);
+            failures++;
+        }
+        if (loaded) free_adaptive_switching_table(loaded);
+        remove(SAVE_FILE);
+    }
+    if (small) free_adaptive_switching_table(small);
+
+    if (dense) cleanup_switching_angles_lookup_table(dense);
+
+    printf("%s (%d failures)\n", failures ? "FAILED" : "PASSED", failures);
+    return failures ? 1 : 0;
+}
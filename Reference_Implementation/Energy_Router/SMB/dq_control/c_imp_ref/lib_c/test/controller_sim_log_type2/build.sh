@@ -9,6 +9,7 @@ gcc -o grid_simulation \
     ./plant_simulator.c \
     ../../notch_filter/notch_filter.c \
     ../../log_data_rw/log_data_rw2.c \
+    ../../misc/static_arena/static_arena.c \
     ../../dq_controller_pid/dq_controller_pid.c \
     ../../beta_transform/beta_transform_1p.c \
     ../../dq_to_modulation/dq_to_modulation.c \
@@ -5,45 +5,48 @@
 
 void PlantSimulator_Init(PlantState* state, PlantParams* params) {
     state->current = 0.0f;
+    params->step = 0.0f;
+}
+
+// di/dt = (v_grid(t) - v_inv - R*i) / L, v_grid(t) = Vg_mag*cos(phi + omega*t), v_inv held over the step
+void PlantSimulator_Discretize(PlantParams* params, float step) {
+    double R = params->R;
+    double L = params->L;
+    double T = step;
+    double w = params->omega;
+
+    double decay = exp(-R * T / L);
+    double gain_inv = (R > 0.0) ? -expm1(-R * T / L) / R : T / L;
+
+    // (e^(jwT) - decay) / (R + jwL)
+    double num_re = cos(w * T) - decay;
+    double num_im = sin(w * T);
+    double den = R * R + w * w * L * L;
+    params->gain_grid_re = (float)((num_re * R + num_im * w * L) / den);
+    params->gain_grid_im = (float)((num_im * R - num_re * w * L) / den);
+    params->decay = (float)decay;
+    params->gain_inv = (float)gain_inv;
+    params->step = step;
 }
 
 float PlantSimulator_Update(PlantState* state, PlantParams* params, 
                           float v_inverter, float v_grid, 
                           bool cos_flag) {
-    // RK2 (Heun's method) integration
-    float plant_freq = params->plant_sim_freq;
-    float return_freq = params->control_update_freq;
-    float Vg_mag = params->Vg_mag;
-    float Vg_phase = params->Vg_phase;
-    float theta = Vg_phase;
-
-    int N = (int)(plant_freq / return_freq);
-    float mod = plant_freq  - (float)(N) * return_freq; 
-
-    if(abs(mod) > 0.0001f) {
-        printf("PlantSimulator_Update: plant_req must be a multiple of return_frq\n");
-        exit(1);
+    (void)v_grid;
+    float step = 1.0f / params->control_update_freq;
+    if (step != params->step) {
+        PlantSimulator_Discretize(params, step);
     }
-    for (int i = 0; i < N; i++) {
-        float v_grid_t = 0;
-        if(cos_flag)
-        {
-            v_grid_t = Vg_mag *cosf(theta + 2*M_PI * plant_freq * params->Ts * i) ;
-        }
-        else
-        {
-            v_grid_t = Vg_mag *sinf(theta + 2*M_PI * plant_freq * params->Ts * i) ;
-        }
 
-        float di_dt1 = (v_grid_t - v_inverter - params->R * state->current) / params->L;
-        // float di_dt1 = (v_inverter - v_grid_t - params->R * state->current) / params->L;
-
-        state->current += di_dt1 * params->Ts;
+    // e^(j*phi): sin(x) = cos(x - pi/2)
+    float c = cosf(params->Vg_phase);
+    float s = sinf(params->Vg_phase);
+    if (!cos_flag) {
+        float t = c;
+        c = s;
+        s = -t;
     }
+    float i_grid = params->Vg_mag * (c * params->gain_grid_re - s * params->gain_grid_im);
+    state->current = params->decay * state->current - params->gain_inv * v_inverter + i_grid;
     return state->current;
 }
-
-// float temp = state->current + di_dt1 * params->Ts;
-// float di_dt2 = (v_inverter - v_grid_t - params->R * temp) / params->L;
-
-// state->current += (di_dt1 + di_dt2) * params->Ts / 2.0f;
\ No newline at end of file
@@ -15,6 +15,15 @@ typedef struct {
     float control_update_freq; // Control update frequency
     float plant_sim_freq; // Plant simulation frequency
     float ratio_cntlFreqReduction; // Ratio of sensing frequency to control frequency
+
+    // Exact discretization over one control step, rebuilt when the step changes:
+    // i[k+1] = decay*i[k] - gain_inv*v_inv + Vg_mag*Re{e^(j*phi) * gain_grid},
+    // phi = Vg_phase for a cos grid, Vg_phase - pi/2 for a sin grid
+    float step;         // control step the terms below were built for
+    float decay;        // e^(-R*step/L)
+    float gain_inv;     // (1 - decay) / R, step / L when R = 0
+    float gain_grid_re; // (e^(j*omega*step) - decay) / (R + j*omega*L)
+    float gain_grid_im;
 } PlantParams;
 
 typedef struct {
@@ -22,7 +31,8 @@ typedef struct {
 } PlantState;
 
 void PlantSimulator_Init(PlantState* state, PlantParams* params);
+void PlantSimulator_Discretize(PlantParams* params, float step);
 float PlantSimulator_Update(PlantState* state, PlantParams* params, 
                           float v_inverter, float v_grid, bool cos_flag);
 
-#endif /* PLANT_SIMULATOR_H */
\ No newline at end of file
+#endif /* PLANT_SIMULATOR_H */
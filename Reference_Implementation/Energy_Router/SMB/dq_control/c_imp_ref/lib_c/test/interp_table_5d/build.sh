@@ -0,0 +1,18 @@
+#!/bin/bash
+
+echo "Building 5D interpolation benchmark..."
+
+gcc -O2 -o interp_table_5d_bench main.c \
+    ../../pwm/stair_wave/four_modules/load_table_5d/load_switching_angles_table_5d.c \
+    ../../pwm/stair_wave/four_modules/interp_table_5d/interp_table_5d.c \
+    -I../../pwm/stair_wave/four_modules/load_table_5d \
+    -I../../pwm/stair_wave/four_modules/interp_table_5d \
+    -lm
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running benchmark..."
+    ./interp_table_5d_bench
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,217 @@
+#define _USE_MATH_DEFINES
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "../../pwm/stair_wave/four_modules/load_table_5d/load_switching_angles_table_5d.h"
+#include "../../pwm/stair_wave/four_modules/interp_table_5d/interp_table_5d.h"
+
+#define NUM_TEST_POINTS 20000
+#define NUM_TIMING_REPEATS 20
+
+typedef struct {
+    const char* name;
+    Interp5dMethod method;
+} MethodCase;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static float rand_range(float lo, float hi) {
+    return lo + (hi - lo) * ((float)rand() / RAND_MAX);
+}
+
+// V1 error in percent, same definition as interp_table_5d.c
+static float v1_error_percent(const float* theta, const single_dc_source_t* dc_sources) {
+    float v1 = 0.0f;
+    for (int i = 0; i < NUM_DC_SOURCES; i++) {
+        v1 += dc_sources[i].c * cosf(theta[i]);
+    }
+    float v1_ideal = M_PI * dc_sources[0].m_common;
+    return 100.0f * (v1 - v1_ideal) / v1_ideal;
+}
+
+// Previous compensation (fixed-rate gradient descent), kept as reference
+static void compensate_gradient_reference(float* theta, const single_dc_source_t* dc) {
+    const float v1_ideal = M_PI * dc[0].m_common;
+    for (int it = 0; it < 7 && fabsf(v1_error_percent(theta, dc)) > 0.1f; it++) {
+        float v1 = 0.0f;
+        for (int i = 0; i < NUM_DC_SOURCES; i++) v1 += dc[i].c * cosf(theta[i]);
+        float error_factor = 2.0f * (v1 - v1_ideal);
+        for (int i = 0; i < NUM_DC_SOURCES; i++) {
+            theta[i] -= 0.1f * error_factor * (-dc[i].c * sinf(theta[i]));
+            theta[i] = fmaxf(0.0f, fminf(M_PI_2, theta[i]));
+        }
+    }
+}
+
+static float harmonic_amplitude(const float* theta, const single_dc_source_t* dc, int k) {
+    float vk = 0.0f;
+    for (int i = 0; i < NUM_DC_SOURCES; i++) vk += dc[i].c * cosf(k * theta[i]);
+    return fabsf(vk) / k;
+}
+
+typedef enum { CMP_GRADIENT, CMP_NEWTON, CMP_NEWTON_H57 } CompensationCase;
+
+static void run_compensation(CompensationCase which, float* th, single_dc_source_t* dc) {
+    static const int orders[2] = {5, 7};
+    float err = 0.0f;
+    switch (which) {
+        case CMP_GRADIENT:   compensate_gradient_reference(th, dc); break;
+        case CMP_NEWTON:     compensate_switching_angles(th, dc, &err); break;
+        case CMP_NEWTON_H57: compensate_switching_angles_harmonics(th, dc, orders, 2, &err); break;
+    }
+}
+
+int main(void) {
+    const SwitchingAnglesTable* table = init_switching_angles_lookup_table();
+    if (!table) {
+        printf("Failed to load switching angles table\n");
+        return 1;
+    }
+
+    // Random operating points inside the table range
+    single_dc_source_t* points = (single_dc_source_t*)malloc(NUM_TEST_POINTS * NUM_DC_SOURCES * sizeof(single_dc_source_t));
+    float* theta = (float*)malloc(NUM_TEST_POINTS * NUM_DC_SOURCES * sizeof(float));
+    if (!points || !theta) {
+        printf("Failed to allocate test points\n");
+        free(points);
+        free(theta);
+        cleanup_switching_angles_lookup_table(table);
+        return 1;
+    }
+
+    srand(1234);
+    memset(points, 0, NUM_TEST_POINTS * NUM_DC_SOURCES * sizeof(single_dc_source_t));
+    for (int p = 0; p < NUM_TEST_POINTS; p++) {
+        float m = rand_range(0.75f, 1.0f);
+        for (int i = 0; i < NUM_DC_SOURCES; i++) {
+            points[p * NUM_DC_SOURCES + i].c = rand_range(0.95f, 1.05f);
+            points[p * NUM_DC_SOURCES + i].m_common = m;
+        }
+    }
+
+    const MethodCase cases[] = {
+        {"taylor",      INTERP_5D_TAYLOR},
+        {"simplex",     INTERP_5D_SIMPLEX},
+        {"multilinear", INTERP_5D_MULTILINEAR},
+    };
+
+    printf("\n5D switching-angle interpolation benchmark (%d points)\n", NUM_TEST_POINTS);
+    printf("%-12s | %10s | %12s | %12s | %12s | %12s\n",
+           "method", "ns/lookup", "mean|V1| raw", "max|V1| raw", "mean|V1| cmp", "max|V1| cmp");
+    printf("-------------------------------------------------------------------------------------\n");
+
+    for (size_t k = 0; k < sizeof(cases) / sizeof(cases[0]); k++) {
+        volatile float sink = 0.0f;
+        double t0 = now_sec();
+        for (int r = 0; r < NUM_TIMING_REPEATS; r++) {
+            for (int p = 0; p < NUM_TEST_POINTS; p++) {
+                interpolate_switching_angles_5d_raw(table, &points[p * NUM_DC_SOURCES],
+                                                    cases[k].method, &theta[p * NUM_DC_SOURCES]);
+            }
+            sink += theta[r];
+        }
+        double ns = (now_sec() - t0) * 1e9 / ((double)NUM_TIMING_REPEATS * NUM_TEST_POINTS);
+        (void)sink;
+
+        double sum_raw = 0.0, sum_cmp = 0.0;
+        float max_raw = 0.0f, max_cmp = 0.0f;
+        for (int p = 0; p < NUM_TEST_POINTS; p++) {
+            float* th = &theta[p * NUM_DC_SOURCES];
+            single_dc_source_t* dc = &points[p * NUM_DC_SOURCES];
+
+            float err = fabsf(v1_error_percent(th, dc));
+            sum_raw += err;
+            if (err > max_raw) max_raw = err;
+
+            float cmp_err = 0.0f;
+            compensate_switching_angles(th, dc, &cmp_err);
+            err = fabsf(v1_error_percent(th, dc));
+            sum_cmp += err;
+            if (err > max_cmp) max_cmp = err;
+        }
+
+        printf("%-12s | %10.1f | %11.4f%% | %11.4f%% | %11.4f%% | %11.4f%%\n",
+               cases[k].name, ns,
+               sum_raw / NUM_TEST_POINTS, max_raw,
+               sum_cmp / NUM_TEST_POINTS, max_cmp);
+    }
+
+    // Compensation alone, starting from simplex angles
+    const char* cmp_names[3] = {"gradient", "newton", "newton+h5,7"};
+    float* base = malloc(NUM_TEST_POINTS * NUM_DC_SOURCES * sizeof(float));
+    float* work = malloc(NUM_TEST_POINTS * NUM_DC_SOURCES * sizeof(float));
+    for (int p = 0; p < NUM_TEST_POINTS; p++) {
+        interpolate_switching_angles_5d_raw(table, &points[p * NUM_DC_SOURCES], INTERP_5D_SIMPLEX,
+                                            &base[p * NUM_DC_SOURCES]);
+    }
+    printf("-------------------------------------------------------------------------------------\n");
+    printf("compensation |  ns/call   |  max|V1| cmp | mean d|V5|   | mean d|V7|\n");
+    for (int k = 0; k < 3; k++) {
+        double t0 = now_sec();
+        for (int r = 0; r < NUM_TIMING_REPEATS; r++) {
+            memcpy(work, base, NUM_TEST_POINTS * NUM_DC_SOURCES * sizeof(float));
+            for (int p = 0; p < NUM_TEST_POINTS; p++) {
+                run_compensation((CompensationCase)k, &work[p * NUM_DC_SOURCES], &points[p * NUM_DC_SOURCES]);
+            }
+        }
+        double ns = (now_sec() - t0) * 1e9 / ((double)NUM_TIMING_REPEATS * NUM_TEST_POINTS);
+
+        float max_v1 = 0.0f;
+        double d5 = 0.0, d7 = 0.0;
+        for (int p = 0; p < NUM_TEST_POINTS; p++) {
+            const float* th0 = &base[p * NUM_DC_SOURCES];
+            const float* th = &work[p * NUM_DC_SOURCES];
+            const single_dc_source_t* dc = &points[p * NUM_DC_SOURCES];
+            max_v1 = fmaxf(max_v1, fabsf(v1_error_percent(th, dc)));
+            d5 += fabsf(harmonic_amplitude(th, dc, 5) - harmonic_amplitude(th0, dc, 5));
+            d7 += fabsf(harmonic_amplitude(th, dc, 7) - harmonic_amplitude(th0, dc, 7));
+        }
+        printf("%-12s | %10.1f | %11.4f%% | %12.2e | %12.2e\n", cmp_names[k], ns, max_v1,
+               d5 / NUM_TEST_POINTS, d7 / NUM_TEST_POINTS);
+    }
+    free(base);
+    free(work);
+
+    // Full lookup path used by the stair-wave table update
+    SwitchingAnglesResult result;
+    double t0 = now_sec();
+    for (int p = 0; p < NUM_TEST_POINTS; p++) {
+        interpolate_switching_angles_5d(table, &points[p * NUM_DC_SOURCES], &result);
+    }
+    double ns = (now_sec() - t0) * 1e9 / NUM_TEST_POINTS;
+    printf("-------------------------------------------------------------------------------------\n");
+    printf("interpolate_switching_angles_5d (simplex + compensation): %.1f ns/lookup\n", ns);
+
+    // A compensation that cannot run still reports its error: NAN for
+    // non-finite input, the measured error when every angle sits at 0 (no
+    // V1 gradient)
+    int failures = 0;
+    const int orders57[2] = {5, 7};
+    float bad[NUM_DC_SOURCES] = {NAN, 0.3f, 0.6f, 0.9f};
+    float bad_err = 12345.0f;
+    compensate_switching_angles(bad, points, &bad_err);
+    if (!isnan(bad_err)) {
+        printf("FAIL: non-finite angles reported %.4f%% instead of NAN\n", bad_err);
+        failures++;
+    }
+    float zero[NUM_DC_SOURCES] = {0.0f};
+    float zero_err = 12345.0f;
+    compensate_switching_angles_harmonics(zero, points, orders57, 2, &zero_err);
+    if (!(fabsf(zero_err - v1_error_percent(zero, points)) < 1e-3f)) {
+        printf("FAIL: stuck compensation reported %.4f%%, angles give %.4f%%\n",
+               zero_err, v1_error_percent(zero, points));
+        failures++;
+    }
+    printf("%s (%d failures)\n", failures ? "FAILED" : "PASSED", failures);
+
+    free(points);
+    free(theta);
+    cleanup_switching_angles_lookup_table(table);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,16 @@
+#!/bin/bash
+
+echo "Building switching-angle table loader test..."
+
+gcc -O2 -o load_table_5d_test main.c \
+    ../../pwm/stair_wave/four_modules/load_table_5d/load_switching_angles_table_5d.c \
+    -I../../pwm/stair_wave/four_modules/load_table_5d \
+    -lm
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    ./load_table_5d_test
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,155 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../../pwm/stair_wave/four_modules/load_table_5d/load_switching_angles_table_5d.h"
+
+#define NUM_LOAD_REPEATS 200
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int same_table(const SwitchingAnglesTable* a, const SwitchingAnglesTable* b) {
+    return memcmp(a->angles, b->angles, sizeof(a->angles[0]) * N_POINTS_PER_CI) == 0 &&
+           memcmp(a->stats, b->stats, sizeof(SwitchingAnglesStats)) == 0 &&
+           memcmp(a->c1_values, b->c1_values, sizeof(a->c1_values)) == 0 &&
+           memcmp(a->c4_values, b->c4_values, sizeof(a->c4_values)) == 0 &&
+           memcmp(a->m_values, b->m_values, sizeof(a->m_values)) == 0;
+}
+
+// Legacy layout: dims, ci values, m values, theta1..theta4, thd, v1_error
+static int write_legacy(const SwitchingAnglesTable* t, const char* path) {
+    const size_t n = sizeof(t->stats->thd) / sizeof(float);
+    int32_t dims[2] = {N_POINTS_PER_CI, N_MOD_INDEX};
+    float* theta = (float*)malloc(n * sizeof(float));
+    FILE* fp = fopen(path, "wb");
+    int ok = fp && theta &&
+             fwrite(dims, sizeof(dims), 1, fp) == 1 &&
+             fwrite(t->c1_values, sizeof(t->c1_values), 1, fp) == 1 &&
+             fwrite(t->m_values, sizeof(t->m_values), 1, fp) == 1;
+    const AngleQuad* quads = &t->angles[0][0][0][0][0];
+    for (int dc = 0; ok && dc < NUM_DC_SOURCES; dc++) {
+        for (size_t i = 0; i < n; i++) theta[i] = quads[i].theta[dc];
+        ok = fwrite(theta, sizeof(float), n, fp) == n;
+    }
+    ok = ok && fwrite(t->stats, sizeof(SwitchingAnglesStats), 1, fp) == 1;
+    if (fp && fclose(fp) != 0) ok = 0;
+    free(theta);
+    return ok ? 0 : -1;
+}
+
+// Average load + free time of the table at the current default path
+static double time_load(void) {
+    double t0 = now_sec();
+    for (int i = 0; i < NUM_LOAD_REPEATS; i++) {
+        SwitchingAnglesTable* t = load_switching_angles_table_5d();
+        if (!t) return -1.0;
+        free_switching_angles_table_5d(t);
+    }
+    return (now_sec() - t0) * 1e6 / NUM_LOAD_REPEATS;
+}
+
+int main(void) {
+    int failures = 0;
+    const char* legacy_path = "/tmp/switching_angles_table_5d_legacy.bin";
+    const char* v2_path = "/tmp/switching_angles_table_5d_v2.bin";
+    const char* bad_path = "/tmp/switching_angles_table_5d_bad.bin";
+
+    // Shipped table next to the loader source is version 2 and mapped
+    SwitchingAnglesTable* shipped = load_switching_angles_table_5d();
+    if (!shipped) {
+        printf("FAIL: shipped table did not load\n");
+        return 1;
+    }
+    if (!shipped->image_mapped) {
+        printf("FAIL: shipped table is not a mapped version 2 file\n");
+        failures++;
+    }
+
+    // Legacy file: reordered on the heap, converts back to the same table
+    if (write_legacy(shipped, legacy_path) != 0) {
+        printf("FAIL: could not write legacy table\n");
+        return 1;
+    }
+    SwitchingAnglesTable* legacy = load_switching_angles_table_5d_from(legacy_path);
+    if (!legacy || legacy->image_mapped || !same_table(shipped, legacy)) {
+        printf("FAIL: legacy table differs from shipped table\n");
+        free_switching_angles_table_5d(shipped);
+        free_switching_angles_table_5d(legacy);
+        return 1;
+    }
+    free_switching_angles_table_5d(shipped);
+    if (save_switching_angles_table_5d(legacy, v2_path) != 0) {
+        printf("FAIL: could not write version 2 table\n");
+        return 1;
+    }
+
+    SwitchingAnglesTable* mapped = load_switching_angles_table_5d_from(v2_path);
+    if (!mapped || !same_table(legacy, mapped)) {
+        printf("FAIL: version 2 table differs from legacy table\n");
+        failures++;
+    } else {
+        printf("version 2 table: %zu bytes, mapped=%d, angles at +%zu\n",
+               mapped->image_size, mapped->image_mapped,
+               (size_t)((const char*)mapped->angles - (const char*)mapped->image));
+    }
+
+    // Corrupt one angle byte: verify must reject the file
+    FILE* fin = fopen(v2_path, "rb");
+    FILE* fout = fopen(bad_path, "wb");
+    if (fin && fout) {
+        int ch;
+        long pos = 0;
+        long flip = (long)((const char*)mapped->angles - (const char*)mapped->image) + 100;
+        while ((ch = fgetc(fin)) != EOF) {
+            fputc(pos++ == flip ? ch ^ 0x01 : ch, fout);
+        }
+    }
+    if (fin) fclose(fin);
+    if (fout) fclose(fout);
+    if (verify_switching_angles_table_5d(v2_path) != 0) {
+        printf("FAIL: valid table failed verification\n");
+        failures++;
+    }
+    if (verify_switching_angles_table_5d(bad_path) == 0) {
+        printf("FAIL: corrupted table passed verification\n");
+        failures++;
+    }
+
+    set_switching_angles_table_5d_path(legacy_path);
+    double legacy_us = time_load();
+
+    // Configured path, then environment variable
+    set_switching_angles_table_5d_path(v2_path);
+    double mapped_us = time_load();
+    SwitchingAnglesTable* configured = load_switching_angles_table_5d();
+    if (!configured || !configured->image_mapped) {
+        printf("FAIL: configured path not used\n");
+        failures++;
+    }
+    free_switching_angles_table_5d(configured);
+
+    set_switching_angles_table_5d_path(NULL);
+    setenv(SWITCHING_TABLE_PATH_ENV, v2_path, 1);
+    SwitchingAnglesTable* from_env = load_switching_angles_table_5d();
+    if (!from_env || !from_env->image_mapped) {
+        printf("FAIL: %s not used\n", SWITCHING_TABLE_PATH_ENV);
+        failures++;
+    }
+    free_switching_angles_table_5d(from_env);
+    unsetenv(SWITCHING_TABLE_PATH_ENV);
+
+    printf("load + free: legacy %.1f us, version 2 mapped %.1f us\n", legacy_us, mapped_us);
+
+    free_switching_angles_table_5d(mapped);
+    free_switching_angles_table_5d(legacy);
+    remove(legacy_path);
+    remove(v2_path);
+    remove(bad_path);
+
+    printf("\n%s\n", failures ? "Table loader test FAILED" : "Table loader test passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,15 @@
+#!/bin/bash
+
+echo "Building dynamic-cutoff LPF test..."
+
+# COMPILE_APP_Program: parameter errors are printed, not exit(1), so the
+# invalid-parameter checks can run
+gcc -O2 -Wall -Wextra -DCOMPILE_APP_Program -o lpf_dyn_coeff_test main.c -lm
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    ./lpf_dyn_coeff_test
+else
+    echo "Build failed!"
+    exit 1
+fi
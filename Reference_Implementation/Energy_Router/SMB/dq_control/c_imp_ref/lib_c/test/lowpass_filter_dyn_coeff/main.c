@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include "../../lowpass_filter_1storder/lowpass_filter_1storder_dyn_coeff.h"
+
+#define SAMPLE_RATE 1000.0f
+#define NUM_SAMPLES 4000
+#define TIMING_SAMPLES 10000000
+
+static float input[NUM_SAMPLES];
+
+static double now_s(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + 1e-9 * (double)t.tv_nsec;
+}
+
+// Sweep 5 -> 25 Hz against a filter rebuilt with tanf from the exact cutoff every sample
+static int check_sweep(void) {
+    const float fc_start = 5.0f, fc_end = 25.0f;
+    LowPassFilter1st_dyn_coeff dyn;
+    LowPassFilter1st ref, dynamics;
+    lpf_dyn_coeff_init(&dyn, SAMPLE_RATE, fc_start, fc_end);
+    lpf_init(&ref, SAMPLE_RATE, fc_start);
+    lpf_create_coeff(&dynamics, fc_start, SAMPLE_RATE);
+    const double r = -(double)dynamics.a1;
+
+    float worst = 0.0f;
+    int converged_at = -1;
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        lpf_create_coeff(&ref, (float)(fc_end + (fc_start - fc_end) * pow(r, i + 1)), SAMPLE_RATE);
+        float a = lpf_dyn_coeff_process(&dyn, input[i]);
+        float b = lpf_process(&ref, input[i]);
+        worst = fmaxf(worst, fabsf(a - b));
+        if (converged_at < 0 && dyn.converged) converged_at = i;
+    }
+    printf("sweep %.0f -> %.0f Hz: converged after %d samples (%d per knot), max diff to per-sample tanf %.1e\n",
+           fc_start, fc_end, converged_at, dyn.knot_stride, worst);
+    return (converged_at > 0 && worst < 1e-4f) ? 0 : 1;
+}
+
+// fc_start == fc_end (the PLL case) is converged from the start and equals a plain LPF
+static int check_fixed(void) {
+    LowPassFilter1st_dyn_coeff dyn;
+    LowPassFilter1st plain;
+    lpf_dyn_coeff_init(&dyn, SAMPLE_RATE, 5.0f, 5.0f);
+    lpf_init(&plain, SAMPLE_RATE, 5.0f);
+    int mismatches = 0;
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        if (lpf_dyn_coeff_process(&dyn, input[i]) != lpf_process(&plain, input[i])) mismatches++;
+    }
+    printf("fc_start == fc_end: converged at init %s, %d mismatches to lpf_process\n",
+           dyn.converged ? "yes" : "no", mismatches);
+    return (dyn.converged && mismatches == 0) ? 0 : 1;
+}
+
+// fc_end <= 0 or fs <= 0 has no sweep (its length is relative to fc_end):
+// rejected at init, frozen when built without the exit
+static int check_invalid(void) {
+    const float cases[3][3] = {{SAMPLE_RATE, 5.0f, 0.0f}, {SAMPLE_RATE, 5.0f, -2.0f}, {0.0f, 5.0f, 5.0f}};
+    int frozen = 0, nonfinite = 0;
+    for (int k = 0; k < 3; k++) {
+        LowPassFilter1st_dyn_coeff dyn;
+        lpf_dyn_coeff_init(&dyn, cases[k][0], cases[k][1], cases[k][2]);
+        if (dyn.converged && dyn.sweep_length == 0) frozen++;
+    }
+    LowPassFilter1st_dyn_coeff dyn;
+    lpf_dyn_coeff_init(&dyn, SAMPLE_RATE, 5.0f, 0.0f);
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        if (!isfinite(lpf_dyn_coeff_process(&dyn, input[i]))) nonfinite++;
+    }
+    printf("invalid cutoff / sample rate: %d of 3 frozen at init, %d non-finite outputs\n", frozen, nonfinite);
+    return (frozen == 3 && nonfinite == 0) ? 0 : 1;
+}
+
+static void time_paths(void) {
+    volatile float sink = 0.0f;
+    LowPassFilter1st_dyn_coeff dyn;
+    LowPassFilter1st plain, rebuilt;
+    lpf_dyn_coeff_init(&dyn, SAMPLE_RATE, 5.0f, 5.0f);
+    lpf_init(&plain, SAMPLE_RATE, 5.0f);
+    lpf_init(&rebuilt, SAMPLE_RATE, 5.0f);
+
+    double t0 = now_s();
+    for (int i = 0; i < TIMING_SAMPLES; i++) sink += lpf_dyn_coeff_process(&dyn, input[i % NUM_SAMPLES]);
+    double t_dyn = now_s() - t0;
+
+    t0 = now_s();
+    for (int i = 0; i < TIMING_SAMPLES; i++) sink += lpf_process(&plain, input[i % NUM_SAMPLES]);
+    double t_plain = now_s() - t0;
+
+    // What every sample used to cost: cutoff filter plus coefficient rebuild
+    float fc_sink = 5.0f;
+    t0 = now_s();
+    for (int i = 0; i < TIMING_SAMPLES; i++) {
+        lpf_create_coeff(&rebuilt, fc_sink, SAMPLE_RATE);
+        sink += lpf_process(&rebuilt, input[i % NUM_SAMPLES]);
+        fc_sink = 5.0f + 1e-7f * (float)(i & 1);
+    }
+    double t_rebuilt = now_s() - t0;
+
+    printf("per sample: converged dyn %.2f ns, plain %.2f ns, rebuilt every sample %.2f ns\n",
+           1e9 * t_dyn / TIMING_SAMPLES, 1e9 * t_plain / TIMING_SAMPLES, 1e9 * t_rebuilt / TIMING_SAMPLES);
+}
+
+int main(void) {
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        float t = i / SAMPLE_RATE;
+        input[i] = sinf(2.0f * (float)M_PI * 50.0f * t) + 0.3f * sinf(2.0f * (float)M_PI * 7.0f * t);
+    }
+    int failures = check_sweep();
+    failures += check_fixed();
+    failures += check_invalid();
+    time_paths();
+    printf("Dynamic LPF test %s\n", failures == 0 ? "PASSED" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,33 @@
+#!/bin/bash
+
+echo "Building MMC event timeline test..."
+
+# Port-word conversion: write_ios with the stair-wave module types (see
+# write_ios.h), convert_HBridgeState_to_binary from modulation_2pwm
+gcc -O2 -DPWM_STAIR_WAVE_TYPES -DMAX_NUM_MODULES=8 -o mmc_event_timeline_test main.c \
+    ../../pwm/phase_shift_wave/event_timeline/mmc_event_timeline.c \
+    ../../pwm/phase_shift_wave/event_timeline/mmc_timeline_port.c \
+    ../../pwm/phase_shift_wave/phase_shift_xmodule/phase_shift_xmodule.c \
+    ../../pwm/phase_shift_wave/common/pwm_table_loader/pwm_table_loader.c \
+    ../../pwm/common/write_ios/write_ios.c \
+    ../../pwm/common/gpio_pattern/gpio_pattern.c \
+    ../../pwm/stair_wave/common/modulation_2pwm/modulation_2pwm.c \
+    ../../pwm/stair_wave/four_modules/lookup_table_1d/dyn_stair_wave_table.c \
+    ../../pwm/stair_wave/four_modules/load_table_5d/load_switching_angles_table_5d.c \
+    ../../pwm/stair_wave/four_modules/interp_table_5d/interp_table_5d.c \
+    ../../misc/static_arena/static_arena.c \
+    -I../../pwm/phase_shift_wave/event_timeline \
+    -I../../pwm/phase_shift_wave/phase_shift_xmodule \
+    -I../../pwm/phase_shift_wave/common/pwm_table_loader \
+    -I../../pwm/common/write_ios \
+    -I../../pwm/common/gpio_pattern \
+    -I../../pwm/stair_wave/four_modules/load_table_5d \
+    -lm
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    ./mmc_event_timeline_test
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,141 @@
+#define _USE_MATH_DEFINES
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "../../pwm/phase_shift_wave/event_timeline/mmc_event_timeline.h"
+#include "../../pwm/phase_shift_wave/event_timeline/mmc_timeline_port.h"
+#include "../../misc/static_arena/static_arena.h"
+
+#define TABLE_FILE "../../pwm/phase_shift_wave/common/generate_table/pwm_tables.bin"
+#define NUM_MODULES 8
+#define MAX_EVENTS 1024
+#define NUM_SAMPLES 20000
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t status_word(const MMCPWMStatus* status) {
+    uint64_t word = 0;
+    for (uint32_t i = 0; i < status->num_modules; i++) {
+        word |= mmc_gpio_code(status->module_status[i]) << (2 * i);
+    }
+    return word;
+}
+
+// Port words of the timeline against write_ios_pack of the same module
+// states, bridges wired in reverse order
+static int check_port_words(const MMCTimeline* timeline) {
+    uint8_t io_index[NUM_MODULES];
+    for (int i = 0; i < NUM_MODULES; i++) io_index[i] = (uint8_t)(NUM_MODULES - 1 - i);
+    int mismatches = 0;
+    for (uint32_t k = 0; k <= timeline->num_events; k++) {
+        uint64_t word = k == 0 ? timeline->initial_word : timeline->events[k - 1].gpio_word;
+        single_dc_source_t dc[NUM_MODULES] = {0};
+        for (int i = 0; i < NUM_MODULES; i++) {
+            uint64_t code = (word >> (2 * i)) & 0x3u;
+            dc[i].io_index = io_index[i];
+            dc[i].pwm_state = code == MMC_GPIO_POSITIVE ? STATE_POSITIVE
+                            : (code == MMC_GPIO_NEGATIVE ? STATE_NEGATIVE : STATE_BYPASS);
+        }
+        pwm_word_t port = mmc_timeline_port_word(word, io_index, NUM_MODULES);
+        if (port != write_ios_pack(dc, NUM_MODULES)) {
+            if (mismatches < 5) {
+                printf("FAIL: word 0x%04llx port 0x%016llx pack 0x%016llx\n", (unsigned long long)word,
+                       (unsigned long long)port, (unsigned long long)write_ios_pack(dc, NUM_MODULES));
+            }
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+// Sample phases away from the coalescing windows and compare with the
+// per-module status query
+static int check_timeline(const PWMTables* tables, const MMCTimeline* timeline,
+                          const float* init_phases, float mod_index) {
+    int mismatches = 0;
+    for (int k = 0; k < NUM_SAMPLES; k++) {
+        float phase = (float)(2 * M_PI) * ((float)rand() / ((float)RAND_MAX + 1.0f));
+        uint32_t next = mmc_timeline_next_event(timeline, phase);
+        float after = next < timeline->num_events ? timeline->events[next].phase : (float)(2 * M_PI);
+        float before = next > 0 ? timeline->events[next - 1].phase + timeline->tolerance : 0.0f;
+        if (after - phase < 1e-4f || phase - before < 1e-4f) continue;
+
+        float next_time;
+        MMCPWMStatus status = get_mmc_pwm_status(tables, init_phases, NUM_MODULES, mod_index,
+                                                 phase, &next_time);
+        if (status_word(&status) != mmc_timeline_word_at(timeline, phase)) {
+            if (mismatches < 5) {
+                printf("FAIL: phase %.5f timeline 0x%04llx status 0x%04llx\n", phase,
+                       (unsigned long long)mmc_timeline_word_at(timeline, phase),
+                       (unsigned long long)status_word(&status));
+            }
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+int main(void) {
+    int failures = 0;
+    PWMTables tables = load_pwm_tables(TABLE_FILE);
+    if (!tables.intersection_table) {
+        printf("Failed to load %s\n", TABLE_FILE);
+        return 1;
+    }
+
+    static MMCPWMContext ctx;
+    static MMCEvent events[MAX_EVENTS];
+    if (!mmc_pwm_context_init(&ctx, &tables, NUM_MODULES)) return 1;
+
+    float init_phases[NUM_MODULES];
+    for (int i = 0; i < NUM_MODULES; i++) init_phases[i] = (float)(2 * M_PI * i / NUM_MODULES);
+
+    const float tolerances[] = {0.0f, 0.002f, 0.01f, 0.03f};
+    const float mod_indices[] = {0.55f, 0.8f, 0.95f};
+    srand(3);
+    for (size_t m = 0; m < sizeof(mod_indices) / sizeof(mod_indices[0]); m++) {
+        for (size_t t = 0; t < sizeof(tolerances) / sizeof(tolerances[0]); t++) {
+            MMCTimeline timeline;
+            mmc_timeline_init(&timeline, events, MAX_EVENTS, tolerances[t]);
+
+            const int runs = 200;
+            double t0 = now_sec();
+            int n = 0;
+            for (int r = 0; r < runs; r++) n = mmc_build_timeline(&ctx, init_phases, mod_indices[m], &timeline);
+            double build_us = (now_sec() - t0) / runs * 1e6;
+            if (n < 0) {
+                printf("FAIL: event buffer too small\n");
+                failures++;
+                continue;
+            }
+
+            // Events must be sorted and within one cycle
+            for (uint32_t k = 0; k < timeline.num_events; k++) {
+                const MMCEvent* e = &timeline.events[k];
+                if (e->phase < 0.0f || e->phase >= (float)(2 * M_PI) ||
+                    (k > 0 && e->phase <= timeline.events[k - 1].phase)) {
+                    printf("FAIL: event %u out of order (%.5f)\n", k, e->phase);
+                    failures++;
+                    break;
+                }
+            }
+
+            int mismatches = check_timeline(&tables, &timeline, init_phases, mod_indices[m]);
+            mismatches += check_port_words(&timeline);
+            failures += mismatches;
+            printf("m %.2f tol %.3f rad: %3u edges -> %3u events, build %.2f us, %d mismatches\n",
+                   mod_indices[m], tolerances[t], timeline.num_edges, timeline.num_events,
+                   build_us, mismatches);
+        }
+    }
+
+    free_pwm_tables(&tables);
+    static_arena_reset(control_arena());    // free only detaches the arena tables
+    printf("%s (%d failures)\n", failures ? "FAILED" : "PASSED", failures);
+    return failures ? 1 : 0;
+}
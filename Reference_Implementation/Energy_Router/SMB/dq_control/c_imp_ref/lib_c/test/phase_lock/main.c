@@ -81,7 +81,8 @@ int test_pll(void) {
 
         pll_update(&pll, grid_voltage);
         est_phase = pll.output_vco_phase;
-        true_phase_error = grid_phase - est_phase;
+        // est_phase wraps to [0, 2*pi) while grid_phase grows, so wrap the difference
+        true_phase_error = remainderf(grid_phase - est_phase, 2.0f * M_PI);
         pd_error = pll.output_phase_detector;
 
         // Write data to file
@@ -14,6 +14,7 @@ gcc $CFLAGS -o pll_test main.c \
     ../../phase_lock/pll_phase_detector/pll_phase_detector.c \
     ../../phase_lock/pll_controller_pi/pll_controller_pi.c \
     ../../phase_lock/pll_voltage_oscillator/vco_controller.c \
+    ../../phase_lock/pll_lock_detector/pll_lock_detector.c \
     ../../notch_filter/notch_filter.c \
     $LIBS
 
@@ -5,6 +5,7 @@
 #include <unistd.h>  // for getcwd
 #include <string.h>  // for strerror
 #include <stdlib.h>  // for malloc and realloc
+#include <time.h>
 
 #define TEST_DURATION_SEC 1.5f
 #define SAMPLING_FREQ 1000.0f  // 10kHz sampling
@@ -89,6 +90,60 @@ int read_log_data(const char* filename, LogData** data, int* num_samples) {
     return 0;
 }
 
+// Replays the log sample by sample and as blocks, compares the phase
+// tracks and times both over the log repeated REPLAY_REPEATS times
+#define REPLAY_REPEATS 1200
+#define REPLAY_BLOCK 1000
+
+int compare_block_replay(const LogData* log_data, int num_samples,
+                         float kd, float kp, float ki, float lpf_cutoff, float freq_max, float freq_min,
+                         float k0, float phase_0, const float* notch_ratios, int notch_config) {
+    size_t total = (size_t)num_samples * REPLAY_REPEATS;
+    float* voltage = malloc(total * sizeof(float));
+    float* phase_block = malloc(total * sizeof(float));
+    float* phase_scalar = malloc(total * sizeof(float));
+    if (!voltage || !phase_block || !phase_scalar) {
+        free(voltage); free(phase_block); free(phase_scalar);
+        return -1;
+    }
+    for (size_t i = 0; i < total; i++) voltage[i] = log_data[i % (size_t)num_samples].current_val;
+
+    PLL scalar, block;
+    pll_init(&scalar, SAMPLING_FREQ, NOMINAL_FREQ, notch_ratios, notch_config, lpf_cutoff,
+             kd, kp, ki, freq_max, freq_min, k0, phase_0);
+    block = scalar;
+
+    clock_t start = clock();
+    for (size_t i = 0; i < total; i++) {
+        pll_update(&scalar, voltage[i]);
+        phase_scalar[i] = scalar.output_vco_phase;
+    }
+    double scalar_s = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    PLLBlockOutputs outputs = { .phase = phase_block };
+    start = clock();
+    for (size_t i = 0; i < total; i += REPLAY_BLOCK) {
+        size_t n = total - i < REPLAY_BLOCK ? total - i : REPLAY_BLOCK;
+        outputs.phase = phase_block + i;
+        pll_process_block(&block, voltage + i, n, &outputs);
+    }
+    double block_s = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    // Both phases wrap at 2*pi, so compare the wrapped difference
+    double max_diff = 0.0;
+    for (size_t i = 0; i < total; i++) {
+        double d = remainder((double)phase_block[i] - (double)phase_scalar[i], 2.0 * M_PI);
+        if (fabs(d) > max_diff) max_diff = fabs(d);
+    }
+
+    double hours = (double)total / SAMPLING_FREQ / 3600.0;
+    printf("Block replay: %zu samples (%.1f h of data), scalar %.3f s, block %.3f s (%.1fx), max phase diff %.2e rad\n",
+           total, hours, scalar_s, block_s, scalar_s / block_s, max_diff);
+
+    free(voltage); free(phase_block); free(phase_scalar);
+    return max_diff < 1e-3 ? 0 : -1;
+}
+
 int test_pll(void) {
     PLL pll;
     int result;
@@ -183,9 +238,6 @@ int test_pll(void) {
         }
 
         true_phase_error /=  M_PI;
-        printf("True phase error: %f\n", true_phase_error);
-        printf("Grid phase: %f\n", gt_phase);
-        printf("Est phase: %f\n", est_phase);
 
         pd_error = pll.output_phase_detector;
 
@@ -208,9 +260,14 @@ int test_pll(void) {
     fflush(fp);
     fclose(fp);
     
+    // Same log through pll_process_block
+    result = compare_block_replay(log_data, total_samples, kd, kp, ki, lpf_cutoff, freq_max, freq_min,
+                                  k0, phase_0, notch_ratios, notch_config);
+
     // Cleanup
     free(log_data);
     pll_cleanup(&pll);
+    if (result != 0) return result;
     
     printf("Test completed. Processed %d samples.\n", num_log_samples);
     return 0;
@@ -11,6 +11,7 @@ SOURCES="
     ../../phase_lock/pll_phase_detector/pll_phase_detector.c
     ../../phase_lock/pll_controller_pi/pll_controller_pi.c
     ../../phase_lock/pll_voltage_oscillator/vco_controller.c
+    ../../phase_lock/pll_lock_detector/pll_lock_detector.c
     ../../log_data_rw/log_data_rw.c
     ../../notch_filter/notch_filter.c
 "
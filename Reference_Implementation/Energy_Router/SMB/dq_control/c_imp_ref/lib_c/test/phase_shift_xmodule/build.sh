@@ -0,0 +1,19 @@
+#!/bin/bash
+
+echo "Building phase-shift MMC status test..."
+
+gcc -O2 -o phase_shift_xmodule_test main.c \
+    ../../pwm/phase_shift_wave/phase_shift_xmodule/phase_shift_xmodule.c \
+    ../../pwm/phase_shift_wave/common/pwm_table_loader/pwm_table_loader.c \
+    ../../misc/static_arena/static_arena.c \
+    -I../../pwm/phase_shift_wave/phase_shift_xmodule \
+    -I../../pwm/phase_shift_wave/common/pwm_table_loader \
+    -lm
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    ./phase_shift_xmodule_test
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,113 @@
+#define _USE_MATH_DEFINES
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <time.h>
+#include "../../pwm/phase_shift_wave/phase_shift_xmodule/phase_shift_xmodule.h"
+#include "../../misc/static_arena/static_arena.h"
+
+#define TABLE_FILE "../../pwm/phase_shift_wave/common/generate_table/pwm_tables.bin"
+#define NUM_MODULES 8
+#define NUM_STEPS 20000
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Original algorithm: bilinear row per module and a linear scan
+static void reference_status(const PWMTables* tables, const float* init_phases, float mod_index,
+                             float current_phase, int8_t* status, float* next_interrupt_time) {
+    float row[MMC_MAX_POINTS_PER_CYCLE];
+    *next_interrupt_time = FLT_MAX;
+    for (uint32_t i = 0; i < NUM_MODULES; i++) {
+        get_intersection_1d_table(tables, mod_index, init_phases[i], row);
+        float phase = fmod(current_phase + init_phases[i], 2 * M_PI);
+        if (phase < 0) phase += 2 * M_PI;
+        uint32_t idx = 0;
+        while (idx < tables->points_per_cycle - 1 && row[idx] <= phase) idx++;
+        if (idx > 0) idx--;
+        float v = get_table_value(tables->pwm_value_table, tables->n_init_phase, tables->n_mod_index,
+                                  tables->points_per_cycle, i % tables->n_init_phase,
+                                  (uint32_t)(mod_index * (tables->n_mod_index - 1)), idx);
+        status[i] = (v > 0.5) ? 1 : ((v < -0.5) ? -1 : 0);
+        float t = row[idx + 1] - phase;
+        if (t < 0) t += 2 * M_PI;
+        if (t < *next_interrupt_time) *next_interrupt_time = t;
+    }
+}
+
+int main(void) {
+    int failures = 0;
+    PWMTables tables = load_pwm_tables(TABLE_FILE);
+    if (!tables.intersection_table) {
+        printf("Failed to load %s\n", TABLE_FILE);
+        return 1;
+    }
+    printf("Tables: %u init phases, %u modulation indices, %u points per cycle\n",
+           tables.n_init_phase, tables.n_mod_index, tables.points_per_cycle);
+
+    float init_phases[NUM_MODULES];
+    for (int i = 0; i < NUM_MODULES; i++) init_phases[i] = (float)(2 * M_PI * i / NUM_MODULES);
+
+    static MMCPWMContext ctx;
+    if (!mmc_pwm_context_init(&ctx, &tables, NUM_MODULES)) {
+        printf("FAIL: context init\n");
+        return 1;
+    }
+
+    // Phase sweep over several cycles, modulation index stepped now and then
+    float mod_index = 0.8f;
+    float phase = 0.0f;
+    const float step = (float)(2 * M_PI / 400);
+    for (int k = 0; k < NUM_STEPS; k++) {
+        if (k % 2000 == 1999) mod_index = 0.5f + 0.45f * ((float)rand() / RAND_MAX);
+        phase = fmodf(phase + step, (float)(2 * M_PI));
+
+        int8_t expected[NUM_MODULES];
+        float expected_next, next_stateless, next_cached;
+        reference_status(&tables, init_phases, mod_index, phase, expected, &expected_next);
+        MMCPWMStatus stateless = get_mmc_pwm_status(&tables, init_phases, NUM_MODULES, mod_index,
+                                                    phase, &next_stateless);
+        const MMCPWMStatus* cached = mmc_pwm_context_update(&ctx, init_phases, mod_index, phase,
+                                                            &next_cached);
+        if (memcmp(expected, stateless.module_status, NUM_MODULES) != 0 ||
+            memcmp(expected, cached->module_status, NUM_MODULES) != 0 ||
+            expected_next != next_stateless || expected_next != next_cached) {
+            if (failures < 5) {
+                printf("FAIL: step %d phase %.4f m %.3f next %.5f / %.5f / %.5f\n",
+                       k, phase, mod_index, expected_next, next_stateless, next_cached);
+            }
+            failures++;
+        }
+    }
+    printf("Checked %d steps, %u row rebuilds (%d modules)\n", NUM_STEPS, ctx.rebuilds, NUM_MODULES);
+
+    // Timing at a fixed modulation index
+    const int runs = 200000;
+    float sink = 0.0f, next;
+    double t0 = now_sec();
+    for (int k = 0; k < runs; k++) {
+        phase = fmodf(phase + step, (float)(2 * M_PI));
+        MMCPWMStatus st = get_mmc_pwm_status(&tables, init_phases, NUM_MODULES, mod_index, phase, &next);
+        sink += next + st.module_status[0];
+    }
+    double stateless_ns = (now_sec() - t0) / runs * 1e9;
+    t0 = now_sec();
+    for (int k = 0; k < runs; k++) {
+        phase = fmodf(phase + step, (float)(2 * M_PI));
+        const MMCPWMStatus* st = mmc_pwm_context_update(&ctx, init_phases, mod_index, phase, &next);
+        sink += next + st->module_status[0];
+    }
+    double cached_ns = (now_sec() - t0) / runs * 1e9;
+    printf("Status query: %.1f ns stateless, %.1f ns cached (checksum %.1f)\n",
+           stateless_ns, cached_ns, sink);
+
+    free_pwm_tables(&tables);
+    static_arena_reset(control_arena());    // free only detaches the arena tables
+    printf("%s (%d failures)\n", failures ? "FAILED" : "PASSED", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,13 @@
+#!/bin/bash
+
+echo "Building plant simulator test..."
+
+gcc -O2 -Wall -Wextra -o plant_simulator_test main.c ../controller_sim/plant_simulator.c -lm
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    ./plant_simulator_test
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include "../controller_sim/plant_simulator.h"
+
+#define SIM_TIME 0.2
+#define RK4_STEP 1e-7
+#define TIMING_STEPS 2000000
+
+static const float R = 0.1f, L = 0.005f, F = 50.0f, VG_RMS = 230.0f;
+
+static double now_s(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + 1e-9 * (double)t.tv_nsec;
+}
+
+// Inverter voltage held over control step k
+static float v_inv_at(double phase) {
+    return 0.95f * VG_RMS * sqrtf(2.0f) * (float)cos(phase + 0.15);
+}
+
+static double didt(double i, double v_inv, double phase) {
+    return (v_inv - VG_RMS * sqrt(2.0) * cos(phase) - R * i) / L;
+}
+
+// Exact step against RK4 on the continuous model, from a cold start
+static int check_step(float control_freq) {
+    PlantParams params = {
+        .R = R, .L = L, .omega = 2.0f * (float)M_PI * F,
+        .Vg_rms = VG_RMS, .Vg_mag = VG_RMS * sqrtf(2.0f),
+        .control_update_freq = control_freq
+    };
+    PlantState state;
+    PlantSimulator_Init(&state, &params);
+
+    const double T = 1.0 / control_freq, w = 2.0 * M_PI * F;
+    const int steps = (int)(SIM_TIME / T + 0.5);
+    const int sub = (int)(T / RK4_STEP + 0.5);
+    const double h = T / sub;
+    double i_ref = 0.0, worst = 0.0, peak = 0.0;
+    for (int k = 0; k < steps; k++) {
+        double phase0 = w * k * T;
+        float v_inv = v_inv_at(phase0);
+        for (int m = 0; m < sub; m++) {
+            double p = phase0 + w * m * h;
+            double k1 = didt(i_ref, v_inv, p);
+            double k2 = didt(i_ref + 0.5 * h * k1, v_inv, p + 0.5 * w * h);
+            double k3 = didt(i_ref + 0.5 * h * k2, v_inv, p + 0.5 * w * h);
+            double k4 = didt(i_ref + h * k3, v_inv, p + w * h);
+            i_ref += h / 6.0 * (k1 + 2.0 * k2 + 2.0 * k3 + k4);
+        }
+        params.Vg_phase = (float)fmod(phase0, 2.0 * M_PI);
+        float i = PlantSimulator_Update(&state, &params, v_inv, 0.0f);
+        worst = fmax(worst, fabs(i - i_ref));
+        peak = fmax(peak, fabs(i_ref));
+    }
+    printf("step %8.1f us: %5d steps, peak %6.2f A, max error %.1e A\n",
+           1e6 * T, steps, peak, worst);
+    return worst < 1e-4 * peak ? 0 : 1;
+}
+
+// The former plant: 100 forward-Euler substeps per control step, a cosf each
+static float euler_substeps(float* current, float v_inv, float phase, float ts) {
+    const float w = 2.0f * (float)M_PI * F, v_mag = VG_RMS * sqrtf(2.0f);
+    for (int n = 0; n < 100; n++) {
+        float v_grid = v_mag * cosf(phase + w * ts * n);
+        *current += (v_inv - v_grid - R * *current) / L * ts;
+    }
+    return *current;
+}
+
+static void time_paths(void) {
+    PlantParams params = {
+        .R = R, .L = L, .omega = 2.0f * (float)M_PI * F,
+        .Vg_rms = VG_RMS, .Vg_mag = VG_RMS * sqrtf(2.0f),
+        .control_update_freq = 10000.0f
+    };
+    PlantState state;
+    PlantSimulator_Init(&state, &params);
+    volatile float sink = 0.0f;
+
+    double t0 = now_s();
+    for (int k = 0; k < TIMING_STEPS; k++) {
+        params.Vg_phase = 0.0314159f * (float)(k % 200);
+        sink += PlantSimulator_Update(&state, &params, 300.0f * (float)(k & 1), 0.0f);
+    }
+    double t_exact = now_s() - t0;
+
+    float current = 0.0f;
+    t0 = now_s();
+    for (int k = 0; k < TIMING_STEPS / 100; k++) {
+        sink += euler_substeps(&current, 300.0f * (float)(k & 1), 0.0314159f * (float)(k % 200), 1e-6f);
+    }
+    double t_euler = (now_s() - t0) * 100.0;
+
+    printf("per control step: exact %.1f ns, 100 Euler substeps %.1f ns\n",
+           1e9 * t_exact / TIMING_STEPS, 1e9 * t_euler / TIMING_STEPS);
+}
+
+int main(void) {
+    int failures = 0;
+    failures += check_step(10000.0f);
+    failures += check_step(2000.0f);
+    failures += check_step(500.0f);
+    time_paths();
+    printf("Plant simulator test %s\n", failures == 0 ? "PASSED" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,22 @@
+#!/bin/bash
+
+echo "Building PLL bank test..."
+
+# -march=native lets the 8-lane groups use AVX where the host has it
+gcc -O2 -march=native -Wall -Wextra -o pll_bank_test main.c \
+    ../../phase_lock/pll_bank/pll_bank.c \
+    ../../phase_lock/pll.c \
+    ../../phase_lock/pll_phase_detector/pll_phase_detector.c \
+    ../../phase_lock/pll_controller_pi/pll_controller_pi.c \
+    ../../phase_lock/pll_voltage_oscillator/vco_controller.c \
+    ../../phase_lock/pll_lock_detector/pll_lock_detector.c \
+    ../../notch_filter/notch_filter.c \
+    -lm
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    ./pll_bank_test
+else
+    echo "Build failed!"
+    exit 1
+fi
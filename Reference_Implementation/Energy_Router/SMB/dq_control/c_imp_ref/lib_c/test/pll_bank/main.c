@@ -0,0 +1,111 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "../../phase_lock/pll_bank/pll_bank.h"
+
+#define SAMPLING_FREQ 1000.0f
+#define NOMINAL_FREQ 50.0f
+#define NUM_SAMPLES 20000
+
+static PLLBank bank;
+static float voltage[NUM_SAMPLES][PLL_BANK_MAX_CHANNELS];
+static float bank_phase[NUM_SAMPLES][PLL_BANK_MAX_CHANNELS];
+
+// Channels differ in gains and notch sets, as feeders and SMBs would
+static void init_channel(PLL* pll, int channel) {
+    static const int notch_configs[3] = {
+        NOTCH_2ND | NOTCH_3RD, NOTCH_3RD | NOTCH_5TH, NOTCH_2ND | NOTCH_3RD | NOTCH_5TH
+    };
+    float notch_ratios[5] = {0.90f, 0.90f, 0.90f, 0.90f, 0.90f};
+    float kp = (channel % 2) ? 2.0f : 1.5f;
+    float ki = (channel % 4 < 2) ? 10.0f : 8.0f;
+    pll_init(pll, SAMPLING_FREQ, NOMINAL_FREQ, notch_ratios, notch_configs[channel % 3],
+             5.0f, 1.0f / 3.0f, kp, ki, 55.0f, 45.0f, 1.0f, 0.0f);
+}
+
+// Grid voltage with its own frequency, phase, 3rd harmonic and noise per channel
+static void make_signals(int num_channels) {
+    srand(3);
+    for (int c = 0; c < num_channels; c++) {
+        float f = 49.6f + 0.8f * (float)c / (float)num_channels;
+        float p = 6.2831853f * (float)rand() / (float)RAND_MAX;
+        for (int i = 0; i < NUM_SAMPLES; i++) {
+            float t = (float)i / SAMPLING_FREQ;
+            float noise = 0.05f * ((float)rand() / (float)RAND_MAX - 0.5f);
+            voltage[i][c] = sinf(6.2831853f * f * t + p) + 0.1f * sinf(3.0f * (6.2831853f * f * t + p)) + noise;
+        }
+    }
+}
+
+static int check_against_scalar(int num_channels) {
+    pll_bank_init(&bank);
+    for (int c = 0; c < num_channels; c++) {
+        PLL pll;
+        init_channel(&pll, c);
+        pll_bank_load(&bank, c, &pll);
+    }
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        pll_bank_step(&bank, voltage[i]);
+        for (int c = 0; c < num_channels; c++) bank_phase[i][c] = pll_bank_phase(&bank, c);
+    }
+
+    double max_diff = 0.0;
+    float min_freq = 1e9f, max_freq = 0.0f;
+    for (int c = 0; c < num_channels; c++) {
+        PLL pll;
+        init_channel(&pll, c);
+        for (int i = 0; i < NUM_SAMPLES; i++) {
+            pll_update(&pll, voltage[i][c]);
+            double d = remainder((double)bank_phase[i][c] - (double)pll.output_vco_phase, 2.0 * M_PI);
+            if (fabs(d) > max_diff) max_diff = fabs(d);
+        }
+        float f = pll_bank_frequency(&bank, c);
+        if (f < min_freq) min_freq = f;
+        if (f > max_freq) max_freq = f;
+    }
+    printf("Bank vs pll_update: %d channels x %d samples, max phase diff %.2e rad, locked at %.3f..%.3f Hz\n",
+           num_channels, NUM_SAMPLES, max_diff, min_freq, max_freq);
+    return max_diff < 1e-3 ? 0 : 1;
+}
+
+static void time_channels(int num_channels) {
+    static float column[NUM_SAMPLES];
+    static float phase[NUM_SAMPLES];
+
+    clock_t start = clock();
+    for (int c = 0; c < num_channels; c++) {
+        PLL pll;
+        init_channel(&pll, c);
+        for (int i = 0; i < NUM_SAMPLES; i++) column[i] = voltage[i][c];
+        PLLBlockOutputs outputs = { .phase = phase };
+        pll_process_block(&pll, column, NUM_SAMPLES, &outputs);
+    }
+    double scalar_ns = (double)(clock() - start) / CLOCKS_PER_SEC / NUM_SAMPLES / num_channels * 1e9;
+
+    pll_bank_init(&bank);
+    for (int c = 0; c < num_channels; c++) {
+        PLL pll;
+        init_channel(&pll, c);
+        pll_bank_load(&bank, c, &pll);
+    }
+    start = clock();
+    for (int i = 0; i < NUM_SAMPLES; i++) pll_bank_step(&bank, voltage[i]);
+    double bank_ns = (double)(clock() - start) / CLOCKS_PER_SEC / NUM_SAMPLES / num_channels * 1e9;
+
+    printf("%2d channels: pll_process_block %.1f ns, bank %.1f ns per channel-sample (%.1fx)\n",
+           num_channels, scalar_ns, bank_ns, scalar_ns / bank_ns);
+}
+
+int main(void) {
+    printf("PLL bank: %d lanes per group\n", PLL_BANK_LANES);
+    make_signals(PLL_BANK_MAX_CHANNELS);
+
+    int failures = check_against_scalar(PLL_BANK_MAX_CHANNELS);
+    failures += check_against_scalar(13);   // partial last group
+
+    for (int n = 8; n <= PLL_BANK_MAX_CHANNELS; n *= 2) time_channels(n);
+
+    printf(failures == 0 ? "PASSED\n" : "FAILED\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,24 @@
+#!/bin/bash
+
+echo "Building grid synchronization benchmark..."
+
+gcc -O2 -Wall -Wextra -o pll_family_bench main.c \
+    ../../phase_lock/grid_sync/grid_sync.c \
+    ../../phase_lock/sogi_pll/sogi_pll.c \
+    ../../phase_lock/srf_pll/srf_pll.c \
+    ../../phase_lock/sogi_fll/sogi_fll.c \
+    ../../phase_lock/pll.c \
+    ../../phase_lock/pll_phase_detector/pll_phase_detector.c \
+    ../../phase_lock/pll_controller_pi/pll_controller_pi.c \
+    ../../phase_lock/pll_voltage_oscillator/vco_controller.c \
+    ../../phase_lock/pll_lock_detector/pll_lock_detector.c \
+    ../../notch_filter/notch_filter.c \
+    -lm
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running benchmark..."
+    ./pll_family_bench
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,20 @@
+#!/bin/bash
+
+echo "Building PLL lock detector test..."
+
+gcc -O2 -Wall -Wextra -o pll_lock_detector_test main.c \
+    ../../phase_lock/pll.c \
+    ../../phase_lock/pll_phase_detector/pll_phase_detector.c \
+    ../../phase_lock/pll_controller_pi/pll_controller_pi.c \
+    ../../phase_lock/pll_voltage_oscillator/vco_controller.c \
+    ../../phase_lock/pll_lock_detector/pll_lock_detector.c \
+    ../../notch_filter/notch_filter.c \
+    -lm
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    ./pll_lock_detector_test
+else
+    echo "Build failed!"
+    exit 1
+fi
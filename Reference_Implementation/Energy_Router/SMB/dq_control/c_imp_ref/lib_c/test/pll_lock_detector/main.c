@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <math.h>
+#include "../../phase_lock/pll.h"
+
+#define SAMPLING_FREQ 1000.0f
+#define NOMINAL_FREQ 50.0f
+#define GRID_VOLTAGE_PEAK 325.0f
+#define NUM_SAMPLES 8000
+
+// Scenario: steady 50 Hz (0-2 s), +1 Hz/s ramp (2-4 s), 60 deg phase jump
+// (4 s), hold (4-6 s), signal dropout (6-6.5 s), recovery (6.5-8 s)
+#define RAMP_BEGIN 2000
+#define RAMP_END 4000
+#define JUMP_AT 4000
+#define DROP_BEGIN 6000
+#define DROP_END 6500
+
+static float voltage[NUM_SAMPLES];
+
+static void make_signal(void) {
+    double theta = 0.0;
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        double f = NOMINAL_FREQ;
+        if (i >= RAMP_BEGIN) f += (double)((i < RAMP_END ? i : RAMP_END) - RAMP_BEGIN) / SAMPLING_FREQ;
+        theta += 2.0 * M_PI * f / SAMPLING_FREQ;
+        if (i == JUMP_AT) theta += M_PI / 3.0;
+        bool dropped = i >= DROP_BEGIN && i < DROP_END;
+        voltage[i] = dropped ? 0.0f : GRID_VOLTAGE_PEAK * (float)sin(theta);
+    }
+}
+
+static void init_pll(PLL* pll) {
+    float notch_ratios[5] = {0.90f, 0.90f, 0.90f, 0.90f, 0.90f};
+    pll_init(pll, SAMPLING_FREQ, NOMINAL_FREQ, notch_ratios, NOTCH_2ND | NOTCH_3RD,
+             25.0f, 1.0f / GRID_VOLTAGE_PEAK, 3.0f, 50.0f, 55.0f, 45.0f, 1.0f, 0.0f);
+    ld_config_t config = LD_CONFIG_DEFAULTS;
+    config.min_amplitude = 0.1f * GRID_VOLTAGE_PEAK;
+    pll_set_lock_detector(pll, &config);
+}
+
+static int check(bool ok, const char* what) {
+    printf("  %-52s %s\n", what, ok ? "ok" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+int main(void) {
+    static PLL pll, block_pll;
+    make_signal();
+    init_pll(&pll);
+    init_pll(&block_pll);
+
+    int first_lock = -1, unlock_after_jump = -1, relock = -1;
+    int locked_in_drop = 0, relock_after_drop = -1;
+    float amp_err = 0.0f, freq_err = 0.0f, rocof_steady = 0.0f;
+    float rocof_ramp_min = 1e9f, rocof_ramp_max = -1e9f;
+    int block_mismatch = 0;
+    const PLLBlockOutputs track_lock = { .lock_detector = true };
+    float quality_diff = 0.0f;
+
+    for (int i = 0; i < NUM_SAMPLES; i += 100) {
+        pll_process_block(&block_pll, &voltage[i], 100, &track_lock);
+        for (int j = i; j < i + 100; j++) {
+            pll_update(&pll, voltage[j]);
+            bool locked = pll.output_locked;
+            if (first_lock < 0 && locked) first_lock = j;
+            if (j >= 1000 && j < RAMP_BEGIN) {
+                amp_err = fmaxf(amp_err, fabsf(pll.output_amplitude - GRID_VOLTAGE_PEAK) / GRID_VOLTAGE_PEAK);
+                freq_err = fmaxf(freq_err, fabsf(pll.output_frequency - NOMINAL_FREQ));
+                rocof_steady = fmaxf(rocof_steady, fabsf(pll.output_rocof));
+            }
+            if (j >= RAMP_BEGIN + 1000 && j < RAMP_END) {
+                rocof_ramp_min = fminf(rocof_ramp_min, pll.output_rocof);
+                rocof_ramp_max = fmaxf(rocof_ramp_max, pll.output_rocof);
+            }
+            if (j >= JUMP_AT && unlock_after_jump < 0 && !locked) unlock_after_jump = j;
+            if (unlock_after_jump >= 0 && relock < 0 && j < DROP_BEGIN && locked) relock = j;
+            if (j >= DROP_BEGIN + 100 && j < DROP_END && locked) locked_in_drop++;
+            if (j >= DROP_END && relock_after_drop < 0 && locked) relock_after_drop = j;
+        }
+        if (block_pll.output_locked != pll.output_locked) block_mismatch++;
+        quality_diff = fmaxf(quality_diff, fabsf(block_pll.output_lock_quality - pll.output_lock_quality));
+    }
+
+    printf("first lock %.3f s, amplitude error %.2f %%, frequency error %.3f Hz, |ROCOF| %.3f Hz/s\n",
+           first_lock / SAMPLING_FREQ, 100.0f * amp_err, freq_err, rocof_steady);
+    printf("ramp 1 Hz/s: ROCOF %.3f..%.3f Hz/s\n", rocof_ramp_min, rocof_ramp_max);
+    printf("60 deg jump: unlock after %.0f ms, relock after %.3f s\n",
+           (unlock_after_jump - JUMP_AT) * 1000.0f / SAMPLING_FREQ, (relock - JUMP_AT) / SAMPLING_FREQ);
+    printf("dropout: %d locked samples after 100 ms, relock %.3f s after return\n",
+           locked_in_drop, (relock_after_drop - DROP_END) / SAMPLING_FREQ);
+    printf("block vs scalar: %d lock mismatches, quality diff %.1e\n", block_mismatch, quality_diff);
+
+    int failures = 0;
+    failures += check(first_lock >= 0 && first_lock < 1000, "locks within 1 s");
+    failures += check(amp_err < 0.02f, "amplitude within 2 % once locked");
+    failures += check(freq_err < 0.05f, "smoothed frequency within 0.05 Hz");
+    failures += check(rocof_steady < 0.1f, "ROCOF below 0.1 Hz/s at fixed frequency");
+    failures += check(rocof_ramp_min > 0.8f && rocof_ramp_max < 1.2f, "ROCOF within 20 % on the 1 Hz/s ramp");
+    failures += check(unlock_after_jump >= 0 && unlock_after_jump - JUMP_AT < 50, "lock lost within 50 ms of the jump");
+    failures += check(relock > 0, "lock regained after the jump");
+    failures += check(locked_in_drop == 0, "unlocked within 100 ms of the dropout");
+    failures += check(relock_after_drop > 0, "lock regained after the dropout");
+    failures += check(block_mismatch == 0 && quality_diff < 1e-3f, "pll_process_block matches pll_update");
+
+    printf("Lock detector test %s\n", failures == 0 ? "PASSED" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
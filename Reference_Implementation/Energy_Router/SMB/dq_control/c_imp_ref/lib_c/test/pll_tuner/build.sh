@@ -0,0 +1,21 @@
+#!/bin/bash
+
+echo "Building PLL tuner..."
+
+gcc -O2 -Wall -Wextra -pthread -o pll_tuner main.c \
+    ../../phase_lock/pll_tuner/pll_tuner.c \
+    ../../phase_lock/pll.c \
+    ../../phase_lock/pll_phase_detector/pll_phase_detector.c \
+    ../../phase_lock/pll_controller_pi/pll_controller_pi.c \
+    ../../phase_lock/pll_voltage_oscillator/vco_controller.c \
+    ../../phase_lock/pll_lock_detector/pll_lock_detector.c \
+    ../../notch_filter/notch_filter.c \
+    -lm
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running tuner..."
+    ./pll_tuner "$@"
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,143 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../../phase_lock/pll_tuner/pll_tuner.h"
+
+#define NUM_LOGS 3
+
+// Search grid. Loop gain goes with kd * kp, so kd stays at the value the
+// real-data tests use for these logs. The notch ratio does not apply to
+// NOTCH_NONE, so that configuration is swept once.
+static const float kd_axis[] = { 1.0f / 3.0f };
+static const float kp_axis[] = { 1.0f, 2.0f, 3.0f, 4.0f, 6.0f, 8.0f, 12.0f, 16.0f, 24.0f, 32.0f, 48.0f, 64.0f, 96.0f };
+static const float ki_axis[] = { 2.0f, 5.0f, 10.0f, 20.0f, 35.0f, 50.0f, 80.0f, 120.0f };
+static const float lpf_axis[] = { 5.0f, 10.0f, 15.0f, 25.0f, 40.0f };
+static const int notch_axis[] = { NOTCH_NONE, NOTCH_2ND, NOTCH_2ND | NOTCH_3RD, NOTCH_2ND | NOTCH_3RD | NOTCH_5TH };
+static const float ratio_axis[] = { 0.8f, 0.9f, 0.95f };
+#define AXIS(a) (int)(sizeof(a) / sizeof(a[0]))
+
+// Hand-tuned values of test/phase_lock_real_data, scored for comparison
+static const PllTuneParams baseline = { 1.0f / 3.0f, 2.0f, 10.0f, 5.0f, NOTCH_2ND | NOTCH_3RD, 0.9f };
+
+typedef struct {
+    float v[PLL_TUNE_MAX_RECORD];
+    float angle[PLL_TUNE_MAX_RECORD];
+} LogData;
+
+// Every <st_ufl_transform> line has curr_val and curr_angle, in both log formats
+static int read_log(PllTuneRecord* rec, LogData* data, const char* path, const char* name) {
+    FILE* fp = fopen(path, "r");
+    if (!fp) {
+        printf("Cannot open %s\n", path);
+        return -1;
+    }
+    char line[1024];
+    int n = 0;
+    while (fgets(line, sizeof(line), fp) && n < PLL_TUNE_MAX_RECORD) {
+        char* val = strstr(line, "curr_val:");
+        char* ang = strstr(line, "curr_angle:");
+        if (!strstr(line, "<st_ufl_transform>") || !val || !ang) continue;
+        data->v[n] = strtof(val + 9, NULL);
+        data->angle[n] = strtof(ang + 11, NULL);
+        n++;
+    }
+    fclose(fp);
+    rec->name = name;
+    rec->v = data->v;
+    rec->angle = data->angle;
+    rec->length = n;
+    return n > 0 ? 0 : -1;
+}
+
+static double now_s(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + 1e-9 * (double)t.tv_nsec;
+}
+
+static const char* notch_name(int config) {
+    switch (config) {
+        case NOTCH_NONE: return "none";
+        case NOTCH_2ND: return "2";
+        case NOTCH_2ND | NOTCH_3RD: return "2+3";
+        case NOTCH_2ND | NOTCH_3RD | NOTCH_5TH: return "2+3+5";
+        default: return "?";
+    }
+}
+
+static void print_row(const PllTuneParams* p, const PllTuneScore* s) {
+    printf("%6.3f %5.1f %6.1f %5.1f %-6s %5.2f | %8.3f %10.4f %9.3f\n",
+           p->kd, p->kp, p->ki, p->lpf_cutoff, notch_name(p->notch_config), p->notch_ratio,
+           s->lock_s, s->jitter_rad, s->settle_s);
+}
+
+int main(int argc, char** argv) {
+    int num_threads = argc > 1 ? atoi(argv[1]) : 0;
+
+    static LogData data[NUM_LOGS];
+    PllTuneRecord records[NUM_LOGS];
+    const char* paths[NUM_LOGS] = {
+        "../phase_lock_real_data/Log_20241123.log",
+        "../phase_lock_real_data_newdata/testdata_charge_20241212_6A.log",
+        "../phase_lock_real_data_newdata/testdata_discharge_20241212_6A.log"
+    };
+    const char* names[NUM_LOGS] = { "Log_20241123", "charge_6A", "discharge_6A" };
+    for (int k = 0; k < NUM_LOGS; k++) {
+        if (read_log(&records[k], &data[k], paths[k], names[k]) != 0) return 1;
+    }
+
+    int count = AXIS(kd_axis) * AXIS(kp_axis) * AXIS(ki_axis) * AXIS(lpf_axis) * AXIS(notch_axis) * AXIS(ratio_axis);
+    PllTuneParams* params = malloc(sizeof(PllTuneParams) * (size_t)count);
+    PllTuneScore* scores = malloc(sizeof(PllTuneScore) * (size_t)count);
+    int* front = malloc(sizeof(int) * (size_t)count);
+    if (!params || !scores || !front) return 1;
+    int n = 0;
+    for (int a = 0; a < AXIS(kd_axis); a++)
+    for (int b = 0; b < AXIS(kp_axis); b++)
+    for (int c = 0; c < AXIS(ki_axis); c++)
+    for (int d = 0; d < AXIS(lpf_axis); d++)
+    for (int e = 0; e < AXIS(notch_axis); e++)
+    for (int f = 0; f < AXIS(ratio_axis); f++) {
+        if (notch_axis[e] == NOTCH_NONE && f > 0) continue;
+        params[n++] = (PllTuneParams){ kd_axis[a], kp_axis[b], ki_axis[c], lpf_axis[d], notch_axis[e], ratio_axis[f] };
+    }
+    count = n;
+
+    PllTuneSetup setup = PLL_TUNE_SETUP_DEFAULTS;
+    double t0 = now_s();
+    int result = pll_tune_run(&setup, records, NUM_LOGS, params, scores, count, num_threads);
+    double elapsed = now_s() - t0;
+    if (result != PLL_SUCCESS) {
+        printf("pll_tune_run failed: %d\n", result);
+        return 1;
+    }
+    printf("%d parameter sets x %d logs + step in %.2f s (%.0f sets/s)\n\n", count, NUM_LOGS, elapsed, count / elapsed);
+
+    int size = pll_tune_pareto(scores, count, front);
+    printf("Pareto front (%d sets): worst lock over the logs, mean jitter, step settle\n", size);
+    printf("%6s %5s %6s %5s %-6s %5s | %8s %10s %9s\n", "kd", "kp", "ki", "lpf", "notch", "ratio",
+           "lock (s)", "jitter", "settle (s)");
+    for (int i = 0; i < size; i++) print_row(&params[front[i]], &scores[front[i]]);
+
+    PllTuneScore base;
+    pll_tune_evaluate(&setup, records, NUM_LOGS, &baseline, &base);
+    printf("\nbaseline (test/phase_lock_real_data):\n");
+    print_row(&baseline, &base);
+
+    // The threaded run must score exactly as a single evaluation does
+    int mismatches = 0;
+    for (int i = 0; i < size; i++) {
+        PllTuneScore check;
+        pll_tune_evaluate(&setup, records, NUM_LOGS, &params[front[i]], &check);
+        if (memcmp(&check, &scores[front[i]], sizeof(check)) != 0) mismatches++;
+    }
+    printf("front re-evaluated single-threaded: %d mismatches\n", mismatches);
+
+    free(params);
+    free(scores);
+    free(front);
+    int ok = size > 0 && mismatches == 0;
+    printf(ok ? "PASSED\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,21 @@
+#!/bin/bash
+
+echo "Building SHE solver test..."
+
+gcc -O2 -pthread -o she_solver_test main.c \
+    ../../pwm/stair_wave/four_modules/load_table_5d/load_switching_angles_table_5d.c \
+    ../../pwm/stair_wave/four_modules/interp_table_5d/interp_table_5d.c \
+    ../../pwm/stair_wave/four_modules/she_solver/she_solver.c \
+    ../../pwm/stair_wave/four_modules/she_solver/she_service.c \
+    -I../../pwm/stair_wave/four_modules/load_table_5d \
+    -I../../pwm/stair_wave/four_modules/interp_table_5d \
+    -I../../pwm/stair_wave/four_modules/she_solver \
+    -lm
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    ./she_solver_test
+else
+    echo "Build failed!"
+    exit 1
+fi
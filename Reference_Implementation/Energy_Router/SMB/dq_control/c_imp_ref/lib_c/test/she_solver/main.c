@@ -0,0 +1,205 @@
+#define _USE_MATH_DEFINES
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include "../../pwm/stair_wave/four_modules/interp_table_5d/interp_table_5d.h"
+#include "../../pwm/stair_wave/four_modules/she_solver/she_solver.h"
+#include "../../pwm/stair_wave/four_modules/she_solver/she_service.h"
+
+#define NUM_TEST_POINTS 2000
+#define NUM_OPERATING_POINTS 40
+#define NUM_REFRESHES 4000
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static float rand_range(float lo, float hi) {
+    return lo + (hi - lo) * ((float)rand() / RAND_MAX);
+}
+
+// Sorted-descending ratios, as the stair-wave path looks them up
+static void random_point(single_dc_source_t* dc) {
+    float c[NUM_DC_SOURCES];
+    for (int i = 0; i < NUM_DC_SOURCES; i++) c[i] = rand_range(0.95f, 1.05f);
+    for (int i = 1; i < NUM_DC_SOURCES; i++) {
+        for (int j = i; j > 0 && c[j - 1] < c[j]; j--) {
+            float t = c[j]; c[j] = c[j - 1]; c[j - 1] = t;
+        }
+    }
+    float m = rand_range(0.75f, 1.0f);
+    for (int i = 0; i < NUM_DC_SOURCES; i++) {
+        dc[i].c = c[i];
+        dc[i].m_common = m;
+    }
+}
+
+int main(void) {
+    int failures = 0;
+    const SwitchingAnglesTable* table = init_switching_angles_lookup_table();
+    if (!table) return 1;
+
+    // Solver quality against table interpolation + V1 compensation
+    srand(11);
+    double sum_thd_table = 0.0, sum_thd_she = 0.0, solve_time = 0.0;
+    double sum_low_table = 0.0, sum_low_she = 0.0;
+    float max_low_table = 0.0f, max_low_she = 0.0f, max_v1_she = 0.0f;
+    int converged = 0, constraints_met = 0, total_iterations = 0;
+    for (int p = 0; p < NUM_TEST_POINTS; p++) {
+        single_dc_source_t dc[NUM_DC_SOURCES];
+        random_point(dc);
+        float c[NUM_DC_SOURCES];
+        for (int i = 0; i < NUM_DC_SOURCES; i++) c[i] = dc[i].c;
+        float m = dc[0].m_common;
+
+        SwitchingAnglesResult res;
+        interpolate_switching_angles_5d(table, dc, &res);
+        SheSolveStats table_stats;
+        she_evaluate(c, m, res.theta, &table_stats);
+
+        float theta[NUM_DC_SOURCES];
+        memcpy(theta, res.theta, sizeof(theta));
+        SheSolveStats st;
+        double t0 = now_sec();
+        int ok = she_solve(c, m, theta, SHE_MAX_ITERATIONS, &st);
+        solve_time += now_sec() - t0;
+
+        sum_thd_table += table_stats.thd;
+        max_low_table = fmaxf(max_low_table, table_stats.max_low_order);
+        sum_low_table += table_stats.max_low_order;
+        if (ok == SHE_SOLVE_OK) constraints_met++;
+        if (ok != SHE_SOLVE_FAILED) {
+            converged++;
+            total_iterations += st.iterations;
+            sum_thd_she += st.thd;
+            max_low_she = fmaxf(max_low_she, st.max_low_order);
+            sum_low_she += st.max_low_order;
+            max_v1_she = fmaxf(max_v1_she, fabsf(st.v1_error));
+        }
+    }
+    printf("SHE solve from table warm start (%d points)\n", NUM_TEST_POINTS);
+    printf("  table+comp: mean THD %.3f%%, |V3..V7| mean %.3f%% max %.3f%% of V1\n",
+           sum_thd_table / NUM_TEST_POINTS, sum_low_table / NUM_TEST_POINTS, max_low_table);
+    printf("  solver:     mean THD %.3f%%, |V3..V7| mean %.3f%% max %.3f%% of V1, max |V1 err| %.3f%%\n",
+           converged ? sum_thd_she / converged : 0.0, converged ? sum_low_she / converged : 0.0,
+           max_low_she, max_v1_she);
+    printf("  V1 held %d/%d, V3..V7 below %.1f%% on %d, %.1f iterations, %.1f us/solve\n",
+           converged, NUM_TEST_POINTS, SHE_LOW_ORDER_LIMIT, constraints_met, converged ? (double)total_iterations / converged : 0.0,
+           solve_time * 1e6 / NUM_TEST_POINTS);
+    if (converged < NUM_TEST_POINTS * 9 / 10 || sum_low_she / converged > sum_low_table / NUM_TEST_POINTS) {
+        printf("FAIL: solver lost V1 or did not reduce low-order harmonics\n");
+        failures++;
+    }
+
+    // Background service: repeated operating points become cache hits
+    SheService service;
+    if (she_service_init(&service, 256) != 0 || she_service_start(&service) != 0) return 1;
+
+    single_dc_source_t points[NUM_OPERATING_POINTS][NUM_DC_SOURCES];
+    for (int k = 0; k < NUM_OPERATING_POINTS; k++) random_point(points[k]);
+
+    double max_lookup = 0.0, sum_lookup = 0.0;
+    unsigned hits_first = 0, hits_last = 0;
+    for (int r = 0; r < NUM_REFRESHES; r++) {
+        single_dc_source_t dc[NUM_DC_SOURCES];
+        memcpy(dc, points[r % NUM_OPERATING_POINTS], sizeof(dc));
+        SwitchingAnglesResult res;
+        double t0 = now_sec();
+        bool hit = she_service_lookup(&service, table, dc, &res);
+        double dt = now_sec() - t0;
+        sum_lookup += dt;
+        if (dt > max_lookup) max_lookup = dt;
+        if (r < NUM_OPERATING_POINTS) hits_first += hit;
+        if (r >= NUM_REFRESHES - NUM_OPERATING_POINTS) hits_last += hit;
+        if (fabsf(res.v1_error) > 0.25f) {
+            printf("FAIL: refresh %d V1 error %.3f%%\n", r, res.v1_error);
+            failures++;
+            break;
+        }
+        usleep(50);     // next feedback interrupt
+    }
+    she_service_stop(&service);
+
+    printf("\nSHE service, %d operating points, %d refreshes\n", NUM_OPERATING_POINTS, NUM_REFRESHES);
+    printf("  hits %u, misses %u, solved %u, rejected %u, dropped %u\n",
+           atomic_load(&service.hits), atomic_load(&service.misses), atomic_load(&service.solved),
+           atomic_load(&service.rejected), atomic_load(&service.dropped));
+    printf("  hit rate first pass %u/%d, last pass %u/%d\n",
+           hits_first, NUM_OPERATING_POINTS, hits_last, NUM_OPERATING_POINTS);
+    printf("  lookup %.0f ns mean, %.0f ns max\n",
+           sum_lookup * 1e9 / NUM_REFRESHES, max_lookup * 1e9);
+    if (hits_last < NUM_OPERATING_POINTS * 8 / 10) {
+        printf("FAIL: cache did not warm up\n");
+        failures++;
+    }
+
+    she_service_free(&service);
+
+    // Controller order is not c order: a permuted point is solved with the
+    // larger c on the smaller angle, module by module
+    SheService inline_service;
+    if (she_service_init(&inline_service, 64) != 0) return 1;
+    const int perm[NUM_DC_SOURCES] = {2, 0, 3, 1};
+    int misordered = 0, perm_missing = 0;
+    float max_perm_v1 = 0.0f;
+    for (int k = 0; k < 20; k++) {
+        single_dc_source_t dc[NUM_DC_SOURCES], permuted[NUM_DC_SOURCES];
+        random_point(dc);
+        for (int i = 0; i < NUM_DC_SOURCES; i++) permuted[i] = dc[perm[i]];
+        SwitchingAnglesResult res;
+        she_service_lookup(&inline_service, table, permuted, &res);
+        she_service_process(&inline_service, SHE_QUEUE_SIZE);
+        float theta[NUM_DC_SOURCES];
+        if (!she_service_find(&inline_service, permuted, theta)) {
+            perm_missing++;
+            continue;
+        }
+        float v1 = 0.0f;
+        for (int i = 0; i < NUM_DC_SOURCES; i++) {
+            v1 += permuted[i].c * cosf(theta[i]);
+            for (int j = 0; j < NUM_DC_SOURCES; j++) {
+                if (permuted[i].c > permuted[j].c && theta[i] > theta[j] + 1e-6f) misordered++;
+            }
+        }
+        float v1_ideal = M_PI * permuted[0].m_common;
+        max_perm_v1 = fmaxf(max_perm_v1, fabsf(100.0f * (v1 - v1_ideal) / v1_ideal));
+    }
+    she_service_free(&inline_service);
+    printf("\nPermuted modules: %d misordered pairs, max |V1 err| %.3f%%, %d points not solved\n",
+           misordered, max_perm_v1, perm_missing);
+    if (misordered || max_perm_v1 > 0.25f || perm_missing > 2) {
+        printf("FAIL: permuted operating point solved for another module assignment\n");
+        failures++;
+    }
+
+    // Points queued before she_service_start are solved without a new miss
+    SheService late_service;
+    if (she_service_init(&late_service, 64) != 0) return 1;
+    for (int k = 0; k < 4; k++) {
+        single_dc_source_t dc[NUM_DC_SOURCES];
+        random_point(dc);
+        SwitchingAnglesResult res;
+        she_service_lookup(&late_service, table, dc, &res);
+    }
+    if (she_service_start(&late_service) != 0) return 1;
+    unsigned handled = 0;
+    for (int wait = 0; wait < 1000 && handled < 4; wait++) {
+        usleep(1000);
+        handled = atomic_load(&late_service.solved) + atomic_load(&late_service.rejected);
+    }
+    she_service_free(&late_service);
+    printf("Queued before start: %u of 4 handled\n", handled);
+    if (handled < 4) {
+        printf("FAIL: points queued before she_service_start were not processed\n");
+        failures++;
+    }
+
+    cleanup_switching_angles_lookup_table(table);
+    printf("\n%s\n", failures ? "SHE solver test FAILED" : "SHE solver test passed");
+    return failures ? 1 : 0;
+}
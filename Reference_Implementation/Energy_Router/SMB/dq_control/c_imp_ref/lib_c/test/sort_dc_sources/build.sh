@@ -0,0 +1,17 @@
+#!/bin/bash
+
+echo "Building module ordering test..."
+
+gcc -O2 -DPWM_STAIR_WAVE_TYPES -o sort_dc_sources_test main.c \
+    ../../pwm/stair_wave/common/modulation_2pwm/modulation_2pwm.c \
+    -I../../pwm/stair_wave/common/modulation_2pwm \
+    -I../../pwm/stair_wave/four_modules/load_table_5d \
+    -lm
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    ./sort_dc_sources_test
+else
+    echo "Build failed!"
+    exit 1
+fi
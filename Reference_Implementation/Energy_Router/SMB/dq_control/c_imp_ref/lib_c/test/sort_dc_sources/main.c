@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../../pwm/stair_wave/common/modulation_2pwm/modulation_2pwm.h"
+
+static float frand(float lo, float hi) {
+    return lo + (hi - lo) * (float)rand() / (float)RAND_MAX;
+}
+
+// Plain lexicographic order (SOC, then vdc), both descending
+static int compare_sources(const void* a, const void* b) {
+    const single_dc_source_t* x = a;
+    const single_dc_source_t* y = b;
+    if (x->soc != y->soc) return x->soc < y->soc ? 1 : -1;
+    if (x->vdc != y->vdc) return x->vdc < y->vdc ? 1 : -1;
+    return 0;
+}
+
+// Network result against qsort for every size up to 16, no hysteresis
+static int check_against_qsort(int trials) {
+    int failures = 0;
+    for (int t = 0; t < trials; t++) {
+        int n = 1 + t % SORT_NETWORK_MAX_MODULES;
+        single_dc_source_t sources[SORT_NETWORK_MAX_MODULES];
+        single_dc_source_t reference[SORT_NETWORK_MAX_MODULES];
+        uint8_t order[SORT_NETWORK_MAX_MODULES];
+        for (int i = 0; i < n; i++) {
+            memset(&sources[i], 0, sizeof(sources[i]));
+            sources[i].soc = (float)(rand() % 4) * 0.1f;     // ties fall through to vdc
+            sources[i].vdc = frand(80.0f, 100.0f);
+            sources[i].io_index = i;
+            order[i] = (uint8_t)((i + t) % n);                 // arbitrary previous order
+        }
+        memcpy(reference, sources, sizeof(single_dc_source_t) * (size_t)n);
+        qsort(reference, (size_t)n, sizeof(single_dc_source_t), compare_sources);
+
+        sort_dc_source_order(sources, order, n, 0.0f, 0.0f, 0.0f);
+        for (int i = 0; i < n; i++) {
+            if (sources[order[i]].soc != reference[i].soc || sources[order[i]].vdc != reference[i].vdc) {
+                failures++;
+                break;
+            }
+        }
+    }
+    printf("Network vs qsort: %d trials, %d failures\n", trials, failures);
+    return failures;
+}
+
+static int same_order(const single_dc_source_t* a, const uint8_t* b, int n) {
+    for (int i = 0; i < n; i++) {
+        if (a[i].io_index != b[i]) return 0;
+    }
+    return 1;
+}
+
+// Near-equal voltages with measurement noise: count order changes per update
+static int check_hysteresis(int cycles) {
+    const int n = MAX_NUM_MODULES;
+    single_dc_source_t dc_sources[MAX_NUM_MODULES];
+    single_dc_source_t measured[MAX_NUM_MODULES];
+    init_dc_sources(dc_sources, n);
+
+    uint8_t plain[MAX_NUM_MODULES];
+    for (int i = 0; i < n; i++) plain[i] = (uint8_t)i;
+
+    int rotations = 0;
+    int plain_rotations = 0;
+    float drop = 0.0f;
+    for (int c = 0; c < cycles; c++) {
+        // Module 2 sags by 3 V halfway through: that one has to move
+        if (c == cycles / 2) drop = 3.0f;
+        for (int i = 0; i < n; i++) {
+            init_dc_sources(&measured[i], 1);
+            measured[i].io_index = i;
+            measured[i].valid = true;
+            measured[i].soc = 0.8f;
+            measured[i].vdc = 90.0f + frand(-0.2f, 0.2f) - (i == 2 ? drop : 0.0f);
+        }
+
+        uint8_t before[MAX_NUM_MODULES];
+        for (int i = 0; i < n; i++) before[i] = (uint8_t)dc_sources[i].io_index;
+        update_dc_sources(dc_sources, measured, SORT_BY_VDC_HI, n);
+        if (c > 0 && !same_order(dc_sources, before, n)) rotations++;
+
+        uint8_t plain_before[MAX_NUM_MODULES];
+        memcpy(plain_before, plain, sizeof(plain));
+        sort_dc_source_order(measured, plain, n, 0.0f, 0.0f, 0.0f);
+        if (c > 0 && memcmp(plain_before, plain, sizeof(plain)) != 0) plain_rotations++;
+
+        for (int i = 0; i < n; i++) {
+            if (dc_sources[i].vdc != measured[dc_sources[i].io_index].vdc) {
+                printf("Gathered source does not match its io_index\n");
+                return 1;
+            }
+        }
+    }
+
+    int sagged_last = dc_sources[n - 1].io_index == 2;
+    printf("Order changes over %d updates: %d with hysteresis, %d without; sagged module last: %s\n",
+           cycles, rotations, plain_rotations, sagged_last ? "yes" : "no");
+    return (rotations <= 1 && sagged_last && plain_rotations > rotations) ? 0 : 1;
+}
+
+static void time_update(int runs) {
+    const int n = MAX_NUM_MODULES;
+    single_dc_source_t dc_sources[MAX_NUM_MODULES];
+    single_dc_source_t measured[MAX_NUM_MODULES];
+    init_dc_sources(dc_sources, n);
+    init_dc_sources(measured, n);
+    for (int i = 0; i < n; i++) {
+        measured[i].io_index = i;
+        measured[i].soc = frand(0.5f, 0.9f);
+        measured[i].vdc = frand(85.0f, 95.0f);
+    }
+
+    clock_t start = clock();
+    for (int r = 0; r < runs; r++) {
+        measured[r & 3].soc += (r & 4) ? 0.03f : -0.03f;
+        update_dc_sources(dc_sources, measured, SORT_BY_SOC_BALANCE, n);
+    }
+    double ns = (double)(clock() - start) / CLOCKS_PER_SEC / runs * 1e9;
+    printf("update_dc_sources (SOC balance, %d modules): %.1f ns/call\n", n, ns);
+}
+
+int main(void) {
+    srand(7);
+    int failures = check_against_qsort(20000);
+    failures += check_hysteresis(10000);
+    time_update(1000000);
+
+    printf(failures == 0 ? "PASSED\n" : "FAILED\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -2,19 +2,22 @@
 
 echo "Building PWM control test..."
 
-# Compile the code
-gcc -o stair_wave_test main.c \
+# Compile the code (stair-wave module types in write_ios, see write_ios.h)
+gcc -DPWM_STAIR_WAVE_TYPES -o stair_wave_test main.c \
     ../../pwm/stair_wave/four_modules/lookup_table_1d/dyn_stair_wave_table.c \
     ../../pwm/stair_wave/four_modules/load_table_5d/load_switching_angles_table_5d.c \
     ../../pwm/stair_wave/four_modules/interp_table_5d/interp_table_5d.c \
     ../../pwm/stair_wave/four_modules/stair_wave_pwm/stair_wave_pwm.c \
-    ../../pwm/stair_wave/common/write_ios/write_ios.c \
+    ../../pwm/common/write_ios/write_ios.c \
     ../../pwm/stair_wave/common/modulation_2pwm/modulation_2pwm.c \
+    ../../pwm/common/gpio_pattern/gpio_pattern.c \
+    ../../misc/static_arena/static_arena.c \
     -I../../pwm/stair_wave/four_modules/lookup_table_1d \
     -I../../pwm/stair_wave/four_modules/load_table_5d \
     -I../../pwm/stair_wave/four_modules/interp_table_5d \
     -I../../pwm/stair_wave/four_modules/stair_wave_pwm \
-    -I../../pwm/stair_wave/common/write_ios \
+    -I../../pwm/common/write_ios \
+    -I../../pwm/common/gpio_pattern \
     -I../../pwm/stair_wave/common/modulation_2pwm \
     -lm
 
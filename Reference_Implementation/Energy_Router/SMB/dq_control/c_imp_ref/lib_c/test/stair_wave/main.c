@@ -3,9 +3,11 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <math.h>
+#include <time.h>
 #include "../../pwm/stair_wave/four_modules/lookup_table_1d/dyn_stair_wave_table.h"
 #include "../../pwm/stair_wave/four_modules/load_table_5d/load_switching_angles_table_5d.h"
 #include "../../pwm/stair_wave/four_modules/stair_wave_pwm/stair_wave_pwm.h"
+#include "../../misc/static_arena/static_arena.h"
 // Function implementations
 void print_table_contents(const StairWaveTable* table) {
     printf("\nStair Wave Table Contents:\n");
@@ -98,7 +100,7 @@ void print_multiple_switching_states(const StairWaveTable* table, int num_sample
     printf("--------------------------------------------------------\n");
     
     for (int i = 0; i < num_samples; i++) {
-        get_switching_state(table, test_angles[i], margin, i == 0, &last_result);
+        get_switching_state(table, test_angles[i], margin, &last_result);
         
         int dc_states[4];
         for (int j = 0; j < 4; j++) {
@@ -117,6 +119,85 @@ void print_multiple_switching_states(const StairWaveTable* table, int num_sample
     free(test_angles);
 }
 
+// Step a cursor through several cycles and compare with a fresh search at the same phase
+int check_cursor_against_search(const StairWaveTable* table, int num_steps) {
+    StairWaveCursor cursor;
+    stair_wave_cursor_seek(table, &cursor, 0);
+    int mismatches = 0;
+    for (int i = 0; i < num_steps; i++) {
+        // 20 kHz at 50 Hz is ~10.7M counts per step; vary it, with an occasional big jump
+        uint32_t delta = 10737418u + (uint32_t)(rand() % 2000000) - 1000000u;
+        if (i % 997 == 0) delta = (uint32_t)rand() * 2u;
+        stair_wave_cursor_advance(table, &cursor, delta);
+
+        StairWaveCursor searched;
+        stair_wave_cursor_seek(table, &searched, cursor.phase);
+        if (searched.index != cursor.index || searched.remaining != cursor.remaining) mismatches++;
+    }
+    printf("Cursor vs search: %d steps, %d mismatches\n", num_steps, mismatches);
+
+    // Per-call cost at the 20 kHz step
+    const int runs = 1000000;
+    volatile int sink = 0;
+    clock_t start = clock();
+    for (int i = 0; i < runs; i++) {
+        SwitchingStateResult result;
+        stair_wave_cursor_advance(table, &cursor, 10737418u);
+        stair_wave_cursor_result(table, &cursor, &result);
+        sink += result.state;
+    }
+    double cursor_ns = (double)(clock() - start) / CLOCKS_PER_SEC / runs * 1e9;
+    float angle = 0.0f;
+    start = clock();
+    for (int i = 0; i < runs; i++) {
+        SwitchingStateResult result;
+        angle += 0.0157f;
+        get_switching_state(table, angle, 0.0f, &result);
+        sink += result.state;
+    }
+    double search_ns = (double)(clock() - start) / CLOCKS_PER_SEC / runs * 1e9;
+    printf("Cursor advance: %.1f ns/call, search: %.1f ns/call\n", cursor_ns, search_ns);
+    return mismatches;
+}
+
+// Render one cycle, play it back tick by tick through write_ios and compare
+// with the state at the last phase count of each tick
+int check_pattern_playback(const PWMControlState* state, uint32_t cycle_ticks) {
+    static GpioPatternPlayer player;
+    gpio_pattern_player_init(&player);
+    if (!render_pwm_cycle(state, cycle_ticks, gpio_pattern_back(&player))) {
+        printf("Pattern render failed\n");
+        return 1;
+    }
+    gpio_pattern_swap(&player);
+    const GpioPatternBuffer* front = gpio_pattern_front(&player);
+
+    uint32_t start = stair_wave_phase_from_angle(state->phase_shift + STAIR_WAVE_ANGLE_SAFE_MARGIN);
+    int mismatches = 0;
+    uint32_t writes = 0;
+    for (uint32_t tick = 0; tick < cycle_ticks; tick++) {
+        writes += write_ios_play_pattern(front, tick, tick + 1);
+
+        uint64_t end = (((uint64_t)(tick + 1) << 32) + cycle_ticks - 1) / cycle_ticks - 1;
+        StairWaveCursor cursor;
+        stair_wave_cursor_seek(state->table, &cursor, start + (uint32_t)end);
+
+        single_dc_source_t modules[4];
+        SwitchingStateResult sum = { .state = state->table->sum_index[cursor.index] };
+        for (int i = 0; i < state->num_modules; i++) {
+            modules[i] = state->dc_sources[i];
+            modules[i].pwm_state = STATE_ALL_OFF;
+        }
+        convert_system_state_to_module_state(modules, &sum, state->num_modules);
+        pwm_word_t expected = write_ios_pack(modules, state->num_modules);
+
+        if (write_ios_read_word() != expected) mismatches++;
+    }
+    printf("Pattern: %u entries for %u ticks, %u register writes, %d mismatches\n",
+           front->num_entries, cycle_ticks, writes, mismatches);
+    return mismatches;
+}
+
 void compute_harmonics(const float* switching_angles, const single_dc_source_t* dc_sources, 
                       int num_modules, float modulation_index) {
     const int num_harmonics = 5;  // Will compute up to 9th harmonic (odd harmonics)
@@ -267,6 +348,10 @@ int main(void) {
     }
     printf("PWM control initialized successfully\n");  // Debug print
 
+    // Start-up done: the update path must not allocate from here on
+    static_arena_seal(control_arena());
+    printf("Control arena: %zu of %u bytes used\n", control_arena()->high_water, CONTROL_ARENA_SIZE);
+
 
     printf("Updating PWM control...\n");  // Debug print
     bool update_success = update_pwm_control(&pwm_state, dc_sources);
@@ -278,10 +363,40 @@ int main(void) {
         return 1;
     }
     printf("PWM control updated successfully\n");  // Debug print
+    if (control_arena()->failed != 0) {
+        printf("Allocation attempted after start-up!\n");
+        cleanup_pwm_control(&pwm_state);
+        return 1;
+    }
+
+    // One update is one port word, mirrored to the trace and left in the registers
+    pwm_word_t traced = 0;
+    if (write_ios_trace_total() != 1 || write_ios_trace_read(&traced, 1) != 1 ||
+        traced != write_ios_pack(pwm_state.dc_sources, pwm_state.num_modules) ||
+        write_ios_read_word() != traced) {
+        printf("Port word not traced or not in the registers!\n");
+        cleanup_pwm_control(&pwm_state);
+        return 1;
+    }
+    printf("Port word: 0x%08llx\n", (unsigned long long)traced);
 
     printf("\nPrinting switching states:\n");  // Debug print
     print_multiple_switching_states(pwm_state.table, 10);
 
+    printf("\nChecking phase cursor:\n");
+    if (check_cursor_against_search(pwm_state.table, 100000) != 0) {
+        printf("Phase cursor disagrees with table search!\n");
+        cleanup_pwm_control(&pwm_state);
+        return 1;
+    }
+
+    printf("\nChecking GPIO pattern playback:\n");
+    if (check_pattern_playback(&pwm_state, 20000) != 0 || check_pattern_playback(&pwm_state, 997) != 0) {
+        printf("Pattern playback disagrees with table!\n");
+        cleanup_pwm_control(&pwm_state);
+        return 1;
+    }
+
     printf("\nComputing harmonics:\n");  // Debug print
     compute_harmonics(pwm_state.table->angles, dc_sources, pwm_mini_input.num_modules, pwm_mini_input.modulation_index);
 
@@ -290,6 +405,8 @@ int main(void) {
     
     printf("\nCleaning up...\n");  // Debug print
     cleanup_pwm_control(&pwm_state);
+    // cleanup only detaches: the arena memory comes back with the reset
+    static_arena_reset(control_arena());
 
     printf("Test completed successfully!\n");  // Debug print
     return 0;
@@ -0,0 +1,19 @@
+#!/bin/bash
+
+echo "Building symmetric switching-angle table test..."
+
+gcc -O2 -o sym_switching_table_test main.c \
+    ../../pwm/stair_wave/n_modules/sym_table/sym_switching_table.c \
+    ../../pwm/stair_wave/four_modules/load_table_5d/load_switching_angles_table_5d.c \
+    ../../pwm/stair_wave/four_modules/interp_table_5d/interp_table_5d.c \
+    -I../../pwm/stair_wave/four_modules/load_table_5d \
+    -I../../pwm/stair_wave/four_modules/interp_table_5d \
+    -lm
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    ./sym_switching_table_test
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,184 @@
+#define _USE_MATH_DEFINES
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "../../pwm/stair_wave/four_modules/load_table_5d/load_switching_angles_table_5d.h"
+#include "../../pwm/stair_wave/four_modules/interp_table_5d/interp_table_5d.h"
+#include "../../pwm/stair_wave/n_modules/sym_table/sym_switching_table.h"
+
+#define NUM_TEST_POINTS 20000
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static float rand_range(float lo, float hi) {
+    return lo + (hi - lo) * ((float)rand() / RAND_MAX);
+}
+
+// Synthetic angles affine in the sorted ratios; simplex interpolation must
+// reproduce them exactly inside the ordered region
+static float affine_angle(int k, const float* c_sorted, int n, float m) {
+    float v = 0.3f + 0.05f * k - 0.2f * m;
+    for (int i = 0; i < n; i++) {
+        v += 0.01f * (i + 1) * (k + 1) * c_sorted[i];
+    }
+    return v;
+}
+
+static int check_rank_enumeration(const SymSwitchingTable* table) {
+    int idx[SYM_TABLE_MAX_MODULES] = {0};
+    size_t count = 0;
+    do {
+        if (sym_table_rank(table, idx) != count) {
+            printf("FAIL: rank mismatch at tuple %zu (N=%d)\n", count, table->num_modules);
+            return 1;
+        }
+        count++;
+    } while (sym_table_next_tuple(table, idx));
+    if (count != table->num_sorted) {
+        printf("FAIL: enumerated %zu tuples, expected %zu\n", count, table->num_sorted);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void) {
+    int failures = 0;
+    const float c_grid[5] = {0.95f, 0.975f, 1.0f, 1.025f, 1.05f};
+    const float m_grid[6] = {0.75f, 0.80f, 0.85f, 0.90f, 0.95f, 1.00f};
+
+    printf("Stored size, P=5 ratio points, M=6 modulation points\n");
+    printf("N | ordered tuples |  sym table | dense table\n");
+    for (int n = 2; n <= SYM_TABLE_MAX_MODULES; n++) {
+        SymSwitchingTable* t = create_sym_switching_table(n, c_grid, 5, m_grid, 6);
+        if (!t) return 1;
+        double dense_kb = pow(5.0, n) * 6 * n * sizeof(float) / 1024.0;
+        double sym_kb = (double)t->num_sorted * 6 * n * sizeof(float) / 1024.0;
+        printf("%d | %14zu | %7.1f KB | %9.1f KB\n", n, t->num_sorted, sym_kb, dense_kb);
+        failures += check_rank_enumeration(t);
+        free_sym_switching_table(t);
+    }
+
+    // Four modules: ordered table extracted from the dense 5D table
+    const SwitchingAnglesTable* dense = init_switching_angles_lookup_table();
+    if (!dense) return 1;
+    SymSwitchingTable* sym4 = sym_switching_table_from_5d(dense);
+    if (!sym4) return 1;
+
+    const char* path = "/tmp/sym_switching_table_4.bin";
+    SymSwitchingTable* loaded = NULL;
+    if (save_sym_switching_table(sym4, path) == 0) {
+        loaded = load_sym_switching_table(path);
+    }
+    if (!loaded || memcmp(loaded->angles, sym4->angles,
+                          sym4->num_sorted * sym4->num_m_points * sym4->num_modules * sizeof(float)) != 0) {
+        printf("FAIL: save/load round trip\n");
+        failures++;
+    }
+
+    srand(7);
+    float max_dense_diff = 0.0f;
+    float max_perm_diff = 0.0f;
+    for (int p = 0; p < NUM_TEST_POINTS; p++) {
+        single_dc_source_t dc[NUM_DC_SOURCES];
+        float c[NUM_DC_SOURCES];
+        for (int i = 0; i < NUM_DC_SOURCES; i++) {
+            c[i] = rand_range(0.95f, 1.05f);
+        }
+        float m = rand_range(0.75f, 1.0f);
+
+        // Dense lookup on the sorted ratios, as the stair-wave path calls it
+        float c_sorted[NUM_DC_SOURCES];
+        uint8_t perm[NUM_DC_SOURCES];
+        sym_table_sort_modules(c, NUM_DC_SOURCES, c_sorted, perm);
+        for (int i = 0; i < NUM_DC_SOURCES; i++) {
+            dc[i].c = c_sorted[i];
+            dc[i].m_common = m;
+        }
+        float theta_dense[NUM_DC_SOURCES];
+        interpolate_switching_angles_5d_raw(dense, dc, INTERP_5D_SIMPLEX, theta_dense);
+
+        float theta[NUM_DC_SOURCES];
+        interpolate_sym_switching_angles(loaded ? loaded : sym4, c, m, theta, perm);
+        for (int k = 0; k < NUM_DC_SOURCES; k++) {
+            max_dense_diff = fmaxf(max_dense_diff, fabsf(theta[perm[k]] - theta_dense[k]));
+        }
+
+        // Reversed module order must give the same angles per module
+        float c_rev[NUM_DC_SOURCES];
+        float theta_rev[NUM_DC_SOURCES];
+        for (int i = 0; i < NUM_DC_SOURCES; i++) {
+            c_rev[i] = c[NUM_DC_SOURCES - 1 - i];
+        }
+        interpolate_sym_switching_angles(sym4, c_rev, m, theta_rev, NULL);
+        for (int i = 0; i < NUM_DC_SOURCES; i++) {
+            max_perm_diff = fmaxf(max_perm_diff, fabsf(theta_rev[NUM_DC_SOURCES - 1 - i] - theta[i]));
+        }
+    }
+    printf("\nN=4 vs dense simplex lookup: max |dtheta| = %.2e rad\n", max_dense_diff);
+    printf("N=4 permuted inputs:         max |dtheta| = %.2e rad\n", max_perm_diff);
+    if (max_dense_diff > 1e-5f || max_perm_diff > 1e-6f) {
+        printf("FAIL: symmetric table disagrees with dense table\n");
+        failures++;
+    }
+
+    // Eight modules: synthetic table, affine in the sorted ratios
+    SymSwitchingTable* sym8 = create_sym_switching_table(8, c_grid, 5, m_grid, 6);
+    if (!sym8) return 1;
+    int idx[SYM_TABLE_MAX_MODULES] = {0};
+    do {
+        float c_node[SYM_TABLE_MAX_MODULES];
+        for (int k = 0; k < 8; k++) {
+            c_node[k] = c_grid[idx[k]];
+        }
+        size_t rank = sym_table_rank(sym8, idx);
+        for (int im = 0; im < 6; im++) {
+            float* a = sym_table_entry(sym8, rank, im);
+            for (int k = 0; k < 8; k++) {
+                a[k] = affine_angle(k, c_node, 8, m_grid[im]);
+            }
+        }
+    } while (sym_table_next_tuple(sym8, idx));
+
+    float max_affine_err = 0.0f;
+    double t0 = now_sec();
+    for (int p = 0; p < NUM_TEST_POINTS; p++) {
+        float c[8];
+        float theta[8];
+        uint8_t perm[8];
+        for (int i = 0; i < 8; i++) {
+            c[i] = rand_range(0.95f, 1.05f);
+        }
+        float m = rand_range(0.75f, 1.0f);
+        interpolate_sym_switching_angles(sym8, c, m, theta, perm);
+
+        float c_sorted[8];
+        for (int k = 0; k < 8; k++) {
+            c_sorted[k] = c[perm[k]];
+        }
+        for (int k = 0; k < 8; k++) {
+            max_affine_err = fmaxf(max_affine_err,
+                                   fabsf(theta[perm[k]] - affine_angle(k, c_sorted, 8, m)));
+        }
+    }
+    double t1 = now_sec();
+    printf("N=8 affine reproduction:     max |dtheta| = %.2e rad, %.1f ns/lookup\n",
+           max_affine_err, (t1 - t0) * 1e9 / NUM_TEST_POINTS);
+    if (max_affine_err > 1e-5f) {
+        printf("FAIL: N=8 interpolation is not exact for affine data\n");
+        failures++;
+    }
+
+    free_sym_switching_table(sym8);
+    free_sym_switching_table(loaded);
+    free_sym_switching_table(sym4);
+    cleanup_switching_angles_lookup_table(dense);
+
+    printf("\n%s\n", failures ? "Symmetric table test FAILED" : "Symmetric table test passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,15 @@
+#!/bin/bash
+
+echo "Building VCO NCO test..."
+
+gcc -O2 -Wall -Wextra -o vco_nco_test main.c \
+    ../../phase_lock/pll_voltage_oscillator/vco_controller.c \
+    -lm
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    ./vco_nco_test
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,15 @@
+#ifndef CONFIG_SPWM_SOLVER_H_
+#define CONFIG_SPWM_SOLVER_H_
+
+#include <stdint.h>
+
+//////////////////////////////////////////
+/// 定义SPWM交线求解器的配置参数
+struct Config_spwm_solver
+{
+    uint8_t max_iter = 5; //最多迭代次数
+    float   err      = 0.000000314f; //如果前低于此误差，终止迭代
+};
+////////////////////////////////////////
+
+#endif
@@ -9,9 +9,12 @@
 #include <iostream>
 #include <assert.h>     /* assert */
 #include <fstream>
+#include "../../utilities/mod.h"  // mod
 
 # define PI 3.141592653589 
 # define NOMM 8       // number of max modules
+# define PHASE_Q32_FULL_TURN (uint64_t(1) << 32) // 定点相位，一整圈 = 2^32
+# define PHASE_Q16_SHIFT     16                  // uint16 相位间隔 = Q32 相位的高16位 (一整圈 = 2^16)
 
 ////////////////////////////////////
 // 定义调制参数
@@ -157,13 +160,14 @@ public:
 } bms; // bms is global variable // 定义一个电池系统的全局变量
 
 
-// 求余
-float mod(float num, float T) 
+// 弧度转定点相位 (一整圈 = 2^32)，返回 uint64 以便表示 2PI 本身
+inline uint64_t rad_2_phase_q32(double rad)
 {
-  while(num>T) num -= T;
-  while(num<0) num += T;
-  return num;
-};
+  double turns = rad / (2.0*PI);
+  if (turns <= 0.0) return 0;
+  if (turns >= 1.0) return PHASE_Q32_FULL_TURN;
+  return uint64_t(llround(turns * double(PHASE_Q32_FULL_TURN)));
+}
 
 // 根据如下公式计算PWM开启 和关闭交线
 // implement k*dx = M*sin(x_ref + dx); dx = M/k*sin(x_ref + dx)
@@ -238,8 +242,13 @@ struct TimerTable
    std::vector<         float      > phase_merge_temp;
    std::vector<         float      > delt_phase_temp;
 
-   std::vector<         float      > delt_ptable_at_current_m; // 查表相位间隔
+   // 相位表只存定点间隔 (uint16，一整圈 = 2^16，即 Q32 绝对相位的高16位)，
+   // 浮点间隔只在建表时临时使用，不保存
    std::vector<         uint16_t   > delt_ctable_at_current_m; // 查表计数器间隔
+   std::vector<         uint16_t   > delt_qtable_at_current_m;  // 查表相位间隔，定点 (一整圈 = 2^16)
+   bool                               qtable_overflow = false;   // 相位间隔超出 uint16，已饱和
+   bool                               ctable_overflow = false;   // 计数器间隔超出 uint16，已饱和
+   bool                               verbose         = false;   // 打印总相位/总计数校验
    
    std::vector<         bool       > operation_value;          //中断改写值
    std::vector<         bool       > operation_direction;      //中断改写正向或负向导通
@@ -356,31 +365,33 @@ struct TimerTable
 // 得到当前调制系数 m 情况下，计时器表格 
      void get_table_at_current_m(float m) 
      {
+         std::vector<float> delt_ptable;
          for (int i = 0; i<int(ratioFrq); i++) 
          {
-           delt_ptable_at_current_m.push_back(this->linear_interp(m, uint8_t(2*i)));
-           delt_ptable_at_current_m.push_back(this->linear_interp(m, uint8_t(2*i+1)));
+           delt_ptable.push_back(this->linear_interp(m, uint8_t(2*i)));
+           delt_ptable.push_back(this->linear_interp(m, uint8_t(2*i+1)));
          }
         
-        delt_ptable_at_current_m.push_back(this->linear_interp(m, uint8_t(2*ratioFrq)));
+        delt_ptable.push_back(this->linear_interp(m, uint8_t(2*ratioFrq)));
 
         this->update_operation();
          std::cout<<"Table update for given m is done"<<std::endl;
         
-        this->get_phase_merge_current_m();
+        this->get_phase_merge_current_m(delt_ptable);
+        this->get_qtable_at_current_m(delt_ptable);
 
      }
 
 ////////////////////////////////////////////////////////
 ////////////记录phase的绝对值//////////////////////////////
-     void get_phase_merge_current_m()
+     void get_phase_merge_current_m(const std::vector<float> & delt_ptable)
      {
        phase_merge_at_mt.clear();
-       phase_merge_at_mt.push_back(delt_ptable_at_current_m[0]);
+       phase_merge_at_mt.push_back(delt_ptable[0]);
 
-     for (uint8_t i = 1; i < uint8_t(delt_ptable_at_current_m.size()); i++)
+     for (uint8_t i = 1; i < uint8_t(delt_ptable.size()); i++)
        {
-         phase_merge_at_mt.push_back(delt_ptable_at_current_m[i] + phase_merge_at_mt.back());
+         phase_merge_at_mt.push_back(delt_ptable[i] + phase_merge_at_mt.back());
        }
      }
 ////////////////////////////////////////////////////////////////////////////////
@@ -389,7 +400,7 @@ struct TimerTable
      void get_table_at_current_m2(float m) 
      {
        
-       delt_ptable_at_current_m.clear();
+       std::vector<float> delt_ptable;
        phase_merge_temp.clear();
        phase_merge_temp.push_back(0.0);
 
@@ -400,21 +411,82 @@ struct TimerTable
               float on        = pwm_on (m,  ref_phase, mp, config);
               float off       = pwm_off(m,  ref_phase, mp, config);
 
-              delt_ptable_at_current_m.push_back(on - phase_merge_temp.back());
+              delt_ptable.push_back(on - phase_merge_temp.back());
               phase_merge_temp.push_back(on);
 
-              delt_ptable_at_current_m.push_back(off -  on);
+              delt_ptable.push_back(off -  on);
               phase_merge_temp.push_back(off);
               
             }
             ////最后一个值为0，截止到(2*PI+epsilon);
             // std::cout  << "last off phase" <<  phase_merge_temp.back() <<std::endl;
-            delt_ptable_at_current_m.push_back(2*PI  - phase_merge_temp.back());
+            delt_ptable.push_back(2*PI  - phase_merge_temp.back());
             phase_merge_temp.push_back(2*PI);
             
             this->update_operation();  
+            this->get_qtable_at_current_m(delt_ptable);
 
      }  
+
+////////////////////////////////////////////////////////
+////////////浮点相位表 -> 定点相位表//////////////////////////
+     // 绝对相位先取整到 Q32 再求差，间隔之和严格等于一整圈，不会累计误差
+     // 交线重叠（负间隔）时保持单调，间隔记为 0
+     void get_qtable_at_current_m(const std::vector<float> & delt_ptable)
+     {
+       delt_qtable_at_current_m.clear();
+       qtable_overflow = false;
+
+       double   phase    = 0.0;
+       uint64_t last_q32 = 0;
+       uint32_t last_q16 = 0;
+       size_t   n        = delt_ptable.size();
+
+       for (size_t i = 0; i < n; i++)
+       {
+         phase += delt_ptable[i];
+         uint64_t q32 = (i + 1 == n) ? PHASE_Q32_FULL_TURN : rad_2_phase_q32(phase); // 最后一个间隔闭合到 2PI
+         if (q32 < last_q32) q32 = last_q32;
+
+         uint32_t q16  = uint32_t((q32 + (uint64_t(1) << (PHASE_Q16_SHIFT - 1))) >> PHASE_Q16_SHIFT);
+         uint32_t dq16 = q16 - last_q16;
+         if (dq16 > 0xFFFF) 
+         {
+           dq16 = 0xFFFF;
+           qtable_overflow = true;
+         }
+
+         delt_qtable_at_current_m.push_back(uint16_t(dq16));
+         last_q32 = q32;
+         last_q16 = q16;
+       }
+     }
+
+    // 频率缩放：定点相位表 -> 计数器表，每个边沿一次乘法+移位
+    // counts_per_turn: 一个电网周期对应的计数值，随电网频率变化而跟新
+    // 用累计相位计算绝对计数后再求差，总计数严格等于 counts_per_turn
+    void conver_qtable_2_ctable(uint32_t counts_per_turn)
+    {
+        delt_ctable_at_current_m.clear();
+        ctable_overflow = false;
+
+        uint32_t phase_q16  = 0;
+        uint32_t last_count = 0;
+        for (size_t i = 0; i < delt_qtable_at_current_m.size(); i++)
+        {
+          phase_q16 += delt_qtable_at_current_m[i];
+          uint32_t count  = uint32_t((uint64_t(phase_q16) * counts_per_turn) >> PHASE_Q16_SHIFT);
+          uint32_t counts = count - last_count;
+          last_count = count;
+
+          if (counts > 0xFFFF)
+          {
+            counts = 0xFFFF;
+            ctable_overflow = true;
+          }
+          delt_ctable_at_current_m.push_back(uint16_t(counts));
+        }
+    }
  
 
     // 转换相位差到时间
@@ -424,35 +496,35 @@ struct TimerTable
     // c-  调制频率变化
         void conver_ptable_2_ctable(float p2c_ratio)
     {
-        delt_ctable_at_current_m.clear();
-        for (int i  = 0; i<delt_ptable_at_current_m.size(); i++)
-        {
-          uint16_t counts = static_cast<uint16_t> (round( delt_ptable_at_current_m[i] * p2c_ratio));
+        uint32_t counts_per_turn = uint32_t(lround(p2c_ratio * 2.0 * PI));
+        this->conver_qtable_2_ctable(counts_per_turn);
 
-          // if (counts>1) counts--; //少计一个 （假定计数是从最高值计到0； 移植到嵌入式，适当调整
-          delt_ctable_at_current_m.push_back(counts);
-        //   this->handle_min_count(i);
+        if (!verbose && !ctable_overflow) return;
+
+        if (ctable_overflow)
+        {
+          std::cout<< "warning: counter interval exceeds uint16, saturated" <<std::endl;
         }
 
-        float total_phase = 0;
-            for (int j = 0; j<delt_ptable_at_current_m.size(); j++)
+        uint32_t total_q16 = 0;
+            for (size_t j = 0; j<delt_qtable_at_current_m.size(); j++)
             {
-              total_phase += delt_ptable_at_current_m[j];
+              total_q16 += delt_qtable_at_current_m[j];
             }
+            float total_phase = float(total_q16) * 2*PI / float(uint32_t(1) << PHASE_Q16_SHIFT);
             std::cout<< "xxxxxxxxxxxxxTotal phase is " << total_phase <<std::endl;
             std::cout<< "error percentage compared to 2pi " << (total_phase - 2*PI)/(2*PI)*100.0 <<"%"<<std::endl;
 
                     // print the total number of counts 
             int total_count = 0;
-            int count_2pi = p2c_ratio*2.0*PI;
-            for (int j = 0; j<delt_ptable_at_current_m.size(); j++)
+            for (size_t j = 0; j<delt_ctable_at_current_m.size(); j++)
             {
               total_count += delt_ctable_at_current_m[j];
             }
             std::cout<< "xxxxxxxxxxxxxTotal count is " << total_count <<std::endl;
-            std::cout<< "error counts compared to " << count_2pi
+            std::cout<< "error counts compared to " << counts_per_turn
                                                     <<", "
-                                                    << ( float (total_count)  - count_2pi) /(count_2pi)*100.0 <<"%"<<std::endl;
+                                                    << ( float (total_count)  - float(counts_per_turn)) /(counts_per_turn)*100.0 <<"%"<<std::endl;
 
     }
    
@@ -587,7 +659,7 @@ struct TimerTables
       //  if (interruption_id  < 5) 
       //  {
       //      std::cout<<"=================="<<std::endl;
-      //      std::cout<< timerTables[module_index].delt_ptable_at_current_m[interruption_id] <<std::endl;
+      //      std::cout<< timerTables[module_index].delt_qtable_at_current_m[interruption_id] <<std::endl;
       //  }
       uint16_t count = timerTables[module_index].delt_ctable_at_current_m[interruption_id];
 
@@ -692,7 +764,7 @@ struct ExternalInterruptHandle
     float m_new;
     float delta_phase;
  
-}；
+};
 
 
 int main()
@@ -1,50 +1,49 @@
+#ifndef PWM_ON_OFF_H_
+#define PWM_ON_OFF_H_
+
 #include <stdio.h>
 #include <stdint.h>
 #include <cmath>
-#include <map>
-#include <vector>
-#include <array>
-#include <cstdlib>
-#include <deque>
-#include <iostream>
-#include <assert.h>     /* assert */
-#include <fstream>
 
 #include "../pwm_io/pwm_io.h"
 #include "../../utilities/mod.h"
-#include "../../config/Config_spwm_solver.h"
+#include "../config/config_spwm_solver.h"
 
+// 计算带谐波注入的PWM开启/关闭交线
+// 参考波: sum_i m[i]*sin(order[i]*x + phase[i]), 载波斜率 k = fc/(fg*PI)
+// implement k*dx = sign * sum_i m[i]*sin(order[i]*(x_ref + dx) + phase[i])
 inline float pwm_with_harmonic
-                    (float * m,      // modulation coeff at different orders
-                     float * phase,  // phase shift at different orders
-                     float * order,  // orders
-                     const int len,    // len of array of m, phase, order
-                     bool    mode,    // 1 - pwm on, 0 pwn_off
-                     float ref_phase, // ref phase 
+                    (const float * m,      // modulation coeff at different orders
+                     const float * phase,  // phase shift at different orders
+                     const float * order,  // orders
+                     const int len,        // len of array of m, phase, order
+                     bool    mode,         // 1 - pwm on, 0 pwn_off
+                     float ref_phase,      // ref phase 
                      const ModulationParam & mp, 
                      const Config_spwm_solver & config = Config_spwm_solver()) 
 {
-    float dx_last = 0.0;
-    float dx      = 0.0;
+    float dx_last = 0.0f;
+    float dx      = 0.0f;
 
     ref_phase = mod(ref_phase, 2*PI);
     float ref_phase_lk = mod(ref_phase, PI); // 保证在[0, pi]之间
-    float sign = 1;
-    if (mode) sign = -1.0
-    else sign = 1.0;
+    float sign  = mode ? -1.0f : 1.0f;
+    float k     = mp.get_modulation_k();
     
     // 使用定点方法(fixed point iteration)迭代, 对比牛顿法，定点法在m/k小时，迭代速度快
     for(int i = 1; i < int(config.max_iter); i++) 
     {
-       float k =  mp.get_positive_k();
-       float theta = 0;
-       for(int i = 0; i<len; i++)
+       float theta = ref_phase_lk + dx;
+       float sum   = 0.0f;
+       for(int j = 0; j<len; j++)
        {
-          theta = ref_phase_lk + dx;
-          dx = sign * m[i]/k *sin(order[i] * theta + phase[i]);
+          sum += m[j] * sinf(order[j] * theta + phase[j]);
        }
-       if (abs(dx-dx_last) < config.err) break;
+       dx = sign * sum / k;
+       if (fabsf(dx-dx_last) < config.err) break;
        dx_last = dx;
     }
     return ref_phase + dx;
-};
\ No newline at end of file
+}
+
+#endif
@@ -0,0 +1,186 @@
+#ifndef PWM_ONLINE_ND_H_
+#define PWM_ONLINE_ND_H_
+#include <stdio.h>
+#include <stdint.h>
+#include <cmath>
+#include <cassert>
+#include <vector>
+#include <algorithm>
+#ifndef COMPILE_MCU_CPP
+#include <thread>
+#include <atomic>
+#endif
+#include "pwm_online_1dtable.h"
+
+#define ND_MAX_AXES 5   // m1, m3, p3, m5, p5
+
+// 表格轴对应的调制参数
+enum HarmonicAxis 
+{
+    AXIS_M1 = 0, // 基波调制系数   m[0]
+    AXIS_M3,     // 3次谐波调制系数 m[1]
+    AXIS_P3,     // 3次谐波相位    p[1]
+    AXIS_M5,     // 5次谐波调制系数 m[2]
+    AXIS_P5      // 5次谐波相位    p[2]
+};
+
+// 均匀网格的一根轴 [lower, upper], points 个点
+struct TableAxis
+{
+    HarmonicAxis target = AXIS_M1;
+    float lower  = 0.0f;
+    float upper  = 0.0f;
+    int   points = 1;
+
+    float value(int i) const
+    {
+        if (points <= 1) return lower;
+        return lower + (upper - lower) * float(i) / float(points - 1);
+    }
+};
+
+/// @brief 张量积网格上的谐波注入开关表，扁平存储
+/// table[i0][i1]...[iN-1][pnt] 存放在 table[i0*strides[0] + ... + iN-1*strides[N-1] + pnt]
+/// 第一根轴在最外层，PWM 点 (MAX_PWM_PNTS) 在最内层 (stride = 1)
+struct HarmonicTableND
+{
+    int       num_axes = 0;
+    TableAxis axes[ND_MAX_AXES];
+    size_t    strides[ND_MAX_AXES + 1];
+    float     phase_shift = 0.0f;
+
+    std::vector<float> table_on;
+    std::vector<float> table_off;
+
+    void reset()
+    {
+        num_axes = 0;
+        table_on.clear();
+        table_off.clear();
+        this->update_strides();
+    }
+
+    void add_axis(HarmonicAxis target, float lower, float upper, int points)
+    {
+        assert(num_axes < ND_MAX_AXES && points >= 1);
+        axes[num_axes].target = target;
+        axes[num_axes].lower  = lower;
+        axes[num_axes].upper  = upper;
+        axes[num_axes].points = points;
+        num_axes++;
+        this->update_strides();
+    }
+
+    void update_strides()
+    {
+        strides[num_axes] = 1;
+        size_t stride = MAX_PWM_PNTS;
+        for (int a = num_axes - 1; a >= 0; a--)
+        {
+            strides[a] = stride;
+            stride    *= size_t(axes[a].points);
+        }
+    }
+
+    // 网格点 (行) 的个数，每行为一个 1D 表
+    size_t num_rows() const
+    {
+        size_t rows = 1;
+        for (int a = 0; a < num_axes; a++) rows *= size_t(axes[a].points);
+        return rows;
+    }
+
+    size_t size() const
+    {
+        return num_rows() * MAX_PWM_PNTS;
+    }
+
+    // 多维下标 -> 行首偏移
+    size_t index(const int * idx) const
+    {
+        size_t offset = 0;
+        for (int a = 0; a < num_axes; a++) offset += size_t(idx[a]) * strides[a];
+        return offset;
+    }
+
+    const float * on_row(const int * idx) const  { return &table_on[this->index(idx)]; }
+    const float * off_row(const int * idx) const { return &table_off[this->index(idx)]; }
+
+    // 行号 -> 该网格点的调制系数和相位 (未被轴覆盖的量取 m0, p0)
+    void row_params(size_t row, const float m0[TAB_SIZE], const float p0[TAB_SIZE],
+                    float m[TAB_SIZE], float p[TAB_SIZE]) const
+    {
+        for (int i = 0; i < TAB_SIZE; i++) 
+        {
+            m[i] = m0[i];
+            p[i] = p0[i];
+        }
+
+        size_t offset = row * MAX_PWM_PNTS;
+        for (int a = 0; a < num_axes; a++)
+        {
+            int   i = int(offset / strides[a]);
+            float v = axes[a].value(i);
+            offset -= size_t(i) * strides[a];
+
+            switch (axes[a].target)
+            {
+                case AXIS_M1: m[0] = v; break;
+                case AXIS_M3: m[1] = v; break;
+                case AXIS_P3: p[1] = v; break;
+                case AXIS_M5: m[2] = v; break;
+                case AXIS_P5: p[2] = v; break;
+            }
+        }
+    }
+
+    // 生成全部网格点的开关表; num_threads = 0 时使用全部核心
+    void generate(const float m[TAB_SIZE], const float p[TAB_SIZE], float phase_shift_,
+                  const ModulationParam & md = ModulationParam(),
+                  const Config_spwm_solver & config = Config_spwm_solver(),
+                  unsigned num_threads = 0)
+    {
+        phase_shift = phase_shift_;
+        table_on.assign(this->size(), 0.0f);
+        table_off.assign(this->size(), 0.0f);
+
+        const size_t rows = this->num_rows();
+
+        auto build_row = [&](size_t row)
+        {
+            float m_row[TAB_SIZE], p_row[TAB_SIZE];
+            this->row_params(row, m, p, m_row, p_row);
+            generate_1d_table(m_row, p_row, phase_shift, 
+                              &table_on[row * MAX_PWM_PNTS], 
+                              &table_off[row * MAX_PWM_PNTS], 
+                              md, config);
+        };
+
+#ifdef COMPILE_MCU_CPP
+        (void)num_threads;
+        for (size_t row = 0; row < rows; row++) build_row(row);
+#else
+        if (num_threads == 0) num_threads = std::max(1u, std::thread::hardware_concurrency());
+        num_threads = unsigned(std::min<size_t>(num_threads, rows));
+
+        // 每个线程按块领取行，行之间互不依赖，写入位置不重叠
+        const size_t chunk = 64;
+        std::atomic<size_t> next_row(0);
+        auto worker = [&]()
+        {
+            for (size_t begin = next_row.fetch_add(chunk); begin < rows; begin = next_row.fetch_add(chunk))
+            {
+                size_t end = std::min(rows, begin + chunk);
+                for (size_t row = begin; row < end; row++) build_row(row);
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned t = 1; t < num_threads; t++) workers.emplace_back(worker);
+        worker();
+        for (auto & w : workers) w.join();
+#endif
+    }
+};
+
+#endif
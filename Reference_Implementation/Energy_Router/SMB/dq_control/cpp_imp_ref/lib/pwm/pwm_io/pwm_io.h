@@ -10,7 +10,7 @@ struct ModulationParam
   float fc    = 800.0;               // 调制频率
   float fg    = 50.0;                // 电网频率，
   
-  float get_modulation_k()
+  float get_modulation_k() const
   {
     return fc/(fg*PI);
   }
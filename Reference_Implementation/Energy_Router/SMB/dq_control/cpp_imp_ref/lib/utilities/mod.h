@@ -0,0 +1,12 @@
+#ifndef MOD_H_
+#define MOD_H_
+
+// 求余, 结果在 [0, T] 之间
+inline float mod(float num, float T) 
+{
+  while(num>T) num -= T;
+  while(num<0) num += T;
+  return num;
+}
+
+#endif
@@ -0,0 +1,51 @@
+#include <stdio.h>
+#include <chrono>
+#include <cstring>
+#include "../lib/pwm/online_table/pwm_online_6dtable.h"
+
+int main(void)
+{
+    int failures = 0;
+    const float m[TAB_SIZE] = {0.9f, 0.1f, 0.05f};
+    const float p[TAB_SIZE] = {0.0f, 0.0f, 0.0f};
+
+    // 6D 表: 5 (p5) x 5 (m5) x 5 (p3) x 5 (m3) x 11 (m1) = 6875 行
+    HarmonicTableND multi;
+    auto t0 = std::chrono::steady_clock::now();
+    generate_6d_table(m, p, 0.0f, multi);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    HarmonicTableND single;
+    generate_6d_table(m, p, 0.0f, single, ModulationParam(), Config_spwm_solver(), 1);
+
+    printf("6D table: %zu rows x %d points, %.3f s on all cores\n", multi.num_rows(), MAX_PWM_PNTS, secs);
+    if (multi.num_rows() != 6875 || multi.table_on.size() != 6875 * MAX_PWM_PNTS)
+    {
+        printf("FAIL: expected 6875 rows\n");
+        failures++;
+    }
+    if (multi.table_on != single.table_on || multi.table_off != single.table_off)
+    {
+        printf("FAIL: multi-threaded table differs from the single-threaded one\n");
+        failures++;
+    }
+    if (secs > 1.0)
+    {
+        printf("FAIL: 6D table took %.3f s\n", secs);
+        failures++;
+    }
+
+    // 每一行等于直接调用 generate_1d_table 的结果
+    int idx[ND_MAX_AXES] = {4, 0, 2, 3, 10};   // p5, m5, p3, m3, m1
+    float m_row[TAB_SIZE], p_row[TAB_SIZE], on[MAX_PWM_PNTS], off[MAX_PWM_PNTS];
+    multi.row_params(multi.index(idx) / MAX_PWM_PNTS, m, p, m_row, p_row);
+    generate_1d_table(m_row, p_row, 0.0f, on, off);
+    if (memcmp(on, multi.on_row(idx), sizeof(on)) != 0 || memcmp(off, multi.off_row(idx), sizeof(off)) != 0)
+    {
+        printf("FAIL: row (%d, %d, %d, %d, %d) differs from generate_1d_table\n", idx[0], idx[1], idx[2], idx[3], idx[4]);
+        failures++;
+    }
+
+    printf("%s (%d failures)\n", failures ? "FAILED" : "PASSED", failures);
+    return failures ? 1 : 0;
+}